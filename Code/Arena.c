@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Arena.h"
+
+// Block headers are padded so that the first allocation is aligned as well
+#define ARENA_HEADER ((sizeof(ArenaBlock) + CP_ARENA_ALIGNMENT - 1) & ~(size_t)(CP_ARENA_ALIGNMENT - 1))
+
+static ArenaBlock* newBlock(ArenaBlock* previous, const size_t size)
+{
+    ArenaBlock* block = (ArenaBlock*) malloc(ARENA_HEADER + size);
+    if (block == NULL)
+        return NULL;
+    block->previous = previous;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+int arenaInit(Arena* arena, const size_t bytes)
+{
+    arena->blockSize = (bytes > 4096) ? bytes : 4096;
+    arena->inUse = arena->peak = 0;
+    arena->current = newBlock(NULL, arena->blockSize);
+    if (arena->current == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    return 0;
+}
+
+void* arenaAlloc(Arena* arena, const size_t bytes)
+{
+    size_t size = (bytes + CP_ARENA_ALIGNMENT - 1) & ~(size_t)(CP_ARENA_ALIGNMENT - 1);
+    ArenaBlock* block = arena->current;
+    if (block == NULL || block->size - block->used < size) {
+        block = newBlock(block, (size > arena->blockSize) ? size : arena->blockSize);
+        if (block == NULL)
+            return NULL;
+        arena->current = block;
+    }
+    void* memory = (unsigned char*) block + ARENA_HEADER + block->used;
+    block->used += size;
+    arena->inUse += size;
+    if (arena->inUse > arena->peak)
+        arena->peak = arena->inUse;
+    return memory;
+}
+
+ArenaMark arenaMark(const Arena* arena)
+{
+    ArenaMark mark;
+    mark.block = arena->current;
+    mark.used = arena->current ? arena->current->used : 0;
+    mark.inUse = arena->inUse;
+    return mark;
+}
+
+void arenaReset(Arena* arena, const ArenaMark mark)
+{
+    while (arena->current != NULL && arena->current != mark.block) {
+        ArenaBlock* previous = arena->current->previous;
+        free(arena->current);
+        arena->current = previous;
+    }
+    if (arena->current != NULL)
+        arena->current->used = mark.used;
+    arena->inUse = mark.inUse;
+}
+
+void arenaFree(Arena* arena)
+{
+    ArenaMark empty = {NULL, 0, 0};
+    arenaReset(arena, empty);
+}
@@ -0,0 +1,40 @@
+#ifndef Arena_h
+
+#define Arena_h
+#include <stddef.h>
+
+// Bump allocator for per-solve scratch memory.
+// The first block is sized up front by the caller; allocations that do not fit chain
+// another block instead of failing. arenaMark/arenaReset release everything allocated
+// after the mark at once, so recursive solvers reuse the same bytes at every level.
+// An Arena is not shared between threads: each thread (or rank) owns its own.
+#define CP_ARENA_ALIGNMENT 16
+
+// Definition Data Types
+typedef struct ArenaBlock {
+    struct ArenaBlock* previous;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock* current;
+    size_t blockSize;   // Size of any chained block, at least
+    size_t inUse;       // Bytes handed out and not reset
+    size_t peak;        // Largest inUse so far
+} Arena;
+
+typedef struct {
+    ArenaBlock* block;
+    size_t used;
+    size_t inUse;
+} ArenaMark;
+
+// Definition
+int arenaInit(Arena* arena, const size_t bytes);
+void* arenaAlloc(Arena* arena, const size_t bytes);
+ArenaMark arenaMark(const Arena* arena);
+void arenaReset(Arena* arena, const ArenaMark mark);
+void arenaFree(Arena* arena);
+
+#endif
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""Reproducible benchmark harness for the closest pair solvers.
+
+Generates seeded corpora with GeneratePoints, runs CP-BF-Seq, CP-DAC-Seq,
+CP-BF-MPI and CP-DAC-MPI over them with repeated trials, and reports the
+median solve time with a bootstrap confidence interval. The solve time is the
+"Elapsed Time" every CP-* binary writes to its result file. CP-DAC-Seq, and
+the MPI solvers when rank 0 has worker threads, sort by X while reading the
+file; that phase is their "Read and Sort Time", kept as load_median and
+compared against the baseline like the solve time. Reports carry a format
+version: baselines of another format (saved before the loader took over the
+sort, when the solve time included it) are refused; save a new one.
+
+Examples:
+    ./Benchmark.py                                  # 10^3..10^6, uniform
+    ./Benchmark.py --min-exp 3 --max-exp 9 --distributions uniform,clustered
+    ./Benchmark.py --scaling strong --ranks 1,2,4,8 --scaling-exp 6
+    ./Benchmark.py --save-baseline bench/baseline.json
+    ./Benchmark.py --baseline bench/baseline.json --threshold 0.10
+    ./Benchmark.py --profile                        # per-phase counters in the JSON report
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import shlex
+import statistics
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOLVERS = ["CP-BF-Seq", "CP-DAC-Seq", "CP-BF-MPI", "CP-DAC-MPI"]
+DISTANCE_RE = re.compile(r"The closest pair distance is\s+(\S+)")
+ELAPSED_RE = re.compile(r"Elapsed Time:\s+(\S+)")
+LOAD_RE = re.compile(r"Read and Sort Time:\s+(\S+)")
+PROFILE_RE = re.compile(r"^Profile:\s+(.*)$", re.MULTILINE)
+# Bumped whenever the timed phases change and older reports stop being comparable
+REPORT_FORMAT = 2
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bin-dir", default=os.path.join(HERE, "..", "build", "release", "bin"), help="Directory holding the CP-* and GeneratePoints binaries")
+    parser.add_argument("--work-dir", default=os.path.join(HERE, "bench"), help="Directory for corpora, result files and reports")
+    parser.add_argument("--solvers", default=",".join(SOLVERS), help="Comma separated list of solvers to run")
+    parser.add_argument("--distributions", default="uniform", help="Comma separated GeneratePoints distributions")
+    parser.add_argument("--min-exp", type=int, default=3, help="Smallest corpus is 10^min-exp points")
+    parser.add_argument("--max-exp", type=int, default=6, help="Largest corpus is 10^max-exp points (up to 9)")
+    parser.add_argument("--bf-max-exp", type=int, default=4, help="Brute-force solvers are skipped above 10^bf-max-exp points")
+    parser.add_argument("--seed", type=int, default=12345, help="Seed passed to GeneratePoints")
+    parser.add_argument("--trials", type=int, default=5, help="Repetitions per configuration")
+    parser.add_argument("--confidence", type=float, default=0.95, help="Confidence level of the median interval")
+    parser.add_argument("--np", type=int, default=4, help="Rank count for the MPI solvers outside the scaling sweeps")
+    parser.add_argument("--mpirun", default="mpirun --oversubscribe", help="Launcher prefix for the MPI solvers")
+    parser.add_argument("--scaling", choices=["none", "strong", "weak", "both"], default="none", help="Run rank-count sweeps")
+    parser.add_argument("--ranks", default="1,2,4,8", help="Rank counts for the scaling sweeps")
+    parser.add_argument("--scaling-exp", type=int, default=6, help="Strong scaling size, and weak scaling size per rank, is 10^scaling-exp")
+    parser.add_argument("--timeout", type=float, default=3600.0, help="Seconds before a single run is abandoned")
+    parser.add_argument("--output", default=None, help="JSON report path (default: work-dir/results.json)")
+    parser.add_argument("--baseline", default=None, help="Compare against this JSON report and fail on regressions; reports of another format are refused")
+    parser.add_argument("--threshold", type=float, default=0.10, help="Allowed relative slowdown of a median against the baseline")
+    parser.add_argument("--profile", action="store_true", help="Run the solvers with --profile and keep their per-phase counters")
+    parser.add_argument("--save-baseline", default=None, help="Also write the report to this path as the new baseline")
+    return parser.parse_args()
+
+
+def mpi_env():
+    env = dict(os.environ)
+    if hasattr(os, "geteuid") and os.geteuid() == 0:
+        env.setdefault("OMPI_ALLOW_RUN_AS_ROOT", "1")
+        env.setdefault("OMPI_ALLOW_RUN_AS_ROOT_CONFIRM", "1")
+    return env
+
+
+def generate_corpus(args, distribution, num_points):
+    corpus_dir = os.path.join(args.work_dir, "corpus")
+    os.makedirs(corpus_dir, exist_ok=True)
+    path = os.path.join(corpus_dir, "%s-n%d-s%d.dat" % (distribution, num_points, args.seed))
+    if not os.path.exists(path):
+        cmd = [os.path.join(args.bin_dir, "GeneratePoints"), path, str(num_points),
+               "0", "1", "0", "1", "2", str(args.seed), distribution]
+        subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    return path
+
+
+def run_solver(args, solver, corpus, ranks):
+    result = os.path.join(args.work_dir, "result-%s-%d.dat" % (solver, os.getpid()))
+    cmd = [os.path.join(args.bin_dir, solver), corpus, result] + (["--profile"] if args.profile else [])
+    if solver.endswith("MPI"):
+        cmd = shlex.split(args.mpirun) + ["-np", str(ranks)] + cmd
+    wall = time.perf_counter()
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL, env=mpi_env(), timeout=args.timeout)
+    wall = time.perf_counter() - wall
+    with open(result) as fp:
+        text = fp.read()
+    os.remove(result)
+    load = LOAD_RE.search(text)
+    return (float(ELAPSED_RE.search(text).group(1)), float(load.group(1)) if load else None, wall,
+            float(DISTANCE_RE.search(text).group(1)), parse_profile(text))
+
+
+def parse_profile(text):
+    # "Profile: rank=0 phase=solve seconds=... ipc=n/a ..." lines, one per phase and rank
+    phases = []
+    for line in PROFILE_RE.findall(text):
+        phase = {}
+        for field in line.split():
+            key, _, value = field.partition("=")
+            if value == "n/a":
+                phase[key] = None
+            elif key == "phase":
+                phase[key] = value
+            else:
+                phase[key] = float(value) if "." in value else int(value)
+        phases.append(phase)
+    return phases
+
+
+def median_interval(samples, confidence, seed):
+    # Percentile bootstrap of the median, seeded so that reports are stable
+    rng = random.Random(seed)
+    medians = sorted(statistics.median(rng.choices(samples, k=len(samples))) for _ in range(2000))
+    lo = medians[int((1.0 - confidence) / 2.0 * (len(medians) - 1))]
+    hi = medians[int((1.0 + confidence) / 2.0 * (len(medians) - 1))]
+    return lo, hi
+
+
+def measure(args, solver, distribution, num_points, ranks, sweep):
+    corpus = generate_corpus(args, distribution, num_points)
+    solve, load, wall, distances, profiles = [], [], [], set(), []
+    for _ in range(args.trials):
+        t_solve, t_load, t_wall, distance, profile = run_solver(args, solver, corpus, ranks)
+        profiles.append(profile)
+        solve.append(t_solve)
+        if t_load is not None:
+            load.append(t_load)
+        wall.append(t_wall)
+        distances.add(distance)
+    if len(distances) > 1:
+        # A solver that answers differently on the same corpus is broken, not slow
+        sys.exit("%s on %s n=%d np=%d returned different distances across trials: %s"
+                 % (solver, distribution, num_points, ranks, ", ".join("%.17g" % d for d in sorted(distances))))
+    lo, hi = median_interval(solve, args.confidence, args.seed)
+    entry = {
+        "solver": solver, "distribution": distribution, "num_points": num_points,
+        "ranks": ranks, "sweep": sweep, "trials": args.trials,
+        "median": statistics.median(solve), "ci_low": lo, "ci_high": hi,
+        "wall_median": statistics.median(wall), "samples": solve,
+        "distance": distances.pop(),
+    }
+    if load:
+        entry["load_median"] = statistics.median(load)
+    if args.profile:
+        entry["profiles"] = profiles
+    print("%-11s %-10s n=%-10d np=%-3d %-6s median %12.6f s  [%10.6f, %10.6f]  wall %10.6f s  d=%.10f"
+          % (solver, distribution, num_points, ranks, sweep, entry["median"], lo, hi, entry["wall_median"], entry["distance"]))
+    sys.stdout.flush()
+    return entry
+
+
+def entry_key(entry):
+    return "%s/%s/%d/%d/%s" % (entry["solver"], entry["distribution"], entry["num_points"], entry["ranks"], entry["sweep"])
+
+
+def load_baseline(baseline_path):
+    # Entries by key, or None for a report of another format
+    with open(baseline_path) as fp:
+        report = json.load(fp)
+    if report.get("format") != REPORT_FORMAT:
+        print("%s is a report of format %s, this harness writes format %d: save a new baseline"
+              % (baseline_path, report.get("format", "1"), REPORT_FORMAT))
+        return None
+    return {entry_key(e): e for e in report["results"]}
+
+
+def compare_to_baseline(entries, baseline, threshold):
+    regressions = 0
+    for entry in entries:
+        base = baseline.get(entry_key(entry))
+        if base is None:
+            continue
+        # The solve time, and the read and sort phase of the solvers that report one
+        for field, label in (("median", "solve"), ("load_median", "read and sort")):
+            if field not in entry or field not in base:
+                continue
+            ratio = entry[field] / base[field] if base[field] > 0 else 1.0
+            if ratio > 1.0 + threshold:
+                regressions += 1
+                print("REGRESSION %s %s: %.6f s vs baseline %.6f s (%+.1f%%)"
+                      % (entry_key(entry), label, entry[field], base[field], 100.0 * (ratio - 1.0)))
+    return regressions
+
+
+def main():
+    args = parse_args()
+    os.makedirs(args.work_dir, exist_ok=True)
+    # Refused before any run rather than after
+    baseline = load_baseline(args.baseline) if args.baseline else None
+    if args.baseline and baseline is None:
+        return 1
+    solvers = [s for s in args.solvers.split(",") if s]
+    distributions = [d for d in args.distributions.split(",") if d]
+    ranks = [int(r) for r in args.ranks.split(",") if r]
+    entries = []
+
+    for distribution in distributions:
+        for exp in range(args.min_exp, args.max_exp + 1):
+            for solver in solvers:
+                if solver.startswith("CP-BF") and exp > args.bf_max_exp:
+                    continue
+                np = args.np if solver.endswith("MPI") else 1
+                entries.append(measure(args, solver, distribution, 10 ** exp, np, "size"))
+
+    mpi_solvers = [s for s in solvers if s.endswith("MPI")]
+    for distribution in distributions:
+        for solver in mpi_solvers:
+            if solver.startswith("CP-BF") and args.scaling_exp > args.bf_max_exp:
+                continue
+            for r in ranks:
+                if args.scaling in ("strong", "both"):
+                    entries.append(measure(args, solver, distribution, 10 ** args.scaling_exp, r, "strong"))
+                if args.scaling in ("weak", "both"):
+                    entries.append(measure(args, solver, distribution, r * 10 ** args.scaling_exp, r, "weak"))
+
+    report = {"format": REPORT_FORMAT, "seed": args.seed, "trials": args.trials, "confidence": args.confidence, "results": entries}
+    output = args.output or os.path.join(args.work_dir, "results.json")
+    for path in filter(None, [output, args.save_baseline]):
+        with open(path, "w") as fp:
+            json.dump(report, fp, indent=2)
+        print("Report written to %s" % path)
+
+    if args.baseline:
+        regressions = compare_to_baseline(entries, baseline, args.threshold)
+        if regressions:
+            print("%d median(s) slowed down by more than %.0f%%" % (regressions, 100.0 * args.threshold))
+            return 1
+        print("No regressions against %s" % args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
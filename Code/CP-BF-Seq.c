@@ -1,18 +1,37 @@
 #include "ClosestPairUtilities.h"
+#include "ClosestPairInteger.h"
+#include "ClosestPairFloat.h"
+#include "ClosestPairND.h"
+#include "ClosestPairBichromatic.h"
+#include "ClosestPairBatch.h"
+#include "ClosestPairPruned.h"
+#include "ClosestPairRadius.h"
+#include "DriverOptions.h"
 
 int main(int argc, char* argv[]) {
     // Argument Management
-    if (argc != 3) {
+    DriverOptions options;
+    if (parseDriverOptions(argc, argv, &options, CP_OPTION_EXACT | CP_OPTION_FLOAT | CP_OPTION_PLACEMENT | CP_OPTION_BLUE | CP_OPTION_PROFILE |
+                                               CP_OPTION_BATCH | CP_OPTION_THRESHOLD | CP_OPTION_RADIUS) || options.sampleFilePath == NULL) {
         printf("Definition:\n\tThis Function Solves the Closest Point Problem (Brute-Force)\n");
-        printf("Usage:\n\tCP-BF-Seq sampleFilePath resultFilePath\n");
+        printf("Usage:\n\tCP-BF-Seq sampleFilePath resultFilePath [options]\n");
         printf("Arguments:\n");
         printf("\t- sampleFilePath: Path to the file containing sample points\n");
         printf("\t- resultFilePath: Path to the file containing results\n");
+        printDriverOptions();
         return 0;
     }
 
-    const char* sampleFilePath = argv[1];
-    const char* resultFilePath = argv[2];
+    // Counters of the phases below, with --profile
+    profileInit(options.profile);
+
+    // NUMA placement and pinning, before any point array is allocated
+    NumaCounters numaBefore;
+    if (applyPlacementOptions(&options, 0, 1, &numaBefore))
+        return -1;
+
+    const char* sampleFilePath = options.sampleFilePath;
+    const char* resultFilePath = options.resultFilePath;
     size_t numPoints; // Number of points
     double minX, maxX; // X domain limits
     double minY, maxY; // Y domain limits
@@ -21,29 +40,237 @@ int main(int argc, char* argv[]) {
     size_t index1, index2;
     double minDistance;
 
-    clock_t start, end;
+    clock_t start = 0, end = 0;
+    double batchStart, batchTime = 0.0; // Batches run on all threads: wall clock
     double cpu_time_used;
 
     // Read the points from file
     Point *points = NULL;
-    printf("Reading the points...\n");
-    int errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+    double *coords = NULL;
+    char exactSquared[48] = "";
+    double *distances = NULL;
+    size_t numInstances = 0;
+    PairWriter pairs;
+    int errcode = options.batch ? 0 : readPointsHeader(sampleFilePath, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
     if (errcode) {
         printf("Read Points From File Failed with Error Code %d!\n", errcode);
         return -1;
     }
-    printf("File read successfully!\n");
+    if (options.batch) {
+        // Batch Mode: every instance by brute force, on all threads
+        BatchIndex batch;
+        if (options.exact || options.singlePrecision || options.blueFilePath || options.threshold > 0.0 || options.radius > 0.0) {
+            fprintf(stderr, "--batch does not combine with --exact, --float, --blue, --threshold or --radius.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the instances...\n");
+        errcode = readPointBatch(sampleFilePath, &batch, &points);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        numInstances = batch.numInstances;
+        numPoints = batch.numPoints;
+        printf("File read successfully, %lu instances of %lu points in total!\n", numInstances, numPoints);
+        distances = (double*) malloc((numInstances + 1) * sizeof(double));
+        if (distances == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            freeBatchIndex(&batch);
+            free(points);
+            return -1;
+        }
 
-    printf("Solving Closest Point Problem [Brute-Force]...\n");
-    start = clock();
-    if (closestPairBruteForce(points, numPoints, &minDistance) != 0) {
-        fprintf(stderr, "Failed to find the closest pair.\n");
-        free(points);
-        return -1;
+        printf("Solving Closest Point Problem [Brute-Force, Batch]...\n");
+        profileBegin("solve");
+        batchStart = wallSeconds();
+        errcode = closestPairBatch(points, batch.offsets, numInstances, SIZE_MAX, distances);
+        freeBatchIndex(&batch);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pairs.\n");
+            free(distances);
+            free(points);
+            return -1;
+        }
+        batchTime = wallSeconds() - batchStart;
+        profileEnd();
+        minDistance = minBatchDistance(distances, numInstances);
+    }
+    else if (dimension != 2) {
+        // d-dimensional points, solved with the kernel specialized for the dimension
+        if (options.exact || options.singlePrecision || options.blueFilePath || options.threshold > 0.0 || options.radius > 0.0) {
+            fprintf(stderr, "--exact, --float, --blue, --threshold and --radius support 2-dimensional points only.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFileND(sampleFilePath, &coords, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Brute-Force, %dD]...\n", dimension);
+        profileBegin("solve");
+        start = clock();
+        if (closestPairBruteForceND(coords, numPoints, dimension, &minDistance) != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(coords);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.blueFilePath != NULL) {
+        // Red-Blue Mode: every red point against every blue point
+        Point *bluePoints = NULL;
+        size_t numBlue;
+        if (options.exact || options.singlePrecision || options.threshold > 0.0 || options.radius > 0.0) {
+            fprintf(stderr, "--blue does not combine with --exact, --float, --threshold or --radius.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode == 0)
+            errcode = readPointsFromFile(options.blueFilePath, &bluePoints, &numBlue, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            free(points);
+            return -1;
+        }
+        printf("Files read successfully, %lu red and %lu blue points!\n", numPoints, numBlue);
+
+        printf("Solving Closest Point Problem [Brute-Force, Red-Blue]...\n");
+        profileBegin("solve");
+        start = clock();
+        errcode = closestPairBichromaticBruteForce(points, numPoints, bluePoints, numBlue, &minDistance);
+        free(bluePoints);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.radius > 0.0) {
+        // Radius Mode: every pair tested, the ones closer than radius streamed to the file
+        if (options.exact || options.singlePrecision || options.threshold > 0.0) {
+            fprintf(stderr, "--radius does not combine with --exact, --float or --threshold.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Brute-Force, Radius]...\n");
+        profileBegin("solve");
+        start = clock();
+        errcode = openPairWriter(&pairs, options.pairsFilePath, options.radius);
+        if (errcode == 0)
+            errcode = radiusPairsBruteForce(points, numPoints, options.radius, &pairs);
+        if (closePairWriter(&pairs) != 0 || errcode != 0) {
+            fprintf(stderr, "Failed to find the pairs.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.threshold > 0.0) {
+        // Threshold Mode: sorted by X and pruned, stopping at the first pair closer than the threshold
+        if (options.exact || options.singlePrecision) {
+            fprintf(stderr, "--threshold does not combine with --exact or --float.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading and sorting the points...\n");
+        errcode = readPointsFromFileSortedX(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Brute-Force, Threshold]...\n");
+        profileBegin("solve");
+        start = clock();
+        errcode = closestPairBruteForcePruned(points, numPoints, options.threshold, &minDistance);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.exact) {
+        // Exact Mode: integer coordinates, squared distances never rounded
+        PointI64 *exactPoints = NULL;
+        DistanceI64 minSquared;
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFileInteger(sampleFilePath, &exactPoints, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Brute-Force, Exact]...\n");
+        profileBegin("solve");
+        start = clock();
+        if (closestPairExact(exactPoints, numPoints, 0, &minSquared) != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(exactPoints);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+        minDistance = (numPoints < 2) ? DBL_MAX : sqrt((double)minSquared);
+        formatSquaredDistance(minSquared, exactSquared, sizeof(exactSquared));
+        free(exactPoints);
+    }
+    else {
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Brute-Force%s]...\n", options.singlePrecision ? ", Single Precision" : "");
+        profileBegin("solve");
+        start = clock();
+        errcode = options.singlePrecision ? closestPairBruteForceFloat(points, numPoints, &minDistance) : closestPairBruteForce(points, numPoints, &minDistance);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
     }
-    end = clock();
-    cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
-    printf("The closest pair distance is %15.10lf\n", minDistance);
+    cpu_time_used = options.batch ? batchTime : ((double) (end - start)) / CLOCKS_PER_SEC;
+    if (options.radius > 0.0)
+        printRadiusResult(stdout, pairs.numPairs, pairs.checksum, options.radius);
+    else
+        printf("The closest pair distance is %15.10lf\n", minDistance);
+    if (options.exact)
+        printf("The exact squared distance is %s\n", exactSquared);
+    if (options.batch)
+        printf("Solved %lu instances\n", numInstances);
+    if (options.threshold > 0.0)
+        printThresholdResult(stdout, minDistance, options.threshold);
     printf("Solution Completed in %15.10lf seconds!\n", cpu_time_used);
 
     // Open file to write the results
@@ -52,6 +279,8 @@ int main(int argc, char* argv[]) {
     if (fp == NULL) {
         fprintf(stderr, "Failed to open result file.\n");
         free(points);
+        free(coords);
+        free(distances);
         return -1;
     }
     // fprintf(fp, "The closest pair is between points at indices %ld and %ld:\n", index1, index2);
@@ -59,13 +288,28 @@ int main(int argc, char* argv[]) {
     // fprintf(fp, "Point-B %ld (X:%15.10f, Y:%15.10f)\n", index2, points[index2].x, points[index2].y);
     // fprintf(fp, "Distance: %.10f\n", minDistance);
     
-    fprintf(fp, "The closest pair distance is %15.10lf\n", minDistance);
+    if (options.radius > 0.0)
+        printRadiusResult(fp, pairs.numPairs, pairs.checksum, options.radius);
+    else
+        fprintf(fp, "The closest pair distance is %15.10lf\n", minDistance);
+    if (options.exact)
+        fprintf(fp, "The exact squared distance is %s\n", exactSquared);
+    if (options.batch)
+        printBatchResults(fp, distances, numInstances);
+    if (options.threshold > 0.0)
+        printThresholdResult(fp, minDistance, options.threshold);
     fprintf(fp, "Elapsed Time: %15.10lf seconds\n", cpu_time_used);
+    profilePrintAll(fp);
 
     fclose(fp);
     printf("Results written to %s\n", resultFilePath);
 
     free(points); // Clean up allocated memory
+    free(coords);
+    free(distances);
+    reportPlacement(&options, &numaBefore);
+    profilePrintAll(stdout);
+    profileClose();
     printf("Done!\n");  
     return 0;
 }
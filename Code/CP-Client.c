@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Minimal CP-Service client: sends every request, then prints every response
+int main(int argc, char* argv[]) {
+    // Argument Management
+    if (argc < 2) {
+        printf("Definition:\n\tThis Function Sends Requests to CP-Service\n");
+        printf("Usage:\n\tCP-Client socketPath [request ...]\n");
+        printf("Arguments:\n");
+        printf("\t- socketPath: Path of the CP-Service socket\n");
+        printf("\t- request: One request per argument, e.g. \"CLOSEST points.dat\" (default: one per line on stdin)\n");
+        return 0;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long.\n");
+        return -1;
+    }
+    strcpy(address.sun_path, argv[1]);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        perror("Failed to connect to CP-Service");
+        return -1;
+    }
+
+    // All requests go out before any response is read, the service answers them as one batch
+    FILE* stream = fdopen(fd, "r+");
+    int i;
+    char line[4096];
+    if (argc > 2) {
+        for (i = 2; i < argc; i++)
+            fprintf(stream, "%s\n", argv[i]);
+    } else {
+        while (fgets(line, sizeof(line), stdin) != NULL)
+            fputs(line, stream);
+    }
+    fflush(stream);
+    shutdown(fd, SHUT_WR);
+
+    int c;
+    while ((c = fgetc(stream)) != EOF)
+        putchar(c);
+    fclose(stream);
+    return 0;
+}
@@ -1,18 +1,45 @@
 #include "ClosestPairUtilities.h"
+#include "ClosestPairInteger.h"
+#include "ClosestPairFloat.h"
+#include "ClosestPairND.h"
+#include "ClosestPairBichromatic.h"
+#include "ClosestPairBatch.h"
+#include "ClosestPairApprox.h"
+#include "ClosestPairRadius.h"
+#include "DriverOptions.h"
+#include "Calibration.h"
 
 int main(int argc, char* argv[]) {
     // Argument Management
-    if (argc != 3) {
+    DriverOptions options;
+    if (parseDriverOptions(argc, argv, &options, CP_OPTION_EXACT | CP_OPTION_FLOAT | CP_OPTION_CALIBRATE | CP_OPTION_PLACEMENT | CP_OPTION_BLUE |
+                                               CP_OPTION_PROFILE | CP_OPTION_BATCH | CP_OPTION_APPROX | CP_OPTION_RADIUS) ||
+        (options.sampleFilePath == NULL && !options.calibrate)) {
         printf("Definition:\n\tThis Function Solves the Closest Point Problem (Divide and Conquere)\n");
-        printf("Usage:\n\tCP-DAC-Seq sampleFilePath resultFilePath\n");
+        printf("Usage:\n\tCP-DAC-Seq sampleFilePath resultFilePath [options]\n");
         printf("Arguments:\n");
         printf("\t- sampleFilePath: Path to the file containing sample points\n");
         printf("\t- resultFilePath: Path to the file containing results\n");
+        printDriverOptions();
         return 0;
     }
 
-    const char* sampleFilePath = argv[1];
-    const char* resultFilePath = argv[2];
+    // Counters of the phases below, with --profile
+    profileInit(options.profile);
+
+    // NUMA placement and pinning, before any point array is allocated
+    NumaCounters numaBefore;
+    if (applyPlacementOptions(&options, 0, 1, &numaBefore))
+        return -1;
+
+    // Leaf size of the recursion: stored for this machine, or measured now
+    if (configureLeafSize(options.calibrate))
+        return -1;
+    if (options.sampleFilePath == NULL)
+        return 0;
+
+    const char* sampleFilePath = options.sampleFilePath;
+    const char* resultFilePath = options.resultFilePath;
     size_t numPoints; // Number of points
     double minX, maxX; // X domain limits
     double minY, maxY; // Y domain limits
@@ -20,29 +47,249 @@ int main(int argc, char* argv[]) {
 
     double minDistance;
 
-    clock_t start, end;
+    clock_t start = 0, end = 0;
+    double batchStart, batchTime = 0.0; // Batches run on all threads: wall clock
+    double loadStart;
     double cpu_time_used;
+    double load_time_used = -1.0; // Read and X sort of the pipelined loader (wall clock), reported apart from the solve
 
     // Read the points from file
     Point *points = NULL;
-    printf("Reading the points...\n");
-    int errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+    double *coords = NULL;
+    char exactSquared[48] = "";
+    double *distances = NULL;
+    size_t numInstances = 0;
+    PairWriter pairs;
+    double lowerBound = 0.0;
+    int errcode = options.batch ? 0 : readPointsHeader(sampleFilePath, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
     if (errcode) {
         printf("Read Points From File Failed with Error Code %d!\n", errcode);
         return -1;
     }
-    printf("File read successfully!\n");
+    if (options.batch) {
+        // Batch Mode: brute force or DAC per instance, by its size, on all threads
+        BatchIndex batch;
+        if (options.exact || options.singlePrecision || options.blueFilePath || options.approx || options.radius > 0.0) {
+            fprintf(stderr, "--batch does not combine with --exact, --float, --blue, --approx or --radius.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the instances...\n");
+        errcode = readPointBatch(sampleFilePath, &batch, &points);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        numInstances = batch.numInstances;
+        numPoints = batch.numPoints;
+        printf("File read successfully, %lu instances of %lu points in total!\n", numInstances, numPoints);
+        distances = (double*) malloc((numInstances + 1) * sizeof(double));
+        if (distances == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            freeBatchIndex(&batch);
+            free(points);
+            return -1;
+        }
 
-    printf("Solving Closest Point Problem [Divide and Conquere]...\n");
-    start = clock();
-    if (closestPairDAC(points, numPoints, &minDistance) != 0) {
-        fprintf(stderr, "Failed to find the closest pair.\n");
-        free(points);
-        return -1;
+        printf("Solving Closest Point Problem [Divide and Conquere, Batch]...\n");
+        profileBegin("solve");
+        batchStart = wallSeconds();
+        errcode = closestPairBatch(points, batch.offsets, numInstances, CP_BATCH_BRUTE_FORCE_MAX, distances);
+        freeBatchIndex(&batch);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pairs.\n");
+            free(distances);
+            free(points);
+            return -1;
+        }
+        batchTime = wallSeconds() - batchStart;
+        profileEnd();
+        minDistance = minBatchDistance(distances, numInstances);
+    }
+    else if (dimension != 2) {
+        // d-dimensional points, solved with the kernel specialized for the dimension
+        if (options.exact || options.singlePrecision || options.blueFilePath || options.approx || options.radius > 0.0) {
+            fprintf(stderr, "--exact, --float, --blue, --approx and --radius support 2-dimensional points only.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFileND(sampleFilePath, &coords, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Divide and Conquere, %dD]...\n", dimension);
+        profileBegin("solve");
+        start = clock();
+        if (closestPairDACND(coords, numPoints, dimension, &minDistance) != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(coords);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.blueFilePath != NULL) {
+        // Red-Blue Mode: both sets sorted by X inside the loader
+        Point *bluePoints = NULL;
+        size_t numBlue;
+        if (options.exact || options.singlePrecision || options.approx || options.radius > 0.0) {
+            fprintf(stderr, "--blue does not combine with --exact, --float, --approx or --radius.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading and sorting the points...\n");
+        loadStart = wallSeconds();
+        errcode = readPointsFromFileSortedX(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode == 0)
+            errcode = readPointsFromFileSortedX(options.blueFilePath, &bluePoints, &numBlue, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            free(points);
+            return -1;
+        }
+        load_time_used = wallSeconds() - loadStart;
+        printf("Files read successfully, %lu red and %lu blue points!\n", numPoints, numBlue);
+
+        printf("Solving Closest Point Problem [Divide and Conquere, Red-Blue]...\n");
+        profileBegin("solve");
+        start = clock();
+        errcode = closestPairBichromaticSorted(points, numPoints, bluePoints, numBlue, &minDistance);
+        free(bluePoints);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.radius > 0.0) {
+        // Radius Mode: columns of the X order and rows of height radius, pairs streamed to the file
+        if (options.exact || options.singlePrecision || options.approx) {
+            fprintf(stderr, "--radius does not combine with --exact, --float or --approx.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading and sorting the points...\n");
+        loadStart = wallSeconds();
+        errcode = readPointsFromFileSortedX(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        load_time_used = wallSeconds() - loadStart;
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Divide and Conquere, Radius]...\n");
+        profileBegin("solve");
+        start = clock();
+        errcode = openPairWriter(&pairs, options.pairsFilePath, options.radius);
+        if (errcode == 0)
+            errcode = radiusPairsSorted(points, numPoints, options.radius, &pairs);
+        if (closePairWriter(&pairs) != 0 || errcode != 0) {
+            fprintf(stderr, "Failed to find the pairs.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.approx) {
+        // Approximate Mode: grid over the unsorted points, distance certified within 1 + epsilon
+        if (options.exact || options.singlePrecision) {
+            fprintf(stderr, "--approx does not combine with --exact or --float.\n");
+            return -1;
+        }
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Divide and Conquere, Approximate]...\n");
+        profileBegin("solve");
+        start = clock();
+        errcode = closestPairApprox(points, numPoints, options.epsilon, &minDistance, &lowerBound);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+    }
+    else if (options.exact) {
+        // Exact Mode: integer coordinates, squared distances never rounded
+        PointI64 *exactPoints = NULL;
+        DistanceI64 minSquared;
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFileInteger(sampleFilePath, &exactPoints, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Divide and Conquere, Exact]...\n");
+        profileBegin("solve");
+        start = clock();
+        if (closestPairExact(exactPoints, numPoints, 1, &minSquared) != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(exactPoints);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
+        minDistance = (numPoints < 2) ? DBL_MAX : sqrt((double)minSquared);
+        formatSquaredDistance(minSquared, exactSquared, sizeof(exactSquared));
+        free(exactPoints);
+    }
+    else {
+        // The X sort runs inside the loader, overlapped with the read
+        profileBegin("read");
+        printf("Reading and sorting the points...\n");
+        loadStart = wallSeconds();
+        errcode = readPointsFromFileSortedX(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        load_time_used = wallSeconds() - loadStart;
+        printf("File read successfully!\n");
+
+        printf("Solving Closest Point Problem [Divide and Conquere%s]...\n", options.singlePrecision ? ", Single Precision" : "");
+        profileBegin("solve");
+        start = clock();
+        errcode = options.singlePrecision ? closestPairDACFloatSorted(points, numPoints, &minDistance) : closestPairDACSorted(points, numPoints, &minDistance);
+        if (errcode != 0) {
+            fprintf(stderr, "Failed to find the closest pair.\n");
+            free(points);
+            return -1;
+        }
+        end = clock();
+        profileEnd();
     }
-    end = clock();
-    cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
-    printf("The closest pair distance is %15.10lf\n", minDistance);
+    cpu_time_used = options.batch ? batchTime : ((double) (end - start)) / CLOCKS_PER_SEC;
+    if (options.radius > 0.0)
+        printRadiusResult(stdout, pairs.numPairs, pairs.checksum, options.radius);
+    else
+        printf("The closest pair distance is %15.10lf\n", minDistance);
+    if (options.exact)
+        printf("The exact squared distance is %s\n", exactSquared);
+    if (options.batch)
+        printf("Solved %lu instances\n", numInstances);
+    if (options.approx)
+        printf("The exact distance lies in [%.10lf, %.10lf] (epsilon %g)\n", lowerBound, minDistance, options.epsilon);
+    if (load_time_used >= 0.0)
+        printf("Read and Sort Completed in %15.10lf seconds!\n", load_time_used);
     printf("Solution Completed in %15.10lf seconds!\n", cpu_time_used);
 
     // Open file to write the results
@@ -51,6 +298,8 @@ int main(int argc, char* argv[]) {
     if (fp == NULL) {
         fprintf(stderr, "Failed to open result file.\n");
         free(points);
+        free(coords);
+        free(distances);
         return -1;
     }
 
@@ -59,13 +308,30 @@ int main(int argc, char* argv[]) {
     // fprintf(fp, "Point-B %ld (X:%15.10f, Y:%15.10f)\n", index2, points[index2].x, points[index2].y);
     // fprintf(fp, "Distance: %.10f\n", minDistance);
 
-    fprintf(fp, "The closest pair distance is %15.10lf\n", minDistance);
+    if (options.radius > 0.0)
+        printRadiusResult(fp, pairs.numPairs, pairs.checksum, options.radius);
+    else
+        fprintf(fp, "The closest pair distance is %15.10lf\n", minDistance);
+    if (options.exact)
+        fprintf(fp, "The exact squared distance is %s\n", exactSquared);
+    if (options.batch)
+        printBatchResults(fp, distances, numInstances);
+    if (options.approx)
+        fprintf(fp, "The exact distance lies in [%.10lf, %.10lf] (epsilon %g)\n", lowerBound, minDistance, options.epsilon);
+    if (load_time_used >= 0.0)
+        fprintf(fp, "Read and Sort Time: %15.10lf seconds\n", load_time_used);
     fprintf(fp, "Elapsed Time: %15.10lf seconds\n", cpu_time_used);
+    profilePrintAll(fp);
 
     fclose(fp);
     printf("Results written to %s\n", resultFilePath);
 
     free(points); // Clean up allocated memory
+    free(coords);
+    free(distances);
+    reportPlacement(&options, &numaBefore);
+    profilePrintAll(stdout);
+    profileClose();
     printf("Done!\n");  
     return 0;
 }
@@ -0,0 +1,120 @@
+#include "ClosestPairUtilities.h"
+#include "KDTree.h"
+#include "DriverOptions.h"
+
+int main(int argc, char* argv[]) {
+    // Argument Management
+    DriverOptions options;
+    if (parseDriverOptions(argc, argv, &options, CP_OPTION_PLACEMENT | CP_OPTION_PROFILE | CP_OPTION_INDEX) || options.sampleFilePath == NULL) {
+        printf("Definition:\n\tThis Function Solves the Closest Point Problem (kd-tree Dual-Tree Traversal)\n");
+        printf("Usage:\n\tCP-KD-Seq sampleFilePath resultFilePath [--index indexFilePath]\n");
+        printf("Arguments:\n");
+        printf("\t- sampleFilePath: Path to the file containing sample points\n");
+        printf("\t- resultFilePath: Path to the file containing results\n");
+        printDriverOptions();
+        return 0;
+    }
+
+    // Counters of the phases below, with --profile
+    profileInit(options.profile);
+
+    // NUMA placement and pinning, before any point array is allocated
+    NumaCounters numaBefore;
+    if (applyPlacementOptions(&options, 0, 1, &numaBefore))
+        return -1;
+
+    const char* sampleFilePath = options.sampleFilePath;
+    const char* resultFilePath = options.resultFilePath;
+    size_t numPoints; // Number of points
+    double minX, maxX; // X domain limits
+    double minY, maxY; // Y domain limits
+    int dimension;
+
+    double minDistance;
+    size_t index1 = 0, index2 = 0;
+
+    clock_t start, end;
+    double cpu_time_used;
+
+    // Reuse the index when one was saved before, otherwise build it from the points
+    KDTree tree;
+    int errcode;
+    FILE *indexFile = options.indexFilePath ? fopen(options.indexFilePath, "rb") : NULL;
+    if (indexFile != NULL) {
+        fclose(indexFile);
+        profileBegin("index");
+        printf("Loading the index...\n");
+        errcode = kdTreeLoad(&tree, options.indexFilePath);
+        if (errcode) {
+            printf("Load Index From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("Index loaded successfully!\n");
+    }
+    else {
+        Point *points = NULL;
+        profileBegin("read");
+        printf("Reading the points...\n");
+        errcode = readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            return -1;
+        }
+        printf("File read successfully!\n");
+
+        printf("Building the index...\n");
+        profileBegin("index");
+        start = clock();
+        errcode = kdTreeBuild(&tree, points, numPoints);
+        end = clock();
+        profileEnd();
+        free(points);
+        if (errcode) {
+            fprintf(stderr, "Failed to build the index.\n");
+            return -1;
+        }
+        printf("Index built in %15.10lf seconds!\n", ((double) (end - start)) / CLOCKS_PER_SEC);
+        if (options.indexFilePath != NULL) {
+            errcode = kdTreeSave(&tree, options.indexFilePath);
+            if (errcode) {
+                printf("Save Index To File Failed with Error Code %d!\n", errcode);
+                kdTreeFree(&tree);
+                return -1;
+            }
+            printf("Index saved to %s\n", options.indexFilePath);
+        }
+    }
+
+    printf("Solving Closest Point Problem [kd-tree]...\n");
+    profileBegin("solve");
+    start = clock();
+    kdTreeClosestPair(&tree, &minDistance, &index1, &index2);
+    end = clock();
+    profileEnd();
+    cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+    printf("The closest pair distance is %15.10lf\n", minDistance);
+    printf("Solution Completed in %15.10lf seconds!\n", cpu_time_used);
+
+    // Open file to write the results
+    printf("Writing results...\n");
+    FILE *fp = fopen(resultFilePath, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Failed to open result file.\n");
+        kdTreeFree(&tree);
+        return -1;
+    }
+
+    fprintf(fp, "The closest pair distance is %15.10lf\n", minDistance);
+    fprintf(fp, "Elapsed Time: %15.10lf seconds\n", cpu_time_used);
+    profilePrintAll(fp);
+
+    fclose(fp);
+    printf("Results written to %s\n", resultFilePath);
+
+    kdTreeFree(&tree);
+    reportPlacement(&options, &numaBefore);
+    profilePrintAll(stdout);
+    profileClose();
+    printf("Done!\n");
+    return 0;
+}
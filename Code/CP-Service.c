@@ -0,0 +1,202 @@
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "ClosestPairService.h"
+#include "Calibration.h"
+
+// Appends to a growable output buffer, flushed once per batch of requests
+static int appendOutput(char** output, size_t* used, size_t* capacity, const char* text, const size_t length)
+{
+    if (*used + length > *capacity) {
+        size_t grown = 2 * (*used + length);
+        char* buffer = (char*) realloc(*output, grown);
+        if (buffer == NULL)
+            return -2;
+        *output = buffer;
+        *capacity = grown;
+    }
+    memcpy(*output + *used, text, length);
+    *used += length;
+    return 0;
+}
+
+static int writeAll(const int fd, const char* data, size_t length)
+{
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written <= 0)
+            return -1;
+        data += written;
+        length -= written;
+    }
+    return 0;
+}
+
+// Connection state kept between polls: the bytes of an unfinished request line
+typedef struct {
+    int fd;
+    char* input;
+    size_t inUsed, inCapacity;
+} ServiceClient;
+
+// Serves one readable connection: every complete line already received is handled before
+// the responses go out in a single write, so pipelined clients are batched.
+// CP_SERVICE_CLOSE also covers end of file and read or write errors.
+static int serveClient(ClosestPairService* service, ServiceClient* client, char* response, char** output, size_t* outCapacity)
+{
+    size_t outUsed = 0;
+    int state = CP_SERVICE_CONTINUE;
+    if (client->inUsed == client->inCapacity) {
+        char* grown = (char*) realloc(client->input, 2 * client->inCapacity);
+        if (grown == NULL)
+            return CP_SERVICE_CLOSE;
+        client->input = grown;
+        client->inCapacity *= 2;
+    }
+    ssize_t received = read(client->fd, client->input + client->inUsed, client->inCapacity - client->inUsed);
+    if (received <= 0)
+        return CP_SERVICE_CLOSE;
+    client->inUsed += received;
+
+    char* input = client->input;
+    size_t start = 0, i;
+    for (i = 0; i < client->inUsed && state == CP_SERVICE_CONTINUE; i++) {
+        if (input[i] != '\n')
+            continue;
+        input[i] = '\0';
+        state = serviceHandleRequest(service, input + start, response, CP_SERVICE_RESPONSE_SIZE);
+        size_t length = strlen(response);
+        response[length++] = '\n';
+        if (appendOutput(output, &outUsed, outCapacity, response, length)) {
+            state = CP_SERVICE_CLOSE;
+            break;
+        }
+        start = i + 1;
+    }
+    memmove(input, input + start, client->inUsed - start);
+    client->inUsed -= start;
+    if (writeAll(client->fd, *output, outUsed))
+        return CP_SERVICE_CLOSE;
+    return state;
+}
+
+static void closeClient(ServiceClient* client)
+{
+    close(client->fd);
+    free(client->input);
+}
+
+int main(int argc, char* argv[]) {
+    // Argument Management
+    if (argc != 2) {
+        printf("Definition:\n\tThis Function Serves Closest Point Queries from a Warm Cache over a Unix Socket\n");
+        printf("Usage:\n\tCP-Service socketPath\n");
+        printf("Arguments:\n");
+        printf("\t- socketPath: Path of the Unix socket to listen on\n");
+        printf("Requests (one per line):\n");
+        printf("\tLOAD path | CLOSEST path [DAC] | KPAIRS path k | NEAREST path x y | STATS | QUIT | SHUTDOWN\n");
+        return 0;
+    }
+
+    const char* socketPath = argv[1];
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long.\n");
+        return -1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    // Only a stale socket is replaced, never a file that happens to share the path
+    struct stat st;
+    if (lstat(socketPath, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "%s exists and is not a socket.\n", socketPath);
+            return -1;
+        }
+        unlink(socketPath);
+    }
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || bind(server, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(server, 16) != 0) {
+        perror("Failed to listen on the socket");
+        return -1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // DAC requests use the leaf size stored by a --calibrate run, if any
+    configureLeafSize(0);
+    ClosestPairService service;
+    serviceInit(&service);
+    char* response = (char*) malloc(CP_SERVICE_RESPONSE_SIZE + 1);
+    size_t outCapacity = 1 << 16;
+    char* output = (char*) malloc(outCapacity);
+    if (response == NULL || output == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -1;
+    }
+    printf("Listening on %s\n", socketPath);
+    fflush(stdout);
+
+    // One poll over the listening socket and every open connection, so an idle or slow
+    // client never holds up the others; new connections wait in the backlog when full
+    ServiceClient clients[CP_SERVICE_MAX_CLIENTS];
+    struct pollfd fds[CP_SERVICE_MAX_CLIENTS + 1];
+    int numClients = 0, c, state = CP_SERVICE_CONTINUE;
+    while (state != CP_SERVICE_SHUTDOWN) {
+        fds[0].fd = (numClients < CP_SERVICE_MAX_CLIENTS) ? server : -1;
+        fds[0].events = POLLIN;
+        for (c = 0; c < numClients; c++) {
+            fds[c + 1].fd = clients[c].fd;
+            fds[c + 1].events = POLLIN;
+        }
+        if (poll(fds, numClients + 1, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("Failed to poll the connections");
+            break;
+        }
+
+        // Backwards, so that a closed connection can take the last one's place
+        for (c = numClients - 1; c >= 0 && state != CP_SERVICE_SHUTDOWN; c--) {
+            if (!(fds[c + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            state = serveClient(&service, &clients[c], response, &output, &outCapacity);
+            if (state != CP_SERVICE_CONTINUE) {
+                closeClient(&clients[c]);
+                clients[c] = clients[--numClients];
+                if (state == CP_SERVICE_CLOSE)
+                    state = CP_SERVICE_CONTINUE;
+            }
+        }
+        if (state != CP_SERVICE_SHUTDOWN && (fds[0].revents & POLLIN)) {
+            int fd = accept(server, NULL, NULL);
+            if (fd < 0)
+                continue;
+            clients[numClients].fd = fd;
+            clients[numClients].inUsed = 0;
+            clients[numClients].inCapacity = 1 << 16;
+            clients[numClients].input = (char*) malloc(clients[numClients].inCapacity);
+            if (clients[numClients].input == NULL)
+                close(fd);
+            else
+                numClients++;
+        }
+    }
+    for (c = 0; c < numClients; c++)
+        closeClient(&clients[c]);
+
+    printf("Served %llu requests (%llu cache hits, %llu misses)\n",
+           (unsigned long long)service.requests, (unsigned long long)service.hits, (unsigned long long)service.misses);
+    close(server);
+    unlink(socketPath);
+    free(response);
+    free(output);
+    serviceFree(&service);
+    printf("Done!\n");
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Calibration.h"
+
+static const size_t leafSizeCandidates[] = {4, 8, 12, 16, 24, 32, 48, 64};
+static const char* calibrationDistributions[] = {"uniform", "clustered"};
+
+// create: make the cache directories on the way (only needed to save)
+int leafSizeFilePath(char* buffer, const size_t bufferSize, const int create)
+{
+    const char* path = getenv("CP_LEAF_SIZE_FILE");
+    if (path != NULL && path[0] != '\0') {
+        if (strlen(path) >= bufferSize)
+            return -1;
+        strcpy(buffer, path);
+        return 0;
+    }
+
+    char host[256] = "localhost", directory[4096];
+    gethostname(host, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    const char* cache = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (cache != NULL && cache[0] != '\0')
+        snprintf(directory, sizeof(directory), "%s", cache);
+    else if (home != NULL && home[0] != '\0')
+        snprintf(directory, sizeof(directory), "%s/.cache", home);
+    else
+        return -1;
+    if (create && mkdir(directory, 0755) != 0 && errno != EEXIST)
+        return -1;
+    size_t length = strlen(directory);
+    snprintf(directory + length, sizeof(directory) - length, "/ClosestPoints");
+    if (create && mkdir(directory, 0755) != 0 && errno != EEXIST)
+        return -1;
+    if ((size_t)snprintf(buffer, bufferSize, "%s/leaf-size-%s", directory, host) >= bufferSize)
+        return -1;
+    return 0;
+}
+
+int calibrateLeafSize(size_t* best)
+{
+    const size_t numSamples = sizeof(calibrationDistributions) / sizeof(calibrationDistributions[0]);
+    Point* samples[sizeof(calibrationDistributions) / sizeof(calibrationDistributions[0])] = {NULL};
+    size_t c, s, t;
+    int errcode = 0;
+    srand(CP_CALIBRATION_SEED);
+    for (s = 0; s < numSamples && errcode == 0; s++) {
+        errcode = generatePointsByDistribution(&samples[s], CP_CALIBRATION_POINTS, 0.0, 1.0, 0.0, 1.0, calibrationDistributions[s]);
+        if (errcode == 0)
+            NaturalPointSort(samples[s], CP_CALIBRATION_POINTS, 1);
+    }
+
+    // The fastest leaf size over the sum of the samples
+    const size_t previous = getLeafSize();
+    double bestTime = DBL_MAX;
+    *best = previous;
+    for (c = 0; c < sizeof(leafSizeCandidates) / sizeof(leafSizeCandidates[0]) && errcode == 0; c++) {
+        double total = 0.0;
+        setLeafSize(leafSizeCandidates[c]);
+        for (s = 0; s < numSamples && errcode == 0; s++) {
+            // Fastest of a few trials, so a single preempted run does not decide
+            double fastest = DBL_MAX;
+            for (t = 0; t < CP_CALIBRATION_TRIALS; t++) {
+                double start = wallSeconds();
+                if (closestPairRecursive(samples[s], CP_CALIBRATION_POINTS) < 0) {
+                    errcode = -2;
+                    break;
+                }
+                double elapsed = wallSeconds() - start;
+                fastest = (elapsed < fastest) ? elapsed : fastest;
+            }
+            total += fastest;
+        }
+        if (errcode == 0 && total < bestTime) {
+            bestTime = total;
+            *best = leafSizeCandidates[c];
+        }
+    }
+    setLeafSize(previous);
+    for (s = 0; s < numSamples; s++)
+        free(samples[s]);
+    return errcode;
+}
+
+int loadLeafSize(const char* path, size_t* size)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+        return -1;
+    unsigned long value;
+    int matched = fscanf(file, "leaf-size %lu", &value);
+    fclose(file);
+    if (matched != 1 || value < CP_LEAF_SIZE_MIN || value > CP_LEAF_SIZE_MAX) {
+        fprintf(stderr, "Ignoring malformed leaf size file %s.\n", path);
+        return -3;
+    }
+    *size = value;
+    return 0;
+}
+
+int saveLeafSize(const char* path, const size_t size)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Failed to write the leaf size to %s.\n", path);
+        return -1;
+    }
+    fprintf(file, "leaf-size %zu\n", size);
+    return fclose(file) ? -1 : 0;
+}
+
+// Driver start up: --calibrate measures and stores the leaf size, otherwise the
+// stored value is used when there is one and CP_LEAF_SIZE_DEFAULT when there is not
+int configureLeafSize(const int calibrate)
+{
+    char path[4096];
+    size_t size;
+    if (!calibrate) {
+        if (leafSizeFilePath(path, sizeof(path), 0) == 0 && loadLeafSize(path, &size) == 0)
+            setLeafSize(size);
+        return 0;
+    }
+
+    printf("Calibrating the leaf size...\n");
+    int errcode = calibrateLeafSize(&size);
+    if (errcode) {
+        fprintf(stderr, "Leaf size calibration failed.\n");
+        return errcode;
+    }
+    setLeafSize(size);
+    if (leafSizeFilePath(path, sizeof(path), 1) != 0) {
+        fprintf(stderr, "No place to store the leaf size, set CP_LEAF_SIZE_FILE.\n");
+        return -1;
+    }
+    errcode = saveLeafSize(path, size);
+    if (errcode == 0)
+        printf("Leaf size %zu stored in %s\n", size, path);
+    return errcode;
+}
@@ -0,0 +1,23 @@
+#ifndef Calibration_h
+
+#define Calibration_h
+#include "ClosestPairUtilities.h"
+
+// Per-machine tuning of the DAC leaf size.
+// calibrateLeafSize times the recursion on seeded uniform and clustered samples for
+// every candidate leaf size and keeps the fastest. The result is stored in a small file
+// named after the host, in $CP_LEAF_SIZE_FILE when set, otherwise under
+// $XDG_CACHE_HOME/ClosestPoints (or ~/.cache/ClosestPoints), so a shared home
+// directory keeps one value per machine. Drivers load it on startup.
+#define CP_CALIBRATION_POINTS (1 << 17)
+#define CP_CALIBRATION_TRIALS 3
+#define CP_CALIBRATION_SEED 2024
+
+// Definition
+int leafSizeFilePath(char* buffer, const size_t bufferSize, const int create);
+int calibrateLeafSize(size_t* best);
+int loadLeafSize(const char* path, size_t* size);
+int saveLeafSize(const char* path, const size_t size);
+int configureLeafSize(const int calibrate);
+
+#endif
@@ -0,0 +1,287 @@
+#include "ClosestPairApprox.h"
+
+// Cells are addressed by integer coordinates; beyond this many cells per side the
+// coordinates lose precision and the exact solver takes over
+#define CP_APPROX_MAX_CELLS ((double)((int64_t)1 << 52))
+#define CP_APPROX_CELL_POINTS 2   // Points per cell of the first grid, on average over the bounding box
+#define CP_APPROX_DENSE_CELLS 2   // Cells per point up to which the grid is an array rather than a hash table
+
+typedef struct {
+    int64_t cx, cy;
+    size_t bucket;            // Bucket + 1, or 0 when the slot is empty
+} CellSlot;
+
+typedef struct {
+    int dense;                // Every cell of the bounding box is a bucket, indexed directly
+    int64_t width, height;    // Cells per row and column, when dense
+    size_t numBuckets;
+    int64_t *cellX, *cellY;   // Cell of every bucket
+    size_t *start;            // Points of bucket b: sorted[start[b], start[b + 1])
+    CellSlot *slots;          // Open addressing, keyed by cell
+    size_t mask;
+    size_t *bucketOf;         // Bucket of every input point
+    Point *sorted;            // Points grouped by bucket
+} Grid;
+
+static inline size_t hashCell(const int64_t cx, const int64_t cy, const size_t mask)
+{
+    uint64_t h = (uint64_t)cx * 0x9E3779B97F4A7C15ULL ^ (uint64_t)cy * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 29;
+    return (size_t)h & mask;
+}
+
+// Bucket of a cell, or numBuckets when the cell is empty
+static inline size_t findCell(const Grid* grid, const int64_t cx, const int64_t cy)
+{
+    if (grid->dense)
+        return (cx < 0 || cx >= grid->width || cy < 0 || cy >= grid->height) ? grid->numBuckets : (size_t)(cy * grid->width + cx);
+    size_t slot = hashCell(cx, cy, grid->mask);
+    while (grid->slots[slot].bucket != 0) {
+        if (grid->slots[slot].cx == cx && grid->slots[slot].cy == cy)
+            return grid->slots[slot].bucket - 1;
+        slot = (slot + 1) & grid->mask;
+    }
+    return grid->numBuckets;
+}
+
+// Bucket of a point, adding its cell when it is new
+static inline size_t insertCell(Grid* grid, const int64_t cx, const int64_t cy)
+{
+    if (grid->dense)
+        return (size_t)(cy * grid->width + cx);
+    size_t slot = hashCell(cx, cy, grid->mask);
+    for (;;) {
+        CellSlot* entry = &grid->slots[slot];
+        if (entry->bucket == 0) {
+            const size_t b = grid->numBuckets++;
+            grid->cellX[b] = cx;
+            grid->cellY[b] = cy;
+            grid->start[b] = 0;
+            entry->cx = cx;
+            entry->cy = cy;
+            entry->bucket = b + 1;
+            return b;
+        }
+        if (entry->cx == cx && entry->cy == cy)
+            return entry->bucket - 1;
+        slot = (slot + 1) & grid->mask;
+    }
+}
+
+// Buckets the points by cell, directly indexed when the bounding box has at most
+// maxDense cells and hashed otherwise; returns the bucket holding the most points
+static size_t buildGrid(Grid* grid, const Point points[], const size_t numPoints, const double minX, const double minY,
+                        const double extentX, const double extentY, const double side, const size_t maxDense)
+{
+    size_t i, b, densest = 0, most = 0;
+    grid->width = (int64_t)(extentX / side) + 1;
+    grid->height = (int64_t)(extentY / side) + 1;
+    grid->dense = (double)grid->width * (double)grid->height <= (double)maxDense;
+    if (grid->dense) {
+        grid->numBuckets = (size_t)(grid->width * grid->height);
+        memset(grid->start, 0, (grid->numBuckets + 1) * sizeof(size_t));
+    } else {
+        grid->numBuckets = 0;
+        memset(grid->slots, 0, (grid->mask + 1) * sizeof(CellSlot));
+    }
+    for (i = 0; i < numPoints; i++) {
+        b = insertCell(grid, (int64_t)((points[i].x - minX) / side), (int64_t)((points[i].y - minY) / side));
+        grid->bucketOf[i] = b;
+        grid->start[b]++;
+    }
+    // Counts to offsets, then a stable scatter
+    size_t total = 0;
+    for (b = 0; b < grid->numBuckets; b++) {
+        const size_t count = grid->start[b];
+        if (count > most) {
+            most = count;
+            densest = b;
+        }
+        grid->start[b] = total;
+        total += count;
+    }
+    grid->start[grid->numBuckets] = total;
+    for (i = 0; i < numPoints; i++)
+        grid->sorted[grid->start[grid->bucketOf[i]]++] = points[i];
+    for (b = grid->numBuckets; b > 0; b--)
+        grid->start[b] = grid->start[b - 1];
+    grid->start[0] = 0;
+    return densest;
+}
+
+static int exactClosestPair(const Point points[], const size_t numPoints, double* distance)
+{
+    Point* copy = allocatePoints(numPoints + 1);
+    if (copy == NULL)
+        return -2;
+    memcpy(copy, points, numPoints * sizeof(Point));
+    int errcode = closestPairDAC(copy, numPoints, distance);
+    free(copy);
+    return errcode;
+}
+
+static inline double gapSquared(const double gapX, const double gapY)
+{
+    const double gx = (gapX > 0.0) ? gapX : 0.0, gy = (gapY > 0.0) ? gapY : 0.0;
+    return gx * gx + gy * gy;
+}
+
+// Pairs within a cell and with the four forward neighbours; bestSq and prunedSq are lowered
+static void scanGrid(const Grid* grid, const double minX, const double minY, const double side, const double slack,
+                     const double epsilon, double* bestSq, double* prunedSq)
+{
+    static const int offsets[4][2] = {{1, -1}, {1, 0}, {1, 1}, {0, 1}};
+    const double scale = (1.0 + epsilon) * (1.0 + epsilon);
+    double best = *bestSq, pruned = *prunedSq;
+    long b;
+    #pragma omp parallel reduction(min:best, pruned)
+    {
+        // Every thread starts from the shared bound, not from the reduction identity
+        best = *bestSq;
+        #pragma omp for schedule(dynamic, 256)
+        for (b = 0; b < (long)grid->numBuckets; b++) {
+            const Point* cell = grid->sorted + grid->start[b];
+            const size_t count = grid->start[b + 1] - grid->start[b];
+            size_t i, j;
+            int k;
+            double loX = cell[0].x, hiX = cell[0].x, loY = cell[0].y, hiY = cell[0].y;
+            for (i = 0; i < count; i++) {
+                loX = fmin(loX, cell[i].x); hiX = fmax(hiX, cell[i].x);
+                loY = fmin(loY, cell[i].y); hiY = fmax(hiY, cell[i].y);
+                for (j = i + 1; j < count; j++) {
+                    const double dx = cell[j].x - cell[i].x, dy = cell[j].y - cell[i].y;
+                    const double d = dx * dx + dy * dy;
+                    best = (d < best) ? d : best;
+                }
+            }
+            if (count == 0)
+                continue;
+            const int64_t cx = grid->dense ? (int64_t)b % grid->width : grid->cellX[b];
+            const int64_t cy = grid->dense ? (int64_t)b / grid->width : grid->cellY[b];
+            for (k = 0; k < 4; k++) {
+                const int64_t nx = cx + offsets[k][0], ny = cy + offsets[k][1];
+                // Rectangle of the neighbour, widened by the rounding of the cell coordinates
+                const double left = minX + (double)nx * side - slack, right = minX + (double)(nx + 1) * side + slack;
+                const double bottom = minY + (double)ny * side - slack, top = minY + (double)(ny + 1) * side + slack;
+                // Most neighbours are out of reach of every point of the cell, found before the lookup
+                const double reach = gapSquared(fmax(left - hiX, loX - right), fmax(bottom - hiY, loY - top));
+                if (reach * scale >= best) {
+                    pruned = (reach < pruned) ? reach : pruned;
+                    continue;
+                }
+                const size_t nb = findCell(grid, nx, ny);
+                if (nb == grid->numBuckets || grid->start[nb] == grid->start[nb + 1])
+                    continue;
+                const Point* other = grid->sorted + grid->start[nb];
+                const size_t otherCount = grid->start[nb + 1] - grid->start[nb];
+                for (i = 0; i < count; i++) {
+                    const double gap = gapSquared(fmax(left - cell[i].x, cell[i].x - right), fmax(bottom - cell[i].y, cell[i].y - top));
+                    if (gap * scale >= best) {
+                        pruned = (gap < pruned) ? gap : pruned;
+                        continue;
+                    }
+                    for (j = 0; j < otherCount; j++) {
+                        const double dx = other[j].x - cell[i].x, dy = other[j].y - cell[i].y;
+                        const double d = dx * dx + dy * dy;
+                        best = (d < best) ? d : best;
+                    }
+                }
+            }
+        }
+    }
+    *bestSq = best;
+    *prunedSq = pruned;
+}
+
+int closestPairApprox(const Point points[], const size_t numPoints, const double epsilon, double* distance, double* lowerBound)
+{
+    size_t i;
+    *distance = *lowerBound = DBL_MAX;
+    if (numPoints < 2)
+        return 0;
+    double minX = points[0].x, maxX = points[0].x, minY = points[0].y, maxY = points[0].y;
+    for (i = 1; i < numPoints; i++) {
+        minX = fmin(minX, points[i].x); maxX = fmax(maxX, points[i].x);
+        minY = fmin(minY, points[i].y); maxY = fmax(maxY, points[i].y);
+    }
+    const double extent = fmax(maxX - minX, maxY - minY);
+
+    // Upper bound from an evenly strided sample
+    size_t numSample = CP_APPROX_SAMPLE_FACTOR * (size_t)ceil(sqrt((double)numPoints)) + 2;
+    if (numSample > numPoints)
+        numSample = numPoints;
+    Point* sample = allocatePoints(numSample + 1);
+    if (sample == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    for (i = 0; i < numSample; i++)
+        sample[i] = points[(size_t)((double)i * numPoints / numSample)];
+    double g;
+    int errcode = closestPairDAC(sample, numSample, &g);
+    free(sample);
+    if (errcode)
+        return errcode;
+
+    Grid grid;
+    size_t slots = 1;
+    while (slots < 2 * numPoints)
+        slots <<= 1;
+    grid.mask = slots - 1;
+    grid.slots = (CellSlot*) malloc(slots * sizeof(CellSlot));
+    grid.cellX = (int64_t*) malloc(numPoints * sizeof(int64_t));
+    grid.cellY = (int64_t*) malloc(numPoints * sizeof(int64_t));
+    grid.start = (size_t*) malloc((CP_APPROX_DENSE_CELLS * numPoints + 1) * sizeof(size_t));
+    grid.bucketOf = (size_t*) malloc(numPoints * sizeof(size_t));
+    grid.sorted = allocatePoints(numPoints + 1);
+    if (grid.slots == NULL || grid.cellX == NULL || grid.cellY == NULL || grid.start == NULL || grid.bucketOf == NULL || grid.sorted == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        errcode = -2;
+    }
+
+    // bestSq stays at g * g unless the scan finds a closer pair, and then g is reported as is
+    double bestSq = g * g, prunedSq = DBL_MAX, seedSq = bestSq;
+    // Cells start at about CP_APPROX_CELL_POINTS points each, never smaller than g
+    double base = extent * sqrt((double)CP_APPROX_CELL_POINTS / numPoints);
+    while (errcode == 0 && g > 0.0) {
+        if (extent / g >= CP_APPROX_MAX_CELLS) {
+            // Distances too small for the cell coordinates: solve exactly
+            errcode = exactClosestPair(points, numPoints, &g);
+            bestSq = seedSq = g * g;
+            prunedSq = DBL_MAX;
+            break;
+        }
+        // A pair closer than g is never two cells apart, rounding included
+        const double slack = 4.0 * DBL_EPSILON * (fabs(minX) + fabs(minY) + extent + g);
+        const double side = fmax(g, base) + 2.0 * slack;
+        const size_t densest = buildGrid(&grid, points, numPoints, minX, minY, maxX - minX, maxY - minY, side, CP_APPROX_DENSE_CELLS * numPoints);
+        const size_t crowd = grid.start[densest + 1] - grid.start[densest];
+        if (crowd > CP_APPROX_CELL_MAX) {
+            // A crowded cell: its closest pair lowers g, and the cells shrink to about
+            // CP_APPROX_CELL_POINTS of its points each
+            double d;
+            errcode = exactClosestPair(grid.sorted + grid.start[densest], crowd, &d);
+            if (errcode == 0) {
+                if (d < g) {
+                    g = d;
+                    bestSq = seedSq = d * d;
+                }
+                base = side * sqrt((double)CP_APPROX_CELL_POINTS / crowd);
+                continue;
+            }
+        }
+        if (errcode == 0)
+            scanGrid(&grid, minX, minY, side, slack, epsilon, &bestSq, &prunedSq);
+        break;
+    }
+
+    free(grid.slots); free(grid.cellX); free(grid.cellY);
+    free(grid.start); free(grid.bucketOf); free(grid.sorted);
+    if (errcode) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return errcode;
+    }
+    *distance = (bestSq < seedSq) ? sqrt(bestSq) : g;
+    *lowerBound = (prunedSq < bestSq) ? sqrt(prunedSq) : *distance;
+    return 0;
+}
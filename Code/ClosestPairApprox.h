@@ -0,0 +1,24 @@
+#ifndef ClosestPairApprox_h
+
+#define ClosestPairApprox_h
+#include <stdint.h>
+#include "ClosestPairUtilities.h"
+
+// (1 + epsilon)-approximate closest pair on a hashed uniform grid, in expected linear time
+// and without sorting the input.
+//  - The exact closest pair of a sample of about CP_APPROX_SAMPLE_FACTOR sqrt(n) points is
+//    a real pair distance g >= delta, the grid cell side.
+//  - The closest pair then lies in one cell or in two neighbouring ones. A cell holding more
+//    than CP_APPROX_CELL_MAX points is solved exactly; its distance, far below g, becomes the
+//    new cell side and the grid is rebuilt, so crowded inputs never compare a cell pairwise.
+//  - A neighbouring cell is skipped when it is at least best / (1 + epsilon) away from the
+//    point. The nearest skipped cell is remembered, which certifies the interval
+//    lowerBound <= delta <= distance <= (1 + epsilon) lowerBound. epsilon = 0 is exact.
+#define CP_APPROX_EPSILON_DEFAULT 0.1
+#define CP_APPROX_SAMPLE_FACTOR 2
+#define CP_APPROX_CELL_MAX 32
+
+// Definition
+int closestPairApprox(const Point points[], const size_t numPoints, const double epsilon, double* distance, double* lowerBound);
+
+#endif
@@ -0,0 +1,95 @@
+#include "ClosestPairBatch.h"
+
+int closestPairBatch(Point points[], const uint64_t offsets[], const size_t numInstances, const size_t bruteForceMax, double distances[])
+{
+    size_t i, largest = 0;
+    for (i = 0; i < numInstances; i++)
+        if (offsets[i + 1] - offsets[i] > largest)
+            largest = offsets[i + 1] - offsets[i];
+    const int useDAC = largest > bruteForceMax;
+
+    int failed = 0;
+    #pragma omp parallel reduction(|:failed)
+    {
+        // Scratch of the largest instance covers every DAC this thread runs
+        Arena arena;
+        int ready = !useDAC || arenaInit(&arena, CP_DAC_ARENA_BYTES(largest)) == 0;
+        long k;
+        #pragma omp for schedule(dynamic, CP_BATCH_CHUNK)
+        for (k = 0; k < (long)numInstances; k++) {
+            Point* instance = points + offsets[k];
+            const size_t n = offsets[k + 1] - offsets[k];
+            if (n <= bruteForceMax) {
+                distances[k] = closestPairLeaf(instance, n);
+            }
+            else if (ready) {
+                NaturalPointSort(instance, n, 1);
+                distances[k] = closestPairRecursiveArena(instance, n, &arena);
+                failed |= distances[k] < 0;
+            }
+            else {
+                failed = 1;
+            }
+        }
+        if (useDAC && ready)
+            arenaFree(&arena);
+        failed |= !ready;
+    }
+    if (failed) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    return 0;
+}
+
+// Rough operation count of one instance, used to balance instances across ranks
+double batchInstanceCost(const size_t numPoints, const size_t bruteForceMax)
+{
+    const double n = (double)numPoints;
+    if (numPoints <= bruteForceMax)
+        return 0.5 * n * n + 1.0;
+    return 4.0 * n * log2(n) + 1.0;
+}
+
+// Contiguous instances [first, last) of one part, of about equal cost; instances are never split
+void partitionBatch(const uint64_t offsets[], const size_t numInstances, const size_t bruteForceMax, const int part, const int parts, size_t* first, size_t* last)
+{
+    size_t i;
+    double total = 0.0, before = 0.0;
+    for (i = 0; i < numInstances; i++)
+        total += batchInstanceCost(offsets[i + 1] - offsets[i], bruteForceMax);
+    // An instance belongs to the part its cost midpoint falls in
+    *first = *last = numInstances;
+    for (i = 0; i < numInstances; i++) {
+        const double cost = batchInstanceCost(offsets[i + 1] - offsets[i], bruteForceMax);
+        const int owner = (int)fmin(parts - 1, floor((before + 0.5 * cost) / total * parts));
+        if (owner >= part && *first == numInstances)
+            *first = i;
+        if (owner > part) {
+            *last = i;
+            return;
+        }
+        before += cost;
+    }
+}
+
+double minBatchDistance(const double distances[], const size_t numInstances)
+{
+    size_t i;
+    double minDistance = DBL_MAX;
+    for (i = 0; i < numInstances; i++)
+        if (distances[i] < minDistance)
+            minDistance = distances[i];
+    return minDistance;
+}
+
+// One "Instance k: distance" line per instance, in the shortest exact decimal
+void printBatchResults(FILE* fp, const double distances[], const size_t numInstances)
+{
+    size_t i;
+    char number[CP_TEXT_NUMBER_SIZE];
+    for (i = 0; i < numInstances; i++) {
+        formatDouble(distances[i], number);
+        fprintf(fp, "Instance %lu: %s\n", i, number);
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef ClosestPairBatch_h
+
+#define ClosestPairBatch_h
+#include "ClosestPairUtilities.h"
+
+// Many independent instances solved in one process (see PointBatchIO.h for the format).
+// Instances are handed to the OpenMP threads CP_BATCH_CHUNK at a time from a shared
+// queue, so a thread that drew small instances takes more of them; each thread keeps
+// one arena for all of its instances. An instance of at most bruteForceMax points is
+// solved by brute force in input order, a larger one is sorted by X in place and
+// solved by the DAC recursion. The distance of an instance of fewer than two points
+// is DBL_MAX.
+#define CP_BATCH_BRUTE_FORCE_MAX 80  // Crossover of the brute-force leaf and sort + DAC
+#define CP_BATCH_CHUNK 16            // Instances a thread takes from the queue at a time
+
+// Definition
+int closestPairBatch(Point points[], const uint64_t offsets[], const size_t numInstances, const size_t bruteForceMax, double distances[]);
+double batchInstanceCost(const size_t numPoints, const size_t bruteForceMax);
+void partitionBatch(const uint64_t offsets[], const size_t numInstances, const size_t bruteForceMax, const int part, const int parts, size_t* first, size_t* last);
+double minBatchDistance(const double distances[], const size_t numInstances);
+void printBatchResults(FILE* fp, const double distances[], const size_t numInstances);
+
+#endif
@@ -0,0 +1,100 @@
+#include "ClosestPairBichromatic.h"
+
+int closestPairBichromaticBruteForce(const Point red[], const size_t numRed, const Point blue[], const size_t numBlue, double* minDistance)
+{
+    double bestSq = DBL_MAX;
+    size_t i, j;
+    for (i = 0; i < numRed; i++) {
+        const double x = red[i].x, y = red[i].y;
+        for (j = 0; j < numBlue; j++) {
+            const double dx = blue[j].x - x, dy = blue[j].y - y;
+            const double distanceSq = dx * dx + dy * dy;
+            bestSq = (distanceSq < bestSq) ? distanceSq : bestSq;
+        }
+    }
+    *minDistance = (numRed == 0 || numBlue == 0) ? DBL_MAX : sqrt(bestSq);
+    return 0;
+}
+
+// Cross-colour pairs of one side of the cut against the other, on copies sorted by Y
+static double stripBichromatic(const Point left[], const size_t numLeft, const Point right[], const size_t numRight, const double delta, Arena* arena)
+{
+    if (numLeft == 0 || numRight == 0)
+        return delta;
+    Point* strip = (Point*) arenaAlloc(arena, (numLeft + numRight) * sizeof(Point));
+    if (strip == NULL)
+        return -1.0;
+    memcpy(strip, left, numLeft * sizeof(Point));
+    memcpy(strip + numLeft, right, numRight * sizeof(Point));
+    return stripClosestSplit(strip, numLeft, strip + numLeft, numRight, delta, 0, arena);
+}
+
+double closestPairBichromaticRecursive(const Point red[], const size_t numRed, const Point blue[], const size_t numBlue, Arena* arena)
+{
+    double minDistance;
+    if (numRed == 0 || numBlue == 0)
+        return DBL_MAX;
+    if (numRed + numBlue <= getLeafSize()) {
+        closestPairBichromaticBruteForce(red, numRed, blue, numBlue, &minDistance);
+        return minDistance;
+    }
+
+    // The half = (numRed + numBlue) / 2 leftmost points of the union are the first
+    // splitRed red and half - splitRed blue points (a merge path split)
+    const size_t half = (numRed + numBlue) / 2;
+    size_t low = (half > numBlue) ? half - numBlue : 0, high = (half < numRed) ? half : numRed;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (red[middle].x < blue[half - middle - 1].x)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    const size_t splitRed = low, splitBlue = half - low;
+    double midX = DBL_MAX;
+    if (splitRed < numRed)
+        midX = red[splitRed].x;
+    if (splitBlue < numBlue && blue[splitBlue].x < midX)
+        midX = blue[splitBlue].x;
+
+    double dl = closestPairBichromaticRecursive(red, splitRed, blue, splitBlue, arena);
+    double dr = closestPairBichromaticRecursive(red + splitRed, numRed - splitRed, blue + splitBlue, numBlue - splitBlue, arena);
+    if (dl < 0 || dr < 0)
+        return -1.0;
+    minDistance = (dl > dr) ? dr : dl;
+
+    // Both strips are contiguous ranges of the sorted sets, as in closestPairRecursiveArena
+    const size_t redFirst = nearPointsBoundX(red, splitRed, midX, minDistance, 0);
+    const size_t blueFirst = nearPointsBoundX(blue, splitBlue, midX, minDistance, 0);
+    const size_t redLast = splitRed + nearPointsBoundX(red + splitRed, numRed - splitRed, midX, minDistance, 1);
+    const size_t blueLast = splitBlue + nearPointsBoundX(blue + splitBlue, numBlue - splitBlue, midX, minDistance, 1);
+
+    ArenaMark mark = arenaMark(arena);
+    double strip = stripBichromatic(red + redFirst, splitRed - redFirst, blue + splitBlue, blueLast - splitBlue, minDistance, arena);
+    minDistance = (strip < minDistance) ? strip : minDistance;
+    if (strip >= 0) {
+        strip = stripBichromatic(blue + blueFirst, splitBlue - blueFirst, red + splitRed, redLast - splitRed, minDistance, arena);
+        minDistance = (strip < minDistance) ? strip : minDistance;
+    }
+    arenaReset(arena, mark);
+    return (strip < 0) ? -1.0 : minDistance;
+}
+
+// Both sets already sorted by X
+int closestPairBichromaticSorted(const Point red[], const size_t numRed, const Point blue[], const size_t numBlue, double* minDistance)
+{
+    // Only the strips of one level are alive at a time
+    Arena arena;
+    if (arenaInit(&arena, (numRed + numBlue) * sizeof(Point)))
+        return -2;
+    *minDistance = closestPairBichromaticRecursive(red, numRed, blue, numBlue, &arena);
+    arenaFree(&arena);
+    return (*minDistance < 0) ? -2 : 0;
+}
+
+int closestPairBichromatic(Point red[], const size_t numRed, Point blue[], const size_t numBlue, double* minDistance)
+{
+    NaturalPointSort(red, numRed, 1);
+    NaturalPointSort(blue, numBlue, 1);
+    return closestPairBichromaticSorted(red, numRed, blue, numBlue, minDistance);
+}
@@ -0,0 +1,19 @@
+#ifndef ClosestPairBichromatic_h
+
+#define ClosestPairBichromatic_h
+#include "ClosestPairUtilities.h"
+
+// Closest pair between two point sets (red-blue): only pairs with one point of each
+// set count, so two points of the same set are never compared.
+// The DAC splits both sets, sorted by X, at one X cut that halves their union; the
+// strip compares the red points left of the cut with the blue points right of it and
+// the other way round. Points of one colour may lie arbitrarily close to each other,
+// so the strip scan is bounded by the Y difference rather than a fixed window.
+
+// Definition
+int closestPairBichromaticBruteForce(const Point red[], const size_t numRed, const Point blue[], const size_t numBlue, double* minDistance);
+double closestPairBichromaticRecursive(const Point red[], const size_t numRed, const Point blue[], const size_t numBlue, Arena* arena);
+int closestPairBichromaticSorted(const Point red[], const size_t numRed, const Point blue[], const size_t numBlue, double* minDistance);
+int closestPairBichromatic(Point red[], const size_t numRed, Point blue[], const size_t numBlue, double* minDistance);
+
+#endif
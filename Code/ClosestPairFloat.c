@@ -0,0 +1,211 @@
+#include "ClosestPairFloat.h"
+
+// Strip entries remember where they came from so that candidates can be rechecked in double
+typedef struct {
+    float x;
+    float y;
+    uint32_t index;
+} StripPointF;
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+    float distanceSq;
+} CandidatePairF;
+
+typedef struct {
+    const PointF* points;
+    StripPointF* strip;
+    CandidatePairF* candidates;
+    size_t numCandidates, capacity;
+    float bestSq;       // Smallest float squared distance so far
+    float errorBound;   // Absolute error of a float distance
+    float thresholdSq;  // (sqrt(bestSq) + 2 * errorBound)^2: no pair beyond it can be the double minimum
+    int failed;
+} FloatSolver;
+
+static int compareStripY(const void *a, const void *b) {
+    StripPointF *p1 = (StripPointF *)a, *p2 = (StripPointF *)b;
+    return (p1->y > p2->y) - (p1->y < p2->y);
+}
+
+// Points are shifted to the centre of their bounding box before rounding, so the
+// error depends on the extent of the data and not on its offset from the origin
+int convertPointsToFloat(const Point points[], const size_t numPoints, PointF converted[], float* errorBound)
+{
+    size_t i;
+    double minX = DBL_MAX, maxX = -DBL_MAX, minY = DBL_MAX, maxY = -DBL_MAX;
+    for (i = 0; i < numPoints; i++) {
+        minX = fmin(minX, points[i].x); maxX = fmax(maxX, points[i].x);
+        minY = fmin(minY, points[i].y); maxY = fmax(maxY, points[i].y);
+    }
+    const double cx = 0.5 * (minX + maxX), cy = 0.5 * (minY + maxY);
+    const double extent = fmax(maxX - cx, maxY - cy);
+    if (numPoints > 0 && !(extent < 0.5 * FLT_MAX)) {
+        fprintf(stderr, "Coordinates exceed the single-precision range.\n");
+        return -1;
+    }
+    for (i = 0; i < numPoints; i++) {
+        converted[i].x = (float)(points[i].x - cx);
+        converted[i].y = (float)(points[i].y - cy);
+    }
+    // Rounding of both coordinates of both points plus the float arithmetic, with a wide margin
+    *errorBound = (float)(16.0 * FLT_EPSILON * extent) + FLT_MIN;
+    return 0;
+}
+
+static void updateThreshold(FloatSolver* solver)
+{
+    float threshold = sqrtf(solver->bestSq) + 2.0f * solver->errorBound;
+    solver->thresholdSq = (solver->bestSq == FLT_MAX) ? INFINITY : threshold * threshold;
+}
+
+static void considerPair(FloatSolver* solver, const uint32_t a, const uint32_t b, const float distanceSq)
+{
+    if (distanceSq > solver->thresholdSq)
+        return;
+    if (distanceSq < solver->bestSq) {
+        solver->bestSq = distanceSq;
+        updateThreshold(solver);
+    }
+    if (solver->numCandidates == solver->capacity) {
+        // Drop candidates the shrinking threshold has ruled out before growing
+        size_t i, kept = 0;
+        for (i = 0; i < solver->numCandidates; i++)
+            if (solver->candidates[i].distanceSq <= solver->thresholdSq)
+                solver->candidates[kept++] = solver->candidates[i];
+        solver->numCandidates = kept;
+        if (kept > solver->capacity / 2) {
+            CandidatePairF* grown = (CandidatePairF*) realloc(solver->candidates, 2 * solver->capacity * sizeof(CandidatePairF));
+            if (grown == NULL) {
+                solver->failed = 1;
+                return;
+            }
+            solver->candidates = grown;
+            solver->capacity *= 2;
+        }
+    }
+    solver->candidates[solver->numCandidates].a = a;
+    solver->candidates[solver->numCandidates].b = b;
+    solver->candidates[solver->numCandidates].distanceSq = distanceSq;
+    solver->numCandidates++;
+}
+
+static inline float squaredDistanceF(const float x1, const float y1, const float x2, const float y2)
+{
+    float dx = x1 - x2, dy = y1 - y2;
+    return dx * dx + dy * dy;
+}
+
+static void closestPairRecursiveFloat(FloatSolver* solver, const size_t first, const size_t numPoints)
+{
+    const PointF* points = solver->points;
+    size_t i, j, k;
+    if (numPoints <= 3) {
+        for (i = first; i < first + numPoints; i++)
+            for (j = i + 1; j < first + numPoints; j++)
+                considerPair(solver, i, j, squaredDistanceF(points[i].x, points[i].y, points[j].x, points[j].y));
+        return;
+    }
+
+    // Same split as closestPairRecursive, pruned by the widened threshold instead of the minimum
+    const size_t mid = numPoints / 2;
+    const float midX = points[first + mid].x;
+    closestPairRecursiveFloat(solver, first, mid);
+    closestPairRecursiveFloat(solver, first + mid, numPoints - mid);
+
+    StripPointF* strip = solver->strip;
+    for (i = first, k = 0; i < first + numPoints; i++) {
+        float dx = points[i].x - midX;
+        if (dx * dx <= solver->thresholdSq) {
+            strip[k].x = points[i].x;
+            strip[k].y = points[i].y;
+            strip[k].index = i;
+            k++;
+        }
+    }
+    qsort(strip, k, sizeof(StripPointF), compareStripY);
+    for (i = 0; i < k; i++) {
+        for (j = i + 1; j < k; j++) {
+            float dy = strip[j].y - strip[i].y;
+            if (dy * dy > solver->thresholdSq)
+                break;
+            considerPair(solver, strip[i].index, strip[j].index, squaredDistanceF(strip[i].x, strip[i].y, strip[j].x, strip[j].y));
+        }
+    }
+}
+
+// Shared set up and double recheck of the float solvers
+static int solveFloat(const Point points[], const size_t numPoints, const int use_dac, double* minDistance)
+{
+    size_t i, j;
+    *minDistance = DBL_MAX;
+    if (numPoints <= 1)
+        return 0;
+    if (numPoints > UINT32_MAX) {
+        fprintf(stderr, "Single-precision mode supports at most %u points.\n", UINT32_MAX);
+        return -1;
+    }
+
+    FloatSolver solver;
+    memset(&solver, 0, sizeof(solver));
+    PointF* converted = (PointF*) malloc(numPoints * sizeof(PointF));
+    solver.capacity = 64;
+    solver.candidates = (CandidatePairF*) malloc(solver.capacity * sizeof(CandidatePairF));
+    solver.strip = use_dac ? (StripPointF*) malloc(numPoints * sizeof(StripPointF)) : NULL;
+    if (converted == NULL || solver.candidates == NULL || (use_dac && solver.strip == NULL)) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(converted); free(solver.candidates); free(solver.strip);
+        return -2;
+    }
+    if (convertPointsToFloat(points, numPoints, converted, &solver.errorBound)) {
+        free(converted); free(solver.candidates); free(solver.strip);
+        return -1;
+    }
+    solver.points = converted;
+    solver.bestSq = FLT_MAX;
+    updateThreshold(&solver);
+
+    if (use_dac) {
+        closestPairRecursiveFloat(&solver, 0, numPoints);
+    } else {
+        for (i = 0; i < numPoints; i++)
+            for (j = i + 1; j < numPoints; j++)
+                considerPair(&solver, i, j, squaredDistanceF(converted[i].x, converted[i].y, converted[j].x, converted[j].y));
+    }
+
+    // Double-precision recheck of the surviving candidates
+    for (i = 0; i < solver.numCandidates; i++) {
+        if (solver.candidates[i].distanceSq <= solver.thresholdSq) {
+            double distance = calculateDistance(&points[solver.candidates[i].a], &points[solver.candidates[i].b]);
+            if (distance < *minDistance)
+                *minDistance = distance;
+        }
+    }
+
+    int failed = solver.failed;
+    free(converted);
+    free(solver.candidates);
+    free(solver.strip);
+    if (failed) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    return 0;
+}
+
+int closestPairBruteForceFloat(const Point points[], const size_t numPoints, double* minDistance)
+{
+    return solveFloat(points, numPoints, 0, minDistance);
+}
+
+int closestPairDACFloatSorted(const Point points[], const size_t numPoints, double* minDistance)
+{
+    return solveFloat(points, numPoints, 1, minDistance);
+}
+
+int closestPairDACFloat(Point points[], const size_t numPoints, double* minDistance)
+{
+    NaturalPointSort(points, numPoints, 1);
+    return closestPairDACFloatSorted(points, numPoints, minDistance);
+}
@@ -0,0 +1,25 @@
+#ifndef ClosestPairFloat_h
+
+#define ClosestPairFloat_h
+#include <stdint.h>
+#include "ClosestPairUtilities.h"
+
+// Single-precision screening with a double-precision recheck.
+// The solvers run on PointF (half the size of Point), keep every pair whose float
+// distance is within the float error bound of the running minimum, and recompute
+// those candidates from the original doubles. The reported distance is therefore
+// the same one the double solvers return.
+
+// Definition Data Types
+typedef struct {
+    float x;
+    float y;
+} PointF;
+
+// Definition
+int convertPointsToFloat(const Point points[], const size_t numPoints, PointF converted[], float* errorBound);
+int closestPairBruteForceFloat(const Point points[], const size_t numPoints, double* minDistance);
+int closestPairDACFloat(Point points[], const size_t numPoints, double* minDistance);
+int closestPairDACFloatSorted(const Point points[], const size_t numPoints, double* minDistance);
+
+#endif
@@ -0,0 +1,270 @@
+#include "ClosestPairInteger.h"
+
+#define CP_DISTANCE_MAX_I32 ((DistanceI32)INT64_MAX)
+#define CP_DISTANCE_MAX_I64 ((DistanceI64)(~(unsigned __int128)0 >> 1))
+
+// Implementation (generated for each coordinate width)
+// SUFFIX: I32 or I64, UKEY: unsigned type of the coordinate, SIGN: its sign bit
+#define CP_DEFINE_INTEGER_SOLVER(SUFFIX, UKEY, SIGN)                                                                          \
+                                                                                                                              \
+Distance##SUFFIX squaredDistance##SUFFIX(const Point##SUFFIX* p1, const Point##SUFFIX* p2) {                                 \
+    Distance##SUFFIX dx = (Distance##SUFFIX)p1->x - p2->x;                                                                    \
+    Distance##SUFFIX dy = (Distance##SUFFIX)p1->y - p2->y;                                                                    \
+    return dx * dx + dy * dy;                                                                                                 \
+}                                                                                                                             \
+                                                                                                                              \
+/* LSD radix sort on the sign-flipped coordinate, one byte per pass. Passes where every key */                                \
+/* shares the same byte are skipped, so narrow coordinate ranges cost fewer passes. */                                        \
+void RadixSortPoints##SUFFIX(Point##SUFFIX array[], const size_t count, Point##SUFFIX scratch[], const int sort_by_x) {      \
+    size_t i, counts[256];                                                                                                    \
+    unsigned int pass;                                                                                                        \
+    Point##SUFFIX *src = array, *dst = scratch, *swap;                                                                        \
+    for (pass = 0; pass < sizeof(UKEY); pass++) {                                                                             \
+        const unsigned int shift = 8 * pass;                                                                                  \
+        memset(counts, 0, sizeof(counts));                                                                                    \
+        for (i = 0; i < count; i++) {                                                                                         \
+            UKEY key = (UKEY)(sort_by_x ? src[i].x : src[i].y) ^ (SIGN);                                                      \
+            counts[(key >> shift) & 0xFF]++;                                                                                  \
+        }                                                                                                                     \
+        if (count == 0 || counts[((UKEY)(sort_by_x ? src[0].x : src[0].y) ^ (SIGN)) >> shift & 0xFF] == count)               \
+            continue;                                                                                                         \
+        size_t sum = 0, c;                                                                                                    \
+        for (i = 0; i < 256; i++) { c = counts[i]; counts[i] = sum; sum += c; }                                               \
+        for (i = 0; i < count; i++) {                                                                                         \
+            UKEY key = (UKEY)(sort_by_x ? src[i].x : src[i].y) ^ (SIGN);                                                      \
+            dst[counts[(key >> shift) & 0xFF]++] = src[i];                                                                    \
+        }                                                                                                                     \
+        swap = src; src = dst; dst = swap;                                                                                    \
+    }                                                                                                                         \
+    if (src != array)                                                                                                         \
+        memcpy(array, src, count * sizeof(Point##SUFFIX));                                                                    \
+}                                                                                                                             \
+                                                                                                                              \
+int closestPairBruteForce##SUFFIX(const Point##SUFFIX points[], const size_t numPoints, Distance##SUFFIX* minSquared) {      \
+    size_t i, j;                                                                                                              \
+    Distance##SUFFIX distance;                                                                                                \
+    *minSquared = CP_DISTANCE_MAX_##SUFFIX;                                                                                   \
+    for (i = 0; i < numPoints; i++) {                                                                                         \
+        for (j = i + 1; j < numPoints; j++) {                                                                                 \
+            distance = squaredDistance##SUFFIX(&points[i], &points[j]);                                                       \
+            if (distance < *minSquared)                                                                                       \
+                *minSquared = distance;                                                                                       \
+        }                                                                                                                     \
+    }                                                                                                                         \
+    return 0;                                                                                                                 \
+}                                                                                                                             \
+                                                                                                                              \
+/* Points come in sorted by X and leave sorted by Y (merged on the way up), so the strips */                                  \
+/* need no extra sort. best carries the smallest squared distance found so far. */                                            \
+static Distance##SUFFIX closestPairRecursive##SUFFIX(Point##SUFFIX points[], const size_t numPoints,                          \
+                                                     Point##SUFFIX scratch[], Distance##SUFFIX best) {                        \
+    size_t i, j, k;                                                                                                           \
+    Distance##SUFFIX distance, dx, dy;                                                                                        \
+    if (numPoints <= 3) {                                                                                                     \
+        for (i = 0; i < numPoints; i++)                                                                                       \
+            for (j = i + 1; j < numPoints; j++) {                                                                             \
+                distance = squaredDistance##SUFFIX(&points[i], &points[j]);                                                   \
+                if (distance < best)                                                                                          \
+                    best = distance;                                                                                          \
+            }                                                                                                                 \
+        for (i = 1; i < numPoints; i++) {                                                                                     \
+            Point##SUFFIX key = points[i];                                                                                    \
+            for (j = i; j > 0 && points[j - 1].y > key.y; j--)                                                                \
+                points[j] = points[j - 1];                                                                                    \
+            points[j] = key;                                                                                                  \
+        }                                                                                                                     \
+        return best;                                                                                                          \
+    }                                                                                                                         \
+                                                                                                                              \
+    const size_t mid = numPoints / 2;                                                                                         \
+    const Distance##SUFFIX midX = points[mid].x;                                                                              \
+    best = closestPairRecursive##SUFFIX(points, mid, scratch, best);                                                          \
+    best = closestPairRecursive##SUFFIX(points + mid, numPoints - mid, scratch, best);                                        \
+                                                                                                                              \
+    /* Merge both halves by Y */                                                                                              \
+    for (i = 0, j = mid, k = 0; i < mid && j < numPoints; k++)                                                                \
+        scratch[k] = (points[j].y < points[i].y) ? points[j++] : points[i++];                                                 \
+    while (i < mid) scratch[k++] = points[i++];                                                                               \
+    while (j < numPoints) scratch[k++] = points[j++];                                                                         \
+    memcpy(points, scratch, numPoints * sizeof(Point##SUFFIX));                                                               \
+                                                                                                                              \
+    /* Strip around the dividing line, already in Y order */                                                                  \
+    for (i = 0, k = 0; i < numPoints; i++) {                                                                                  \
+        dx = (Distance##SUFFIX)points[i].x - midX;                                                                            \
+        if (dx * dx < best)                                                                                                   \
+            scratch[k++] = points[i];                                                                                         \
+    }                                                                                                                         \
+    for (i = 0; i < k; i++) {                                                                                                 \
+        for (j = i + 1; j < k; j++) {                                                                                         \
+            dy = (Distance##SUFFIX)scratch[j].y - scratch[i].y;                                                               \
+            if (dy * dy >= best)                                                                                              \
+                break;                                                                                                        \
+            distance = squaredDistance##SUFFIX(&scratch[i], &scratch[j]);                                                     \
+            if (distance < best)                                                                                              \
+                best = distance;                                                                                              \
+        }                                                                                                                     \
+    }                                                                                                                         \
+    return best;                                                                                                              \
+}                                                                                                                             \
+                                                                                                                              \
+int closestPairDACSorted##SUFFIX(Point##SUFFIX points[], const size_t numPoints, Distance##SUFFIX* minSquared) {             \
+    Point##SUFFIX* scratch = (Point##SUFFIX*) malloc((numPoints + 1) * sizeof(Point##SUFFIX));                                \
+    if (scratch == NULL) {                                                                                                    \
+        fprintf(stderr, "Memory allocation failed.\n");                                                                       \
+        return -1;                                                                                                            \
+    }                                                                                                                         \
+    *minSquared = closestPairRecursive##SUFFIX(points, numPoints, scratch, CP_DISTANCE_MAX_##SUFFIX);                         \
+    free(scratch);                                                                                                            \
+    return 0;                                                                                                                 \
+}                                                                                                                             \
+                                                                                                                              \
+int closestPairDAC##SUFFIX(Point##SUFFIX points[], const size_t numPoints, Distance##SUFFIX* minSquared) {                   \
+    Point##SUFFIX* scratch = (Point##SUFFIX*) malloc((numPoints + 1) * sizeof(Point##SUFFIX));                                \
+    if (scratch == NULL) {                                                                                                    \
+        fprintf(stderr, "Memory allocation failed.\n");                                                                       \
+        return -1;                                                                                                            \
+    }                                                                                                                         \
+    RadixSortPoints##SUFFIX(points, numPoints, scratch, 1);                                                                   \
+    *minSquared = closestPairRecursive##SUFFIX(points, numPoints, scratch, CP_DISTANCE_MAX_##SUFFIX);                         \
+    free(scratch);                                                                                                            \
+    return 0;                                                                                                                 \
+}
+
+CP_DEFINE_INTEGER_SOLVER(I32, uint32_t, (uint32_t)1 << 31)
+CP_DEFINE_INTEGER_SOLVER(I64, uint64_t, (uint64_t)1 << 63)
+
+// Accepts an optional sign, digits and an optional fraction made only of zeros ("12", "-3", "7.0000000000"),
+// so files written by writePointsToFile from integer-valued points read back exactly.
+static int parseIntegerToken(const char* token, int64_t* value)
+{
+    const char* c = token;
+    int negative = 0;
+    uint64_t magnitude = 0;
+    if (*c == '+' || *c == '-') negative = (*c++ == '-');
+    if (*c < '0' || *c > '9') return -1;
+    while (*c >= '0' && *c <= '9') {
+        const uint64_t digit = (uint64_t)(*c++ - '0');
+        // Checked before the multiplication, which could wrap around
+        if (magnitude > ((uint64_t)CP_I64_COORD_LIMIT - digit) / 10) return -1;
+        magnitude = magnitude * 10 + digit;
+    }
+    if (*c == '.') {
+        c++;
+        while (*c == '0') c++;
+    }
+    if (*c != '\0') return -1;
+    *value = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+    return 0;
+}
+
+int readPointsFromFileInteger(const char* filename, PointI64** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+
+    // Read the header information
+    if (fscanf(file, "%ld", numPoints) != 1 ||
+        fscanf(file, "%lf %lf %lf %lf", minX, maxX, minY, maxY) != 4 ||
+        fscanf(file, "%d", dimensions) != 1) {
+        fprintf(stderr, "Failed to read the file header.\n");
+        fclose(file);
+        return -3;
+    }
+    // Skip the optional sorted-x flag; no coordinate starts with its first letter
+    if (fscanf(file, " " CP_TEXT_SORTED_X_TAG) == EOF && ferror(file)) {
+        fprintf(stderr, "Failed to read the file header.\n");
+        fclose(file);
+        return -3;
+    }
+    if (*dimensions != 2) {
+        fprintf(stderr, "Only 2-dimensional points are supported (file has %d).\n", *dimensions);
+        fclose(file);
+        return -4;
+    }
+
+    *points = (PointI64*) malloc((*numPoints) * sizeof(PointI64));
+    if (*points == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        fclose(file);
+        return -2;
+    }
+
+    // Read points data
+    size_t i;
+    char tokenX[64], tokenY[64];
+    for (i = 0; i < *numPoints; i++)
+    {
+        if (fscanf(file, "%63s %63s", tokenX, tokenY) != 2 ||
+            parseIntegerToken(tokenX, &((*points)[i].x)) || parseIntegerToken(tokenY, &((*points)[i].y)))
+        {
+            fprintf(stderr, "Failed to read integer data for point %ld (|coordinate| must be an integer below 2^62).\n", i);
+            free(*points); *points = NULL;
+            fclose(file);
+            return -3; // Error code for reading failure
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+int fitsPointsI32(const PointI64 points[], const size_t numPoints)
+{
+    size_t i;
+    for (i = 0; i < numPoints; i++) {
+        if (llabs(points[i].x) > CP_I32_COORD_LIMIT || llabs(points[i].y) > CP_I32_COORD_LIMIT)
+            return 0;
+    }
+    return 1;
+}
+
+void narrowPointsToI32(const PointI64 points[], const size_t numPoints, PointI32 narrowed[])
+{
+    size_t i;
+    for (i = 0; i < numPoints; i++) {
+        narrowed[i].x = (int32_t)points[i].x;
+        narrowed[i].y = (int32_t)points[i].y;
+    }
+}
+
+// Runs the I32 solvers when the coordinates allow it (half the memory traffic), the I64 ones otherwise
+int closestPairExact(PointI64 points[], const size_t numPoints, const int use_dac, DistanceI64* minSquared)
+{
+    int errcode;
+    if (fitsPointsI32(points, numPoints)) {
+        DistanceI32 minSquared32 = 0;
+        PointI32* narrowed = (PointI32*) malloc((numPoints + 1) * sizeof(PointI32));
+        if (narrowed == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return -1;
+        }
+        narrowPointsToI32(points, numPoints, narrowed);
+        errcode = use_dac ? closestPairDACI32(narrowed, numPoints, &minSquared32)
+                          : closestPairBruteForceI32(narrowed, numPoints, &minSquared32);
+        *minSquared = minSquared32;
+        free(narrowed);
+        return errcode;
+    }
+    return use_dac ? closestPairDACI64(points, numPoints, minSquared)
+                   : closestPairBruteForceI64(points, numPoints, minSquared);
+}
+
+int formatSquaredDistance(const DistanceI64 value, char* buffer, const size_t bufferSize)
+{
+    char digits[48];
+    int count = 0;
+    unsigned __int128 magnitude = (value < 0) ? -(unsigned __int128)value : (unsigned __int128)value;
+    do {
+        digits[count++] = (char)('0' + (int)(magnitude % 10));
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if ((size_t)count + 2 > bufferSize)
+        return -1;
+    int k = 0;
+    if (value < 0) buffer[k++] = '-';
+    while (count > 0) buffer[k++] = digits[--count];
+    buffer[k] = '\0';
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef ClosestPairInteger_h
+
+#define ClosestPairInteger_h
+#include <stdint.h>
+#include "ClosestPairUtilities.h"
+
+// Exact closest pair on integer grid coordinates.
+// Distances are compared squared in an integer type wide enough to never overflow,
+// so every solver and every run returns the same answer for the same input.
+//  - I32: |coordinate| <= CP_I32_COORD_LIMIT, squared distances in int64_t
+//  - I64: |coordinate| <= CP_I64_COORD_LIMIT, squared distances in __int128
+// A difference is then below 2^31 (2^63), so dx^2 + dy^2 stays below 2^63 (2^127).
+#define CP_I32_COORD_LIMIT (((int64_t)1 << 30) - 1)
+#define CP_I64_COORD_LIMIT (((int64_t)1 << 62) - 1)
+
+// Definition Data Types
+typedef struct {
+    int32_t x;
+    int32_t y;
+} PointI32;
+
+typedef struct {
+    int64_t x;
+    int64_t y;
+} PointI64;
+
+typedef int64_t DistanceI32;
+typedef __int128 DistanceI64;
+
+// Definition (generated for each coordinate width)
+#define CP_DECLARE_INTEGER_SOLVER(SUFFIX)                                                                                     \
+    Distance##SUFFIX squaredDistance##SUFFIX(const Point##SUFFIX* p1, const Point##SUFFIX* p2);                               \
+    void RadixSortPoints##SUFFIX(Point##SUFFIX array[], const size_t count, Point##SUFFIX scratch[], const int sort_by_x);     \
+    int closestPairBruteForce##SUFFIX(const Point##SUFFIX points[], const size_t numPoints, Distance##SUFFIX* minSquared);     \
+    int closestPairDAC##SUFFIX(Point##SUFFIX points[], const size_t numPoints, Distance##SUFFIX* minSquared);                  \
+    int closestPairDACSorted##SUFFIX(Point##SUFFIX points[], const size_t numPoints, Distance##SUFFIX* minSquared);
+
+CP_DECLARE_INTEGER_SOLVER(I32)
+CP_DECLARE_INTEGER_SOLVER(I64)
+
+int readPointsFromFileInteger(const char* filename, PointI64** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions);
+int fitsPointsI32(const PointI64 points[], const size_t numPoints);
+void narrowPointsToI32(const PointI64 points[], const size_t numPoints, PointI32 narrowed[]);
+int closestPairExact(PointI64 points[], const size_t numPoints, const int use_dac, DistanceI64* minSquared);
+int formatSquaredDistance(const DistanceI64 value, char* buffer, const size_t bufferSize);
+
+#endif
@@ -0,0 +1,1106 @@
+#include "ClosestPairMPI.h"
+
+// Distributed closest pair shared by CP-BF-MPI and CP-DAC-MPI.
+// points/numPoints are only meaningful on rank 0, which owns (and frees) the array.
+// Every rank returns with the global minimum in minDistance.
+int closestPairMPI(Point** points, const size_t numPoints, const int solver, double* minDistance)
+{
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    Point* local_points = NULL;
+    int local_numPoints;
+    double* midpointsX = (double*) malloc(size * sizeof(double));
+    distributeSlabsMPI(points, numPoints, 0, &local_points, &local_numPoints, midpointsX);
+    closestPairMPISlabs(local_points, local_numPoints, midpointsX, solver, minDistance);
+
+    // Free Memory
+    free(local_points); local_points = NULL;
+    free(midpointsX); midpointsX = NULL;
+    return 0;
+}
+
+// Sort and scatter phase: rank 0's points (freed here) end up as one slab per rank, sorted
+// by X, and every rank receives the size - 1 slab boundaries in midpointsX. With presorted
+// (the same on every rank) rank 0's points are already sorted and only scattered.
+int distributeSlabsMPI(Point** points, const size_t numPoints, const int presorted, Point** slab, int* slabPoints, double midpointsX[])
+{
+    int rank, size;
+    int i;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Sort All points According to X coordinate
+    double sorting_time;
+    if (!presorted)
+        QuickPointSortMPI(points, numPoints, size, rank, &sorting_time, 1, 1);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int points_per_process = numPoints / size;
+    int remaining_points   = numPoints % size;
+    int local_numPoints = (rank < remaining_points) ? (points_per_process + 1) : points_per_process;
+    Point *local_points = (rank == 0) ? NULL : (Point*)malloc(local_numPoints * sizeof(Point));
+    int* sendcounts = (int*) malloc(size * sizeof(int));
+    int* displs     = (int*) malloc(size * sizeof(int));
+
+    int accumulated_displs = 0;
+    for (i = 0; i < size; i++) {
+        sendcounts[i] = (i < remaining_points) ? (points_per_process + 1) * sizeof(Point) : points_per_process * sizeof(Point);
+        displs[i] = accumulated_displs;
+        accumulated_displs += sendcounts[i];
+    }
+
+    if (rank == 0)
+    {
+        // Boundary i lies between the last point of rank i and the first point of rank i+1.
+        // Ranks left empty (numPoints < size) get the nearest existing point instead.
+        for (i = 0; i < size-1; i++){
+            size_t first = displs[i+1]/sizeof(Point);
+            if (first == 0)
+                midpointsX[i] = (*points)[0].x;
+            else if (first >= numPoints)
+                midpointsX[i] = (*points)[numPoints-1].x;
+            else
+                midpointsX[i] = 0.5 * ((*points)[first-1].x + (*points)[first].x);
+        }
+    }
+
+    MPI_Bcast(midpointsX, (size-1), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // Scatter the points to all processes, rank 0 keeps its slab in place and shrinks the array to it
+    if (rank == 0) {
+        MPI_Scatterv(*points, sendcounts, displs, MPI_BYTE, MPI_IN_PLACE, sendcounts[rank], MPI_BYTE, 0, MPI_COMM_WORLD);
+        local_points = (Point*) realloc(*points, (local_numPoints + 1) * sizeof(Point));
+        if (local_points == NULL) local_points = *points;
+        *points = NULL;
+    }
+    else
+        MPI_Scatterv(NULL, sendcounts, displs, MPI_BYTE, local_points, sendcounts[rank], MPI_BYTE, 0, MPI_COMM_WORLD);
+
+    // Free Unnecessary Memory
+    free(sendcounts); sendcounts = NULL;
+    free(displs); displs = NULL;
+
+    *slab = local_points;
+    *slabPoints = local_numPoints;
+    return 0;
+}
+
+// Strip exchange along the slabs. A pair (p, q) closer than delta with p on rank a and q on
+// rank b > a straddles boundary a: p.x > midpointsX[a] - delta and q.x < midpointsX[a] + delta.
+// When slabs are thinner than delta, b can be further than a+1 away, so every rank forwards the
+// received points that still reach its right boundary together with its own right strip.
+// Returns in *strip (arena memory) the points received from the left followed by the own left
+// strip. tag separates concurrent exchanges (one per point set).
+static int exchangeStripsMPI(const Point local_points[], const int local_numPoints, const double midpointsX[], const double delta, const int tag,
+                             Arena* arena, Point** strip, int* count_recv, int* count_SL)
+{
+    int rank, size, i;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    int count_SR = 0, count_sent = 0;
+    Point *buff_recv = NULL, *buff_send = NULL;
+    *count_recv = 0;
+    *count_SL = 0;
+
+    // Local points are sorted by X: the left strip is a prefix, the right strip a suffix,
+    // both found by binary search
+    if (rank > 0)
+        *count_SL = (int) LowerBoundPointsX(local_points, local_numPoints, midpointsX[rank-1] + delta);
+    if (rank < size-1)
+        count_SR = local_numPoints - (int) UpperBoundPointsX(local_points, local_numPoints, midpointsX[rank] - delta);
+
+    if (rank > 0) {
+        // Recieve From The Previous Process: Recv Info
+        MPI_Recv(count_recv, 1, MPI_INT, (rank-1), 2 * tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        buff_recv = (Point*) arenaAlloc(arena, (*count_recv + *count_SL + 1) * sizeof(Point));
+        MPI_Recv(buff_recv, (*count_recv * sizeof(Point)), MPI_BYTE, (rank-1), 2 * tag + 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+    if (rank < size-1) {
+        // Preparing Send Buffer: forwarded points first, then the own right strip.
+        // Received points come from several ranks and are not sorted: compacted without
+        // branches, every point is written and the cursor only advances past the kept ones
+        buff_send = (Point*) arenaAlloc(arena, (*count_recv + count_SR + 1) * sizeof(Point));
+        const double forwardX = midpointsX[rank] - delta;
+        for (i = 0; i < *count_recv; i++) {
+            buff_send[count_sent] = buff_recv[i];
+            count_sent += (buff_recv[i].x > forwardX);
+        }
+        memcpy(buff_send + count_sent, local_points + (local_numPoints - count_SR), count_SR * sizeof(Point));
+        count_sent += count_SR;
+
+        // Send To the next process : Send Info
+        MPI_Send(&count_sent, 1, MPI_INT, (rank+1), 2 * tag, MPI_COMM_WORLD);
+        MPI_Send(buff_send, (count_sent * sizeof(Point)), MPI_BYTE, (rank+1), 2 * tag + 1, MPI_COMM_WORLD);
+    }
+    if (rank > 0)
+        memcpy(buff_recv + *count_recv, local_points, *count_SL * sizeof(Point));
+    *strip = buff_recv;
+    return 0;
+}
+
+// Solve phase on slabs already in place: every rank holds its slab sorted by X, and
+// midpointsX[i] separates the slabs of rank i and i+1. The slabs stay owned by the caller.
+int closestPairMPISlabs(Point local_points[], const int local_numPoints, const double midpointsX[], const int solver, double* minDistance)
+{
+    return closestPairMPISlabsThreshold(local_points, local_numPoints, midpointsX, solver, 0.0, minDistance);
+}
+
+// closestPairMPISlabs that stops once a pair closer than threshold is known: brute-force slabs
+// exit at the first such pair, and the strips are skipped when a slab already holds one
+int closestPairMPISlabsThreshold(Point local_points[], const int local_numPoints, const double midpointsX[], const int solver, const double threshold, double* minDistance)
+{
+    int rank, size;
+    int i;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    double *zonal_min_dist = NULL; // Gather all minimum distances to rank 0
+    if (rank == 0)
+        zonal_min_dist = (double*) malloc(size * sizeof(double));
+
+    // Scratch of the slab solve and of the strip exchange, sized from the slab
+    Arena arena;
+    if (arenaInit(&arena, CP_DAC_ARENA_BYTES(local_numPoints)))
+        MPI_Abort(MPI_COMM_WORLD, -2);
+
+    // Solve Closest Point Problem in each slab
+    profileBegin("slab");
+    double local_min = DBL_MAX;
+    int errcode = 0;
+    if (solver & CP_SOLVER_FLOAT)
+        errcode = ((solver & CP_SOLVER_MASK) == CP_SOLVER_BF) ? closestPairBruteForceFloat(local_points, local_numPoints, &local_min)
+                                                              : closestPairDACFloatSorted(local_points, local_numPoints, &local_min);
+    else if ((solver & CP_SOLVER_MASK) == CP_SOLVER_BF)
+        errcode = closestPairBruteForcePruned(local_points, local_numPoints, threshold, &local_min);
+    else {
+        local_min = closestPairRecursiveArena(local_points, local_numPoints, &arena);
+        errcode = (local_min < 0) ? -2 : 0;
+    }
+    if (errcode)
+        fprintf(stderr, "Solution Failed on Rank %d!\n", rank);
+
+    // Calculate The Least in Each Domain
+    profileBegin("strip");
+    MPI_Gather(&local_min, 1, MPI_DOUBLE, zonal_min_dist, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank == 0)
+    {
+        *minDistance = DBL_MAX;
+        for (i = 0; i < size; i++) {
+            if (zonal_min_dist[i] < *minDistance) {
+                *minDistance = zonal_min_dist[i];
+            }
+        }
+    }
+
+    // Send The New Min and Go for Strips
+    MPI_Bcast(minDistance, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (size > 1 && *minDistance >= threshold){
+        // Points near the slab boundaries travel right, see exchangeStripsMPI
+        const double delta = *minDistance;
+        Point* strip = NULL;
+        int count_recv = 0, count_SL = 0;
+        double mid_min = DBL_MAX;
+        exchangeStripsMPI(local_points, local_numPoints, midpointsX, delta, 0, &arena, &strip, &count_recv, &count_SL);
+        if (count_recv > 0 && count_SL > 0)
+            mid_min = closestPairMPIStrip(strip, count_recv, count_SL, delta, solver);
+
+        MPI_Gather(&mid_min, 1, MPI_DOUBLE, zonal_min_dist, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        if (rank == 0)
+        {
+            for (i = 1; i < size; i++) {
+                if (zonal_min_dist[i] < *minDistance) {
+                    *minDistance = zonal_min_dist[i];
+                }
+            }
+        }
+        MPI_Bcast(minDistance, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+
+    profileEnd();
+
+    // Free Memory
+    arenaFree(&arena);
+    if (rank == 0) free(zonal_min_dist);
+    return 0;
+}
+
+// Second point set of the red-blue mode: rank 0's points, sorted by X (freed here), are cut
+// at the slab boundaries of the first set, so rank r gets midpointsX[r-1] < x <= midpointsX[r]
+// and the strip exchange stays the same as for one set.
+int distributeByCutsMPI(Point** points, const size_t numPoints, const double midpointsX[], Point** slab, int* slabPoints)
+{
+    int rank, size, i;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int* sendcounts = (int*) malloc(size * sizeof(int));
+    int* displs     = (int*) malloc(size * sizeof(int));
+    if (rank == 0) {
+        size_t first = 0;
+        for (i = 0; i < size; i++) {
+            size_t last = (i < size-1) ? UpperBoundPointsX(*points, numPoints, midpointsX[i]) : numPoints;
+            last = (last < first) ? first : last;
+            sendcounts[i] = (int)((last - first) * sizeof(Point));
+            displs[i] = (int)(first * sizeof(Point));
+            first = last;
+        }
+    }
+    MPI_Bcast(sendcounts, size, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(displs, size, MPI_INT, 0, MPI_COMM_WORLD);
+
+    const int local_numPoints = sendcounts[rank] / (int) sizeof(Point);
+    Point* local_points = (Point*) malloc((local_numPoints + 1) * sizeof(Point));
+    if (local_points == NULL)
+        MPI_Abort(MPI_COMM_WORLD, -2);
+    MPI_Scatterv((rank == 0) ? *points : NULL, sendcounts, displs, MPI_BYTE, local_points, sendcounts[rank], MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        free(*points);
+        *points = NULL;
+    }
+    free(sendcounts);
+    free(displs);
+
+    *slab = local_points;
+    *slabPoints = local_numPoints;
+    return 0;
+}
+
+static int compareLatticeCells(const void* a, const void* b)
+{
+    const int64_t *c1 = (const int64_t*)a, *c2 = (const int64_t*)b;
+    if (c1[1] != c2[1])
+        return (c1[1] > c2[1]) - (c1[1] < c2[1]);
+    return (c1[0] > c2[0]) - (c1[0] < c2[0]);
+}
+
+// Approximate solve phase: every slab runs closestPairApprox, giving the global distance D
+// and lower bound L. Across each boundary the left rank sends only the occupied cells of a
+// lattice of side epsilon L / (2 sqrt 2) over its points within D of the boundary, sorted
+// by row; the right rank bounds its own band points against those cells. When that bound is
+// not within 1 + epsilon (or the bands reach past a neighbouring slab, or epsilon is 0) the
+// exact strip exchange runs instead, limited to the distance found so far.
+// The reported distance may be the lattice upper bound rather than the length of a pair.
+int closestPairMPISlabsApprox(Point local_points[], const int local_numPoints, const double midpointsX[], const double epsilon, double* distance, double* lowerBound)
+{
+    int rank, size, i, r;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    profileBegin("slab");
+    double local[2], global[2];
+    if (closestPairApprox(local_points, local_numPoints, epsilon, &local[0], &local[1]))
+        MPI_Abort(MPI_COMM_WORLD, -2);
+    MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    *distance = global[0];
+    *lowerBound = global[1];
+    profileBegin("strip");
+    if (size == 1 || *distance == 0.0) {
+        profileEnd();
+        return 0;
+    }
+
+    // Bands of width D, on a lattice whose cell diagonal is epsilon L / 2
+    const double D = *distance, L = *lowerBound;
+    const double q = epsilon * L / (2.0 * M_SQRT2);
+    const int numLeft = (rank > 0) ? (int) LowerBoundPointsX(local_points, local_numPoints, midpointsX[rank-1] + D) : 0;
+    const int firstRight = (rank < size-1) ? (int) UpperBoundPointsX(local_points, local_numPoints, midpointsX[rank] - D) : local_numPoints;
+    int lattice = (q > 0.0 && D < DBL_MAX), anyLattice;
+    for (r = 1; r < size - 1; r++)
+        lattice &= (midpointsX[r] - midpointsX[r-1] >= D);
+    for (i = 0; i < numLeft && lattice; i++)
+        lattice &= (fabs(local_points[i].y) + D) / q < CP_APPROX_LATTICE_MAX;
+    for (i = firstRight; i < local_numPoints && lattice; i++)
+        lattice &= (fabs(local_points[i].y) + D) / q < CP_APPROX_LATTICE_MAX;
+    MPI_Allreduce(&lattice, &anyLattice, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+    double crossSq[2] = {DBL_MAX, DBL_MAX}, globalSq[2];  // Lower and upper bound, squared
+    if (anyLattice) {
+        const int left = (rank > 0) ? rank - 1 : MPI_PROC_NULL, right = (rank < size-1) ? rank + 1 : MPI_PROC_NULL;
+        int numSent = 0, numReceived = 0;
+        int64_t* sent = (int64_t*) malloc(2 * (size_t)(local_numPoints - firstRight + 1) * sizeof(int64_t));
+        if (sent == NULL)
+            MPI_Abort(MPI_COMM_WORLD, -2);
+        if (rank < size-1) {
+            for (i = firstRight; i < local_numPoints; i++) {
+                sent[2 * numSent] = (int64_t) floor((local_points[i].x - midpointsX[rank]) / q);
+                sent[2 * numSent + 1] = (int64_t) floor(local_points[i].y / q);
+                numSent++;
+            }
+            qsort(sent, numSent, 2 * sizeof(int64_t), compareLatticeCells);
+            int unique = 0;
+            for (i = 0; i < numSent; i++)
+                if (unique == 0 || compareLatticeCells(sent + 2 * i, sent + 2 * (unique - 1)) != 0) {
+                    sent[2 * unique] = sent[2 * i];
+                    sent[2 * unique + 1] = sent[2 * i + 1];
+                    unique++;
+                }
+            numSent = unique;
+        }
+        MPI_Sendrecv(&numSent, 1, MPI_INT, right, 6, &numReceived, 1, MPI_INT, left, 6, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        int64_t* cells = (int64_t*) malloc(2 * (size_t)(numReceived + 1) * sizeof(int64_t));
+        if (cells == NULL)
+            MPI_Abort(MPI_COMM_WORLD, -2);
+        MPI_Sendrecv(sent, 2 * numSent, MPI_INT64_T, right, 7, cells, 2 * numReceived, MPI_INT64_T, left, 7, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+        // Every left band point against the cells of the rows within D of it
+        const double mid = (rank > 0) ? midpointsX[rank-1] : 0.0;
+        for (i = 0; i < numLeft && numReceived > 0; i++) {
+            const Point p = local_points[i];
+            const int64_t lowRow = (int64_t) floor((p.y - D) / q) - 1, highRow = (int64_t) floor((p.y + D) / q) + 1;
+            int lo = 0, hi = numReceived;
+            while (lo < hi) {
+                const int m = (lo + hi) / 2;
+                if (cells[2 * m + 1] < lowRow) lo = m + 1; else hi = m;
+            }
+            for (; lo < numReceived && cells[2 * lo + 1] <= highRow; lo++) {
+                // Cell rectangle, widened by the rounding of the lattice coordinates
+                const double slack = 8.0 * DBL_EPSILON * (fabs(mid) + fabs(p.y) + D + q);
+                const double x0 = mid + (double)cells[2 * lo] * q - slack, x1 = mid + (double)(cells[2 * lo] + 1) * q + slack;
+                const double y0 = (double)cells[2 * lo + 1] * q - slack, y1 = (double)(cells[2 * lo + 1] + 1) * q + slack;
+                const double gx = fmax(0.0, fmax(x0 - p.x, p.x - x1)), gy = fmax(0.0, fmax(y0 - p.y, p.y - y1));
+                const double fx = fmax(fabs(p.x - x0), fabs(p.x - x1)), fy = fmax(fabs(p.y - y0), fabs(p.y - y1));
+                crossSq[0] = fmin(crossSq[0], gx * gx + gy * gy);
+                crossSq[1] = fmin(crossSq[1], fx * fx + fy * fy);
+            }
+        }
+        free(sent);
+        free(cells);
+    }
+    MPI_Allreduce(crossSq, globalSq, 2, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    if (globalSq[1] < D * D)
+        *distance = sqrt(globalSq[1]);
+    if (globalSq[0] < L * L)
+        *lowerBound = sqrt(globalSq[0]);
+
+    if (!anyLattice || *distance > (1.0 + epsilon) * *lowerBound) {
+        // Exact strips, only as wide as the distance found so far
+        const double delta = *distance;
+        Arena arena;
+        Point* strip = NULL;
+        int count_recv = 0, count_SL = 0;
+        double mid_min = DBL_MAX, cross;
+        if (arenaInit(&arena, local_numPoints * sizeof(Point)))
+            MPI_Abort(MPI_COMM_WORLD, -2);
+        exchangeStripsMPI(local_points, local_numPoints, midpointsX, delta, 2, &arena, &strip, &count_recv, &count_SL);
+        if (count_recv > 0 && count_SL > 0)
+            mid_min = closestPairMPIStrip(strip, count_recv, count_SL, delta, CP_SOLVER_DAC);
+        MPI_Allreduce(&mid_min, &cross, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+        arenaFree(&arena);
+        // Cross pairs left out of the strips are longer than delta
+        *distance = fmin(D, cross);
+        *lowerBound = fmin(L, cross);
+    }
+    profileEnd();
+    return 0;
+}
+
+// Fixed-radius pairs of slabs in place: every rank reports the pairs of its slab and, with
+// strips (halos) of width radius exchanged as in closestPairMPISlabs, the pairs across its
+// left boundary, so every pair is found on exactly one rank. The ranks stream their pairs to
+// pairsPath.<rank>, then copy them into pairsPath at the offsets of an exclusive scan of the
+// counts. pairsPath NULL: the pairs are only counted. Every rank returns the totals.
+int radiusPairsMPI(Point local_points[], const int local_numPoints, const double midpointsX[], const double radius, const char* pairsPath, uint64_t* numPairs, uint64_t* checksum)
+{
+    int rank, size, i;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    char partPath[4096];
+    if (pairsPath != NULL)
+        snprintf(partPath, sizeof(partPath), "%s.%d", pairsPath, rank);
+    PairWriter writer;
+    int errcode = openPairWriter(&writer, (pairsPath != NULL) ? partPath : NULL, radius);
+
+    profileBegin("slab");
+    if (errcode == 0)
+        errcode = radiusPairsSorted(local_points, local_numPoints, radius, &writer);
+
+    profileBegin("strip");
+    if (size > 1) {
+        // Halos a few ulps wider than radius: the pair test decides, the boundaries only select
+        double halo = radius, largestMid = 0.0;
+        for (i = 0; i < size - 1; i++)
+            largestMid = fmax(largestMid, fabs(midpointsX[i]));
+        halo += 4.0 * DBL_EPSILON * (largestMid + radius);
+        Arena arena;
+        Point* strip = NULL;
+        int count_recv = 0, count_SL = 0;
+        if (arenaInit(&arena, local_numPoints * sizeof(Point)))
+            MPI_Abort(MPI_COMM_WORLD, -2);
+        exchangeStripsMPI(local_points, local_numPoints, midpointsX, halo, 0, &arena, &strip, &count_recv, &count_SL);
+        if (errcode == 0)
+            errcode = radiusPairsCross(strip, count_recv, strip + count_recv, count_SL, radius, &writer);
+        arenaFree(&arena);
+    }
+    if (closePairWriter(&writer))
+        errcode = -1;
+
+    // Totals, and the first pair of this rank in the merged file
+    profileBegin("write");
+    uint64_t local[2] = {writer.numPairs, writer.checksum}, total[2], firstPair = 0;
+    MPI_Allreduce(local, total, 2, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Exscan(&writer.numPairs, &firstPair, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0)
+        firstPair = 0;
+    *numPairs = total[0];
+    *checksum = total[1];
+    if (pairsPath != NULL) {
+        int headerError = 0;
+        if (rank == 0)
+            headerError = writePairHeader(pairsPath, radius, total[0]);
+        MPI_Bcast(&headerError, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (headerError == 0 && errcode == 0)
+            errcode = writePairPart(pairsPath, partPath, firstPair);
+        errcode = headerError ? headerError : errcode;
+        remove(partPath);
+    }
+    int worst;
+    MPI_Allreduce(&errcode, &worst, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    profileEnd();
+    return worst;
+}
+
+// Red-blue solve phase: both sets in slabs cut at the same midpointsX, sorted by X.
+// Each set travels along the slabs in its own strip exchange; a rank then compares the
+// received red points with its own blue left strip and the received blue with its red.
+int closestPairMPISlabsBichromatic(Point red[], const int numRed, Point blue[], const int numBlue, const double midpointsX[], const int solver, double* minDistance)
+{
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    Arena arena;
+    if (arenaInit(&arena, (numRed + numBlue + 2) * sizeof(Point)))
+        MPI_Abort(MPI_COMM_WORLD, -2);
+
+    profileBegin("slab");
+    double local_min = DBL_MAX;
+    int errcode = ((solver & CP_SOLVER_MASK) == CP_SOLVER_BF) ? closestPairBichromaticBruteForce(red, numRed, blue, numBlue, &local_min)
+                                                              : closestPairBichromaticSorted(red, numRed, blue, numBlue, &local_min);
+    if (errcode)
+        fprintf(stderr, "Solution Failed!\n");
+    profileBegin("strip");
+    MPI_Allreduce(&local_min, minDistance, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+
+    if (size > 1) {
+        const double delta = *minDistance;
+        Point *redStrip = NULL, *blueStrip = NULL;
+        int redRecv, redSL, blueRecv, blueSL;
+        exchangeStripsMPI(red, numRed, midpointsX, delta, 0, &arena, &redStrip, &redRecv, &redSL);
+        exchangeStripsMPI(blue, numBlue, midpointsX, delta, 1, &arena, &blueStrip, &blueRecv, &blueSL);
+
+        double mid_min = delta, cross;
+        if ((solver & CP_SOLVER_MASK) == CP_SOLVER_BF) {
+            closestPairBichromaticBruteForce(redStrip, redRecv, blueStrip + blueRecv, blueSL, &cross);
+            mid_min = (cross < mid_min) ? cross : mid_min;
+            closestPairBichromaticBruteForce(blueStrip, blueRecv, redStrip + redRecv, redSL, &cross);
+            mid_min = (cross < mid_min) ? cross : mid_min;
+        }
+        else {
+            // Points of one colour need not be delta apart: unbounded strip scans
+            if (redRecv > 0 && blueSL > 0)
+                mid_min = stripClosestSplit(redStrip, redRecv, blueStrip + blueRecv, blueSL, mid_min, 0, &arena);
+            if (blueRecv > 0 && redSL > 0)
+                mid_min = stripClosestSplit(blueStrip, blueRecv, redStrip + redRecv, redSL, mid_min, 0, &arena);
+        }
+        MPI_Allreduce(&mid_min, minDistance, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    }
+    profileEnd();
+
+    arenaFree(&arena);
+    return errcode;
+}
+
+// Batch of independent instances: each rank reads and solves a contiguous range of them,
+// of about equal cost and never splitting an instance. Rank 0 receives every distance,
+// in file order, in distances (freed by the caller); numInstances is set on every rank.
+int closestPairBatchMPI(const char* filename, const size_t bruteForceMax, double** distances, size_t* numInstances)
+{
+    int rank, size, r;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    *distances = NULL;
+
+    // Every rank reads the index and then its own points, in one read
+    profileBegin("read");
+    BatchIndex index;
+    size_t i, first = 0, last = 0, localPoints = 0;
+    Point* local = NULL;
+    uint64_t* offsets = NULL;
+    double* localDistances = NULL;
+    int errcode = readBatchIndex(filename, &index);
+    if (errcode == 0 && index.numInstances > INT_MAX) {
+        fprintf(stderr, "The MPI batch solver supports at most %d instances.\n", INT_MAX);
+        errcode = -3;
+    }
+    if (errcode == 0) {
+        partitionBatch(index.offsets, index.numInstances, bruteForceMax, rank, size, &first, &last);
+        localPoints = index.offsets[last] - index.offsets[first];
+        local = allocatePoints(localPoints + 1);
+        offsets = (uint64_t*) malloc((last - first + 1) * sizeof(uint64_t));
+        localDistances = (double*) malloc((last - first + 1) * sizeof(double));
+        if (rank == 0)
+            *distances = (double*) malloc((index.numInstances + 1) * sizeof(double));
+        if (local == NULL || offsets == NULL || localDistances == NULL || (rank == 0 && *distances == NULL)) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            errcode = -2;
+        }
+    }
+    if (errcode == 0)
+        errcode = readBatchInstances(filename, &index, first, last, local);
+    if (errcode == 0) {
+        for (i = first; i <= last; i++)
+            offsets[i - first] = index.offsets[i] - index.offsets[first];
+        profileBegin("solve");
+        errcode = closestPairBatch(local, offsets, last - first, bruteForceMax, localDistances);
+    }
+    int failed = (errcode != 0), anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (anyFailed) {
+        if (failed)
+            fprintf(stderr, "The batch of rank %d failed with error code %d!\n", rank, errcode);
+        free(local); free(offsets); free(localDistances);
+        free(*distances); *distances = NULL;
+        freeBatchIndex(&index);
+        return -1;
+    }
+
+    // The ranges are known to every rank, so rank 0 computes the counts itself
+    profileBegin("gather");
+    int *counts = NULL, *displs = NULL;
+    if (rank == 0) {
+        counts = (int*) malloc(size * sizeof(int));
+        displs = (int*) malloc(size * sizeof(int));
+        if (counts == NULL || displs == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            MPI_Abort(MPI_COMM_WORLD, -2);
+        }
+        for (r = 0; r < size; r++) {
+            size_t rFirst, rLast;
+            partitionBatch(index.offsets, index.numInstances, bruteForceMax, r, size, &rFirst, &rLast);
+            counts[r] = (int)(rLast - rFirst);
+            displs[r] = (int)rFirst;
+        }
+    }
+    MPI_Gatherv(localDistances, (int)(last - first), MPI_DOUBLE, *distances, counts, displs, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    profileEnd();
+    *numInstances = index.numInstances;
+
+    free(counts); free(displs);
+    free(local); free(offsets); free(localDistances);
+    freeBatchIndex(&index);
+    return 0;
+}
+
+// Sorted compressed inputs (.cpz): every rank decodes only its own slab and the boundaries
+// come from the block table, so the rank 0 read, the sort and the scatter are skipped.
+// Returns 1 when the slabs were read, 0 when the file needs the usual path.
+int readSlabsMPI(const char* filename, Point** local_points, int* local_numPoints, double** midpointsX, size_t* numPoints)
+{
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int sorted = 0;
+    if (rank == 0)
+        sorted = isSortedCompressedFile(filename);
+    MPI_Bcast(&sorted, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!sorted)
+        return 0;
+
+    *midpointsX = (double*) malloc(size * sizeof(double));
+    int errcode = (*midpointsX == NULL) ? -2 : readCompressedSlab(filename, rank, size, local_points, local_numPoints, *midpointsX);
+    int failed = (errcode != 0), anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (anyFailed) {
+        fprintf(stderr, "Reading the slab of rank %d failed with error code %d!\n", rank, errcode);
+        free(*midpointsX); *midpointsX = NULL;
+        free(*local_points); *local_points = NULL;
+        return -3;
+    }
+    unsigned long count = (unsigned long)*local_numPoints, total;
+    MPI_Allreduce(&count, &total, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+    *numPoints = total;
+    return 1;
+}
+
+// Checkpoint of the decomposition: one sorted .cpz slab per rank plus a manifest with the
+// rank count, the point count and the slab boundaries (shortest round-trip decimals)
+static void checkpointPath(char* path, const size_t pathSize, const char* directory, const int rank)
+{
+    if (rank < 0)
+        snprintf(path, pathSize, "%s/manifest.txt", directory);
+    else
+        snprintf(path, pathSize, "%s/slab-%d.cpz", directory, rank);
+}
+
+int writeCheckpointMPI(const char* directory, const Point slab[], const int slabPoints, const double midpointsX[], const size_t numPoints)
+{
+    int rank, size, i;
+    char path[4096];
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int errcode = 0;
+    if (rank == 0 && mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Failed to create checkpoint directory %s.\n", directory);
+        errcode = -1;
+    }
+    MPI_Bcast(&errcode, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (errcode)
+        return errcode;
+
+    double minX = (slabPoints > 0) ? slab[0].x : 0.0, maxX = (slabPoints > 0) ? slab[slabPoints - 1].x : 0.0;
+    double minY = DBL_MAX, maxY = -DBL_MAX;
+    for (i = 0; i < slabPoints; i++) {
+        if (slab[i].y < minY) minY = slab[i].y;
+        if (slab[i].y > maxY) maxY = slab[i].y;
+    }
+    checkpointPath(path, sizeof(path), directory, rank);
+    errcode = writePointsCompressed(path, slab, slabPoints, minX, maxX, minY, maxY, 2, CP_CPZ_SORTED_X);
+
+    // The manifest goes last so that a complete manifest implies complete slabs
+    int failed = (errcode != 0), anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (anyFailed)
+        return -1;
+    if (rank == 0) {
+        checkpointPath(path, sizeof(path), directory, -1);
+        FILE* file = fopen(path, "w");
+        if (file != NULL) {
+            char number[CP_TEXT_NUMBER_SIZE];
+            fprintf(file, "CPCK 1\n%d %zu\n", size, numPoints);
+            for (i = 0; i < size - 1; i++) {
+                formatDouble(midpointsX[i], number);
+                fprintf(file, "%s\n", number);
+            }
+        }
+        errcode = (file == NULL || fclose(file) != 0) ? -1 : 0;
+        if (errcode)
+            fprintf(stderr, "Failed to write %s.\n", path);
+    }
+    MPI_Bcast(&errcode, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return errcode;
+}
+
+// Restores the slabs written by writeCheckpointMPI; the rank count must match the checkpoint
+int readCheckpointMPI(const char* directory, Point** slab, int* slabPoints, double** midpointsX, size_t* numPoints)
+{
+    int rank, size, i;
+    char path[4096];
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    *midpointsX = (double*) malloc(size * sizeof(double));
+    unsigned long total = 0;
+    int errcode = (*midpointsX == NULL) ? -2 : 0;
+    if (rank == 0 && errcode == 0) {
+        const char* data;
+        size_t dataSize;
+        int version = 0, ranks = 0, used = 0;
+        checkpointPath(path, sizeof(path), directory, -1);
+        errcode = mapTextFile(path, &data, &dataSize);
+        if (errcode == 0 && dataSize == 0) {
+            fprintf(stderr, "%s is not a checkpoint manifest.\n", path);
+            errcode = -3;
+        }
+        if (errcode == 0) {
+            // The mapping is not NUL-terminated: the header lines are scanned from a copy
+            char header[128];
+            const size_t headerSize = (dataSize < sizeof(header) - 1) ? dataSize : sizeof(header) - 1;
+            memcpy(header, data, headerSize);
+            header[headerSize] = '\0';
+            const char* p = data;
+            const char* end = data + dataSize;
+            if (sscanf(header, "CPCK %d\n%d %lu\n%n", &version, &ranks, &total, &used) < 3 || version != 1 || used == 0) {
+                fprintf(stderr, "%s is not a checkpoint manifest.\n", path);
+                errcode = -3;
+            }
+            else if (ranks != size) {
+                fprintf(stderr, "Checkpoint was written by %d ranks, restarted with %d.\n", ranks, size);
+                errcode = -4;
+            }
+            for (p += used, i = 0; errcode == 0 && i < size - 1; i++) {
+                p = parseDouble(p, end, &(*midpointsX)[i]);
+                if (p == NULL || p >= end || *p != '\n') {
+                    fprintf(stderr, "Truncated checkpoint manifest %s.\n", path);
+                    errcode = -3;
+                    break;
+                }
+                p++;
+            }
+            unmapTextFile(data, dataSize);
+        }
+    }
+    MPI_Bcast(&errcode, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (errcode) {
+        free(*midpointsX); *midpointsX = NULL;
+        return errcode;
+    }
+    MPI_Bcast(*midpointsX, size - 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&total, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    *numPoints = total;
+
+    size_t count;
+    double minX, maxX, minY, maxY;
+    int dimension;
+    checkpointPath(path, sizeof(path), directory, rank);
+    errcode = readPointsFromFile(path, slab, &count, &minX, &maxX, &minY, &maxY, &dimension);
+    *slabPoints = (int)count;
+    int failed = (errcode != 0), anyFailed;
+    MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (anyFailed) {
+        if (failed)
+            fprintf(stderr, "Reading checkpoint slab %s failed with error code %d!\n", path, errcode);
+        free(*slab); *slab = NULL;
+        free(*midpointsX); *midpointsX = NULL;
+        return -3;
+    }
+    return 0;
+}
+
+// --profile: the phases of every rank gathered on rank 0, which prints them and appends
+// them to the result file. Collective, a no-op without --profile.
+int printProfileMPI(const char* resultFilePath)
+{
+    int rank, size, r;
+    if (!profileEnabled())
+        return 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    char names[CP_PROFILE_MAX_PHASES][CP_PROFILE_NAME_SIZE];
+    double values[CP_PROFILE_MAX_PHASES * CP_PROFILE_VALUES];
+    int numPhases = profileExport(names, values);
+    int* allPhases = NULL;
+    char (*allNames)[CP_PROFILE_MAX_PHASES][CP_PROFILE_NAME_SIZE] = NULL;
+    double* allValues = NULL;
+    if (rank == 0) {
+        allPhases = (int*) malloc(size * sizeof(int));
+        allNames = malloc(size * sizeof(*allNames));
+        allValues = (double*) malloc(size * sizeof(values));
+    }
+    MPI_Gather(&numPhases, 1, MPI_INT, allPhases, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Gather(names, sizeof(names), MPI_CHAR, allNames, sizeof(names), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Gather(values, CP_PROFILE_MAX_PHASES * CP_PROFILE_VALUES, MPI_DOUBLE, allValues, CP_PROFILE_MAX_PHASES * CP_PROFILE_VALUES, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    int errcode = 0;
+    if (rank == 0) {
+        FILE* fp = fopen(resultFilePath, "a");
+        if (fp == NULL) {
+            fprintf(stderr, "Failed to open result file.\n");
+            errcode = -1;
+        }
+        for (r = 0; r < size; r++) {
+            profilePrint(stdout, r, allPhases[r], (const char (*)[CP_PROFILE_NAME_SIZE]) allNames[r], allValues + r * CP_PROFILE_MAX_PHASES * CP_PROFILE_VALUES);
+            if (fp != NULL)
+                profilePrint(fp, r, allPhases[r], (const char (*)[CP_PROFILE_NAME_SIZE]) allNames[r], allValues + r * CP_PROFILE_MAX_PHASES * CP_PROFILE_VALUES);
+        }
+        if (fp != NULL)
+            fclose(fp);
+        free(allPhases); free(allNames); free(allValues);
+    }
+    return errcode;
+}
+
+// Rank among the ranks sharing this node, and their number
+int localRankMPI(int* localRank, int* localSize)
+{
+    MPI_Comm node;
+    if (MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node) != MPI_SUCCESS) {
+        *localRank = 0;
+        *localSize = 1;
+        return -1;
+    }
+    MPI_Comm_rank(node, localRank);
+    MPI_Comm_size(node, localSize);
+    MPI_Comm_free(&node);
+    return 0;
+}
+
+// Leaf size measured or loaded once on rank 0, so that ranks sharing a node do not
+// calibrate against each other, and broadcast to all
+int configureLeafSizeMPI(const int calibrate)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    unsigned long leafSize = 0;
+    if (rank == 0 && configureLeafSize(calibrate) == 0)
+        leafSize = getLeafSize();
+    MPI_Bcast(&leafSize, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    if (leafSize == 0)
+        return -1;
+    setLeafSize(leafSize);
+    return 0;
+}
+
+// --solver names of the MPI drivers, defaultSolver when no name was given
+int parseSolverName(const char* name, const int defaultSolver)
+{
+    if (name == NULL)
+        return defaultSolver;
+    if (strcmp(name, "bf") == 0)
+        return CP_SOLVER_BF;
+    if (strcmp(name, "dac") == 0)
+        return CP_SOLVER_DAC;
+    return -1;
+}
+
+// The strip holds the points received from the left (forwarded from several ranks, so not
+// necessarily delta apart, and the Y window is left unbounded) followed by the local left strip.
+// Pairs among the received points were checked on earlier boundaries: only cross pairs count.
+double closestPairMPIStrip(Point strip[], const size_t numReceived, const size_t numLocal, const double minDistance, const int solver)
+{
+    double strip_min = DBL_MAX;
+    if ((solver & CP_SOLVER_MASK) == CP_SOLVER_BF)
+        strip_min = closestPairCrossPruned(strip, numReceived, strip + numReceived, numLocal, minDistance);
+    else
+        strip_min = stripClosestSplit(strip, numReceived, strip + numReceived, numLocal, minDistance, 0, NULL);
+    return strip_min;
+}
+
+// Command line driver shared by CP-BF-MPI and CP-DAC-MPI, which only differ in the solver
+// used when --solver is not given (CP_SOLVER_BF or CP_SOLVER_DAC).
+int driverMainMPI(int argc, char* argv[], const int defaultSolver)
+{
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    DriverOptions options;
+    int solverKind = -1;
+    if (parseDriverOptions(argc, argv, &options, CP_OPTION_FLOAT | CP_OPTION_CALIBRATE | CP_OPTION_PLACEMENT | CP_OPTION_BLUE | CP_OPTION_PROFILE |
+                                               CP_OPTION_BATCH | CP_OPTION_APPROX | CP_OPTION_THRESHOLD | CP_OPTION_RADIUS |
+                                               CP_OPTION_CHECKPOINT | CP_OPTION_SOLVER) ||
+        (options.blueFilePath != NULL && (options.singlePrecision || options.checkpointDir != NULL || options.restartDir != NULL)) ||
+        (options.batch && (options.blueFilePath != NULL || options.singlePrecision || options.checkpointDir != NULL || options.restartDir != NULL)) ||
+        (options.approx && (options.blueFilePath != NULL || options.singlePrecision || options.batch)) ||
+        (options.threshold > 0.0 && (options.blueFilePath != NULL || options.batch || options.approx)) ||
+        (options.radius > 0.0 && (options.blueFilePath != NULL || options.batch || options.approx || options.threshold > 0.0 || options.singlePrecision)) ||
+        (solverKind = parseSolverName(options.solverName, defaultSolver)) < 0) {
+        if (rank == 0) {
+            printf("Usage: %s sampleFilePath resultFilePath [options]\n", argv[0]);
+            printf("       %s --restart dir resultFilePath [options]\n", argv[0]);
+            printDriverOptions();
+            if (options.blueFilePath != NULL)
+                printf("--blue does not combine with --float, --checkpoint or --restart\n");
+            if (options.batch)
+                printf("--batch does not combine with --blue, --float, --checkpoint or --restart\n");
+            if (options.approx)
+                printf("--approx does not combine with --blue, --float or --batch\n");
+            if (options.threshold > 0.0)
+                printf("--threshold does not combine with --blue, --batch or --approx\n");
+            if (options.radius > 0.0)
+                printf("--radius does not combine with --blue, --batch, --approx, --threshold or --float\n");
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Counters of the phases below on every rank, with --profile
+    profileInit(options.profile);
+
+    // NUMA placement and pinning, ranks sharing a node split its CPUs
+    int localRank, localSize;
+    localRankMPI(&localRank, &localSize);
+    NumaCounters numaBefore;
+    if (applyPlacementOptions(&options, localRank, localSize, &numaBefore))
+        MPI_Abort(MPI_COMM_WORLD, -1);
+
+    // Rank 0 loads or measures the leaf size, every rank uses it
+    if (configureLeafSizeMPI(options.calibrate))
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    if (options.resultFilePath == NULL) {
+        MPI_Finalize();
+        return 0;
+    }
+
+    const char* sampleFilePath = options.sampleFilePath;
+    const char* resultFilePath = options.resultFilePath;
+    const int solver = solverKind | (options.singlePrecision ? CP_SOLVER_FLOAT : 0);
+    Point* points = NULL;
+    size_t numPoints;  // Number of points
+    double minDistance=DBL_MAX, lowerBound=0.0;
+    uint64_t numPairs = 0, checksum = 0;
+    clock_t start = 0, end;
+    double cpu_time_used;
+    double load_time_used = -1.0; // Read and X sort on rank 0 (wall clock), reported apart from the solve
+    // Batch Mode: whole instances spread over the ranks, one distance per instance
+    if (options.batch) {
+        double* distances = NULL;
+        size_t numInstances = 0;
+        // Batches run on all threads of every rank: wall clock
+        const double batchStart = MPI_Wtime();
+        const size_t bruteForceMax = (solverKind == CP_SOLVER_BF) ? SIZE_MAX : CP_BATCH_BRUTE_FORCE_MAX;
+        if (closestPairBatchMPI(sampleFilePath, bruteForceMax, &distances, &numInstances)) {
+            fprintf(stderr, "Solution Failed!\n");
+            MPI_Finalize();
+            return -1;
+        }
+        if (rank == 0) {
+            cpu_time_used = MPI_Wtime() - batchStart;
+            minDistance = minBatchDistance(distances, numInstances);
+            printf("Solved %lu instances, the closest pair distance is %-15.10lf\n", numInstances, minDistance);
+            printf("Solution Completed in %-10.6lf seconds!\n", cpu_time_used);
+
+            FILE *fp = fopen(resultFilePath, "w");
+            if (fp == NULL) {
+                fprintf(stderr, "Failed to open result file.\n");
+                MPI_Abort(MPI_COMM_WORLD, -1);
+            }
+            fprintf(fp, "The closest pair distance is %-15.10lf\n", minDistance);
+            printBatchResults(fp, distances, numInstances);
+            fprintf(fp, "Elapsed Time: %-15.10lf seconds\n", cpu_time_used);
+            fclose(fp);
+            printf("Results written to %s\n", resultFilePath);
+        }
+        free(distances);
+        printProfileMPI(resultFilePath);
+        profileClose();
+        if (rank == 0)
+            reportPlacement(&options, &numaBefore);
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Checkpoints and sorted compressed files are read slab by slab on every rank
+    Point* slab = NULL;
+    int slabPoints = 0;
+    double* midpointsX = NULL;
+    int slabbed;
+    profileBegin("read");
+    if (options.restartDir != NULL)
+        slabbed = (readCheckpointMPI(options.restartDir, &slab, &slabPoints, &midpointsX, &numPoints) == 0) ? 1 : -1;
+    else
+        slabbed = readSlabsMPI(sampleFilePath, &slab, &slabPoints, &midpointsX, &numPoints);
+    if (slabbed < 0)
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    if (slabbed && rank == 0)
+        printf("File read %lu Points successfully, one slab per rank!\n", numPoints);
+
+    // Rank 0 sorts inside its loader, overlapped with the read, only when it has worker threads
+    // for the sort; a rank 0 bound to one core leaves the sort to the distributed QuickPointSortMPI
+    int presorted = (rank == 0 && availableWorkers() > 1);
+    MPI_Bcast(&presorted, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    // Only rank 0 reads points from file
+    if (rank == 0 && !slabbed) {
+        printf(presorted ? "Reading and sorting the points...\n" : "Reading the points...\n");
+        double minX, maxX; // X domain limits
+        double minY, maxY; // Y domain limits
+        int dimension;
+        double loadStart = MPI_Wtime();
+        int errcode = presorted ? readPointsFromFileSortedX(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension)
+                                : readPointsFromFile(sampleFilePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            MPI_Abort(MPI_COMM_WORLD, -1);
+        }
+        if (presorted)
+            load_time_used = MPI_Wtime() - loadStart;
+        printf("File read %lu Points successfully!\n", numPoints);
+    }
+    // Red-Blue Mode: the blue points are read and sorted on rank 0 as well
+    Point *bluePoints = NULL, *blueSlab = NULL;
+    size_t numBlue = 0;
+    int blueSlabPoints = 0;
+    if (rank == 0 && options.blueFilePath != NULL) {
+        double minX, maxX, minY, maxY;
+        int dimension;
+        double loadStart = MPI_Wtime();
+        int errcode = readPointsFromFileSortedX(options.blueFilePath, &bluePoints, &numBlue, &minX, &maxX, &minY, &maxY, &dimension);
+        if (errcode) {
+            printf("Read Points From File Failed with Error Code %d!\n", errcode);
+            MPI_Abort(MPI_COMM_WORLD, -1);
+        }
+        load_time_used = fmax(load_time_used, 0.0) + MPI_Wtime() - loadStart;
+        printf("File read %lu blue Points successfully!\n", numBlue);
+    }
+
+    // Update Other Processes
+    MPI_Bcast(&numPoints, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    
+    if (rank==0)
+        start = clock();
+
+    // Sort and scatter unless the slabs are already in place
+    profileBegin("distribute");
+    if (!slabbed) {
+        midpointsX = (double*) malloc(size * sizeof(double));
+        distributeSlabsMPI(&points, numPoints, presorted, &slab, &slabPoints, midpointsX);
+    }
+    if (options.blueFilePath != NULL) {
+        // Cut at the red slab boundaries
+        MPI_Bcast(&numBlue, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+        distributeByCutsMPI(&bluePoints, numBlue, midpointsX, &blueSlab, &blueSlabPoints);
+    }
+    if (options.checkpointDir != NULL) {
+        if (writeCheckpointMPI(options.checkpointDir, slab, slabPoints, midpointsX, numPoints) == 0 && rank == 0)
+            printf("Checkpoint written to %s\n", options.checkpointDir);
+    }
+
+    // Solve Closest Point Problem [solverKind]
+    int errcode = (options.blueFilePath != NULL) ? closestPairMPISlabsBichromatic(slab, slabPoints, blueSlab, blueSlabPoints, midpointsX, solver, &minDistance)
+                : (options.radius > 0.0) ? radiusPairsMPI(slab, slabPoints, midpointsX, options.radius, options.pairsFilePath, &numPairs, &checksum)
+                : options.approx ? closestPairMPISlabsApprox(slab, slabPoints, midpointsX, options.epsilon, &minDistance, &lowerBound)
+                                 : closestPairMPISlabsThreshold(slab, slabPoints, midpointsX, solver, options.threshold, &minDistance);
+    free(slab);
+    free(blueSlab);
+    free(midpointsX);
+    if (errcode){
+        fprintf(stderr, "Solution Failed!\n");
+        MPI_Finalize();
+        return -1;
+    }
+
+    if (rank==0)
+    {
+        end = clock();
+        cpu_time_used = ((double)(end - start)) / CLOCKS_PER_SEC;
+        if (options.radius > 0.0)
+            printRadiusResult(stdout, numPairs, checksum, options.radius);
+        else
+            printf("The closest pair distance is %-15.10lf\n", minDistance);
+        if (options.approx)
+            printf("The exact distance lies in [%.10lf, %.10lf] (epsilon %g)\n", lowerBound, minDistance, options.epsilon);
+        if (options.threshold > 0.0)
+            printThresholdResult(stdout, minDistance, options.threshold);
+        if (load_time_used >= 0.0)
+            printf("Read and Sort Completed in %-10.6lf seconds!\n", load_time_used);
+        printf("Solution Completed in %-10.6lf seconds!\n", cpu_time_used);
+
+        // Open file to write the results
+        printf("Writing results...\n");
+        FILE *fp = fopen(resultFilePath, "w");
+        if (fp == NULL) {
+            fprintf(stderr, "Failed to open result file.\n");
+            MPI_Finalize();
+            return -1;
+        }
+
+        if (options.radius > 0.0)
+            printRadiusResult(fp, numPairs, checksum, options.radius);
+        else
+            fprintf(fp, "The closest pair distance is %-15.10lf\n", minDistance);
+        if (options.approx)
+            fprintf(fp, "The exact distance lies in [%.10lf, %.10lf] (epsilon %g)\n", lowerBound, minDistance, options.epsilon);
+        if (options.threshold > 0.0)
+            printThresholdResult(fp, minDistance, options.threshold);
+        if (load_time_used >= 0.0)
+            fprintf(fp, "Read and Sort Time: %-15.10lf seconds\n", load_time_used);
+        fprintf(fp, "Elapsed Time: %-15.10lf seconds\n", cpu_time_used);
+
+        fclose(fp);
+        printf("Results written to %s\n", resultFilePath);
+    }
+
+    // Counters of every rank, appended to the result file
+    printProfileMPI(resultFilePath);
+    profileClose();
+    if (rank == 0)
+        reportPlacement(&options, &numaBefore);
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef ClosestPairMPI_h
+
+#define ClosestPairMPI_h
+#include "ClosestPairUtilities.h"
+#include "ClosestPairFloat.h"
+#include "Calibration.h"
+#include "ClosestPairBichromatic.h"
+#include "ClosestPairBatch.h"
+#include "ClosestPairApprox.h"
+#include "ClosestPairPruned.h"
+#include "ClosestPairRadius.h"
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include "PointSortMPI.h"
+#include "DriverOptions.h"
+
+// Solver used inside each slab and on the strips between slabs
+#define CP_SOLVER_BF  0
+#define CP_SOLVER_DAC 1
+// Flags combined with the solver
+#define CP_SOLVER_FLOAT 0x10   // Slabs solved in single precision with a double recheck
+#define CP_SOLVER_MASK  0x0F
+#define CP_APPROX_LATTICE_MAX 4503599627370496.0  // 2^52: lattice coordinates of the approximate strips stay exact
+
+// Definition
+int closestPairMPI(Point** points, const size_t numPoints, const int solver, double* minDistance);
+int distributeSlabsMPI(Point** points, const size_t numPoints, const int presorted, Point** slab, int* slabPoints, double midpointsX[]);
+int closestPairMPISlabs(Point local_points[], const int local_numPoints, const double midpointsX[], const int solver, double* minDistance);
+int closestPairMPISlabsThreshold(Point local_points[], const int local_numPoints, const double midpointsX[], const int solver, const double threshold, double* minDistance);
+int distributeByCutsMPI(Point** points, const size_t numPoints, const double midpointsX[], Point** slab, int* slabPoints);
+int closestPairMPISlabsApprox(Point local_points[], const int local_numPoints, const double midpointsX[], const double epsilon, double* distance, double* lowerBound);
+int radiusPairsMPI(Point local_points[], const int local_numPoints, const double midpointsX[], const double radius, const char* pairsPath, uint64_t* numPairs, uint64_t* checksum);
+int closestPairMPISlabsBichromatic(Point red[], const int numRed, Point blue[], const int numBlue, const double midpointsX[], const int solver, double* minDistance);
+int closestPairBatchMPI(const char* filename, const size_t bruteForceMax, double** distances, size_t* numInstances);
+int readSlabsMPI(const char* filename, Point** local_points, int* local_numPoints, double** midpointsX, size_t* numPoints);
+int writeCheckpointMPI(const char* directory, const Point slab[], const int slabPoints, const double midpointsX[], const size_t numPoints);
+int readCheckpointMPI(const char* directory, Point** slab, int* slabPoints, double** midpointsX, size_t* numPoints);
+int printProfileMPI(const char* resultFilePath);
+int localRankMPI(int* localRank, int* localSize);
+int configureLeafSizeMPI(const int calibrate);
+int parseSolverName(const char* name, const int defaultSolver);
+int driverMainMPI(int argc, char* argv[], const int defaultSolver);
+double closestPairMPIStrip(Point strip[], const size_t numReceived, const size_t numLocal, const double minDistance, const int solver);
+
+#endif
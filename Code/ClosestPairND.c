@@ -0,0 +1,241 @@
+#define _GNU_SOURCE
+#include "ClosestPairND.h"
+
+// qsort needs the element size and the key coordinate, both fixed for one solve
+static int compareCoord0(const void *a, const void *b) {
+    double c1 = *(const double *)a, c2 = *(const double *)b;
+    return (c1 > c2) - (c1 < c2);
+}
+
+// Slabs are re-sorted on the next coordinate, which qsort_r passes in
+static int compareAxis(const void *a, const void *b, void *axis) {
+    const int k = *(const int *)axis;
+    double c1 = ((const double *)a)[k], c2 = ((const double *)b)[k];
+    return (c1 > c2) - (c1 < c2);
+}
+
+// Implementation (generated for each dimension)
+// DIM is a literal for the specialized solvers and the runtime dimension for the generic one.
+// Each call splits on coordinate axis (coords sorted on it). The slab around the split is sorted
+// on the next coordinate and swept there, or, past CP_ND_SLAB_SWEEP_MAX points, solved by the
+// same recursion on that coordinate; the last coordinate is always swept.
+#define CP_DEFINE_ND_SOLVER(SUFFIX, DIM)                                                                                      \
+                                                                                                                              \
+static inline double squaredDistanceND##SUFFIX(const double* p1, const double* p2, const int dimension) {                    \
+    double sum = 0.0, diff;                                                                                                   \
+    int k;                                                                                                                    \
+    (void)dimension;                                                                                                          \
+    for (k = 0; k < (DIM); k++) {                                                                                             \
+        diff = p1[k] - p2[k];                                                                                                 \
+        sum += diff * diff;                                                                                                   \
+    }                                                                                                                         \
+    return sum;                                                                                                               \
+}                                                                                                                             \
+                                                                                                                              \
+static double bruteForceND##SUFFIX(const double coords[], const size_t numPoints, const int dimension, double bestSq) {      \
+    size_t i, j;                                                                                                              \
+    double distance;                                                                                                          \
+    for (i = 0; i < numPoints; i++) {                                                                                         \
+        for (j = i + 1; j < numPoints; j++) {                                                                                 \
+            distance = squaredDistanceND##SUFFIX(&coords[i * (DIM)], &coords[j * (DIM)], dimension);                          \
+            if (distance < bestSq)                                                                                            \
+                bestSq = distance;                                                                                            \
+        }                                                                                                                     \
+    }                                                                                                                         \
+    return bestSq;                                                                                                            \
+}                                                                                                                             \
+                                                                                                                              \
+static double closestPairRecursiveND##SUFFIX(const double coords[], const size_t numPoints, const int dimension,             \
+                                             const int axis, double scratch[], double bestSq) {                               \
+    size_t i, j, k;                                                                                                           \
+    double distance, diff;                                                                                                    \
+    if (numPoints <= 3)                                                                                                       \
+        return bruteForceND##SUFFIX(coords, numPoints, dimension, bestSq);                                                    \
+                                                                                                                              \
+    const size_t mid = numPoints / 2;                                                                                         \
+    const double midValue = coords[mid * (DIM) + axis];                                                                       \
+    bestSq = closestPairRecursiveND##SUFFIX(coords, mid, dimension, axis, scratch, bestSq);                                   \
+    bestSq = closestPairRecursiveND##SUFFIX(coords + mid * (DIM), numPoints - mid, dimension, axis, scratch, bestSq);         \
+                                                                                                                              \
+    /* Slab of points closer than the minimum to the splitting hyperplane */                                                  \
+    for (i = 0, k = 0; i < numPoints; i++) {                                                                                  \
+        diff = coords[i * (DIM) + axis] - midValue;                                                                           \
+        if (diff * diff < bestSq) {                                                                                           \
+            memcpy(&scratch[k * (DIM)], &coords[i * (DIM)], (DIM) * sizeof(double));                                          \
+            k++;                                                                                                              \
+        }                                                                                                                     \
+    }                                                                                                                         \
+    int next = (axis + 1 < (DIM)) ? axis + 1 : axis;                                                                          \
+    if (next != axis)                                                                                                         \
+        qsort_r(scratch, k, (DIM) * sizeof(double), compareAxis, &next);                                                      \
+    if (next != axis && k > CP_ND_SLAB_SWEEP_MAX) {                                                                           \
+        /* Large slab: the same problem one coordinate further, so the sweep never degenerates */                            \
+        double* slabScratch = (double*) malloc((k + 1) * (DIM) * sizeof(double));                                             \
+        if (slabScratch != NULL) {                                                                                            \
+            bestSq = closestPairRecursiveND##SUFFIX(scratch, k, dimension, next, slabScratch, bestSq);                        \
+            free(slabScratch);                                                                                                \
+            return bestSq;                                                                                                    \
+        }                                                                                                                     \
+        /* Without memory the sweep below is slower but still exact */                                                        \
+    }                                                                                                                         \
+    for (i = 0; i < k; i++) {                                                                                                 \
+        for (j = i + 1; j < k; j++) {                                                                                         \
+            diff = scratch[j * (DIM) + next] - scratch[i * (DIM) + next];                                                     \
+            if (diff * diff >= bestSq)                                                                                        \
+                break;                                                                                                        \
+            distance = squaredDistanceND##SUFFIX(&scratch[i * (DIM)], &scratch[j * (DIM)], dimension);                        \
+            if (distance < bestSq)                                                                                            \
+                bestSq = distance;                                                                                            \
+        }                                                                                                                     \
+    }                                                                                                                         \
+    return bestSq;                                                                                                            \
+}
+
+CP_DEFINE_ND_SOLVER(1, 1)
+CP_DEFINE_ND_SOLVER(2, 2)
+CP_DEFINE_ND_SOLVER(3, 3)
+CP_DEFINE_ND_SOLVER(4, 4)
+CP_DEFINE_ND_SOLVER(5, 5)
+CP_DEFINE_ND_SOLVER(6, 6)
+CP_DEFINE_ND_SOLVER(7, 7)
+CP_DEFINE_ND_SOLVER(8, 8)
+CP_DEFINE_ND_SOLVER(Generic, dimension)
+
+typedef double (*NDBruteForce)(const double[], const size_t, const int, double);
+typedef double (*NDRecursive)(const double[], const size_t, const int, const int, double[], double);
+
+static const NDBruteForce bruteForceSolvers[CP_ND_MAX_SPECIALIZED + 1] = {
+    NULL, bruteForceND1, bruteForceND2, bruteForceND3, bruteForceND4,
+    bruteForceND5, bruteForceND6, bruteForceND7, bruteForceND8
+};
+static const NDRecursive recursiveSolvers[CP_ND_MAX_SPECIALIZED + 1] = {
+    NULL, closestPairRecursiveND1, closestPairRecursiveND2, closestPairRecursiveND3, closestPairRecursiveND4,
+    closestPairRecursiveND5, closestPairRecursiveND6, closestPairRecursiveND7, closestPairRecursiveND8
+};
+
+double calculateDistanceND(const double* p1, const double* p2, const int dimension)
+{
+    return sqrt(squaredDistanceNDGeneric(p1, p2, dimension));
+}
+
+int closestPairBruteForceND(const double coords[], const size_t numPoints, const int dimension, double* minDistance)
+{
+    if (dimension <= 0)
+        return -1;
+    NDBruteForce solver = (dimension <= CP_ND_MAX_SPECIALIZED) ? bruteForceSolvers[dimension] : bruteForceNDGeneric;
+    double bestSq = solver(coords, numPoints, dimension, DBL_MAX);
+    *minDistance = (bestSq == DBL_MAX) ? DBL_MAX : sqrt(bestSq);
+    return 0;
+}
+
+int closestPairDACND(double coords[], const size_t numPoints, const int dimension, double* minDistance)
+{
+    if (dimension <= 0)
+        return -1;
+    double* scratch = (double*) malloc((numPoints + 1) * dimension * sizeof(double));
+    if (scratch == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    qsort(coords, numPoints, dimension * sizeof(double), compareCoord0);
+    NDRecursive solver = (dimension <= CP_ND_MAX_SPECIALIZED) ? recursiveSolvers[dimension] : closestPairRecursiveNDGeneric;
+    double bestSq = solver(coords, numPoints, dimension, 0, scratch, DBL_MAX);
+    *minDistance = (bestSq == DBL_MAX) ? DBL_MAX : sqrt(bestSq);
+    free(scratch);
+    return 0;
+}
+
+int readPointsFromFileND(const char* filename, double** coords, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimension) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+
+    // Read the header information
+    if (fscanf(file, "%ld", numPoints) != 1 ||
+        fscanf(file, "%lf %lf %lf %lf", minX, maxX, minY, maxY) != 4 ||
+        fscanf(file, "%d", dimension) != 1 || *dimension <= 0) {
+        fprintf(stderr, "Failed to read the file header.\n");
+        fclose(file);
+        return -3;
+    }
+    // Skip the optional sorted-x flag; no coordinate starts with its first letter
+    if (fscanf(file, " " CP_TEXT_SORTED_X_TAG) == EOF && ferror(file)) {
+        fprintf(stderr, "Failed to read the file header.\n");
+        fclose(file);
+        return -3;
+    }
+
+    *coords = (double*) malloc((*numPoints) * (*dimension) * sizeof(double));
+    if (*coords == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        fclose(file);
+        return -2;
+    }
+
+    // Read points data
+    size_t i;
+    int k;
+    for (i = 0; i < *numPoints; i++)
+    {
+        for (k = 0; k < *dimension; k++)
+        {
+            if (fscanf(file, "%lf", &((*coords)[i * (*dimension) + k])) != 1)
+            {
+                fprintf(stderr, "Failed to read coordinate %d of point %ld.\n", k, i);
+                free(*coords); *coords = NULL;
+                fclose(file);
+                return -3; // Error code for reading failure
+            }
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+int writePointsToFileND(const char* filename, const double coords[], const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const int dimension) {
+
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+
+    // Write header information
+    fprintf(file, "%ld\n", numPoints);
+    fprintf(file, "%f %f %f %f\n", minX, maxX, minY, maxY);
+    fprintf(file, "%d\n", dimension); // Number of dimensions
+
+    // Write points
+    size_t i;
+    int k;
+    for (i = 0; i < numPoints; i++) {
+        for (k = 0; k < dimension; k++)
+            fprintf(file, (k + 1 < dimension) ? "%.17g " : "%.17g\n", coords[i * dimension + k]);
+    }
+
+    fclose(file);
+    return 0;
+}
+
+int generateRandomPointsND(double** coords, const size_t numPoints, const int dimension, const double minX, const double maxX, const double minY, const double maxY) {
+
+    *coords = (double*) malloc(numPoints * dimension * sizeof(double));
+    if (*coords == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -1;
+    }
+
+    // Coordinate 0 spans the X domain, all others the Y domain
+    size_t i;
+    int k;
+    for (i = 0; i < numPoints; i++) {
+        (*coords)[i * dimension] = minX + (double)rand() / RAND_MAX * (maxX - minX);
+        for (k = 1; k < dimension; k++)
+            (*coords)[i * dimension + k] = minY + (double)rand() / RAND_MAX * (maxY - minY);
+    }
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef ClosestPairND_h
+
+#define ClosestPairND_h
+#include "ClosestPairUtilities.h"
+
+// d-dimensional points stored flat: point i is coords[i*dimension .. i*dimension + dimension).
+// The solvers are generated for every dimension up to CP_ND_MAX_SPECIALIZED with the
+// distance kernel unrolled at compile time; larger dimensions use the generic version.
+// The header of the .dat file carries X bounds for coordinate 0 and Y bounds for the others.
+#define CP_ND_MAX_SPECIALIZED 8
+#define CP_ND_SLAB_SWEEP_MAX 32   // Larger slabs recurse on the next coordinate instead of a sweep
+
+// Definition
+int readPointsFromFileND(const char* filename, double** coords, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimension);
+int writePointsToFileND(const char* filename, const double coords[], const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const int dimension);
+int generateRandomPointsND(double** coords, const size_t numPoints, const int dimension, const double minX, const double maxX, const double minY, const double maxY);
+double calculateDistanceND(const double* p1, const double* p2, const int dimension);
+int closestPairBruteForceND(const double coords[], const size_t numPoints, const int dimension, double* minDistance);
+int closestPairDACND(double coords[], const size_t numPoints, const int dimension, double* minDistance);
+
+#endif
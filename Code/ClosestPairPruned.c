@@ -0,0 +1,65 @@
+#include "ClosestPairPruned.h"
+
+// Pairs among points[0], points[stride], ... closer than sqrt(bestSq); returns the smallest
+// squared distance, or the first one below thresholdSq
+static double prunedPass(const Point points[], const size_t numPoints, const size_t stride, double bestSq, const double thresholdSq)
+{
+    size_t i, j;
+    for (i = 0; i < numPoints && bestSq >= thresholdSq; i += stride) {
+        const double x = points[i].x, y = points[i].y;
+        for (j = i + stride; j < numPoints; j += stride) {
+            const double dx = points[j].x - x, dy = points[j].y - y;
+            if (dx * dx >= bestSq)
+                break;
+            const double distanceSq = dx * dx + dy * dy;
+            bestSq = (distanceSq < bestSq) ? distanceSq : bestSq;
+        }
+    }
+    return bestSq;
+}
+
+int closestPairBruteForcePruned(const Point points[], const size_t numPoints, const double threshold, double* minDistance)
+{
+    *minDistance = DBL_MAX;
+    if (numPoints <= 1)
+        return 0;
+
+    // Seed from the sample, then every point against its neighbours within the seed in X
+    const double thresholdSq = threshold * threshold;
+    const size_t sample = CP_PRUNED_SAMPLE_FACTOR * (size_t)ceil(sqrt((double)numPoints));
+    const size_t stride = (numPoints > sample) ? numPoints / sample : 1;
+    double bestSq = DBL_MAX;
+    if (stride > 1)
+        bestSq = prunedPass(points, numPoints, stride, bestSq, thresholdSq);
+    bestSq = prunedPass(points, numPoints, 1, bestSq, thresholdSq);
+    *minDistance = sqrt(bestSq);
+    return 0;
+}
+
+// Pairs of one left and one right point closer than delta, for a right array sorted by X and
+// left points no further right than any right point; returns delta when there are none
+double closestPairCrossPruned(const Point left[], const size_t numLeft, const Point right[], const size_t numRight, const double delta)
+{
+    double bestSq = delta * delta;
+    size_t i, j;
+    for (i = 0; i < numLeft; i++) {
+        const double x = left[i].x, y = left[i].y;
+        for (j = 0; j < numRight; j++) {
+            const double dx = right[j].x - x, dy = right[j].y - y;
+            if (dx * dx >= bestSq)
+                break;
+            const double distanceSq = dx * dx + dy * dy;
+            bestSq = (distanceSq < bestSq) ? distanceSq : bestSq;
+        }
+    }
+    return (bestSq < delta * delta) ? sqrt(bestSq) : delta;
+}
+
+// Answer of a --threshold run; distance is then only the closest pair distance when no pair is closer
+void printThresholdResult(FILE* fp, const double distance, const double threshold)
+{
+    if (distance < threshold)
+        fprintf(fp, "A pair closer than %g exists\n", threshold);
+    else
+        fprintf(fp, "No pair is closer than %g\n", threshold);
+}
@@ -0,0 +1,20 @@
+#ifndef ClosestPairPruned_h
+
+#define ClosestPairPruned_h
+#include "ClosestPairUtilities.h"
+
+// Brute force on points sorted by X, pruned by the best distance found so far: the inner
+// loop over the right neighbours of a point stops at the first one delta or more away in X.
+//  - delta is seeded by a pass over a strided sample of CP_PRUNED_SAMPLE_FACTOR sqrt(n)
+//    points, whose closest pair is a real pair of the input.
+//  - With threshold > 0 the search stops at the first pair closer than threshold, which then
+//    answers "is any pair closer than threshold?" without the full minimum. Otherwise (and
+//    whenever no such pair exists) minDistance is the exact closest pair distance.
+#define CP_PRUNED_SAMPLE_FACTOR 2
+
+// Definition
+int closestPairBruteForcePruned(const Point points[], const size_t numPoints, const double threshold, double* minDistance);
+double closestPairCrossPruned(const Point left[], const size_t numLeft, const Point right[], const size_t numRight, const double delta);
+void printThresholdResult(FILE* fp, const double distance, const double threshold);
+
+#endif
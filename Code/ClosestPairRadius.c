@@ -0,0 +1,85 @@
+#include "ClosestPairRadius.h"
+
+static inline void testPair(const Point* p, const Point* q, const double radius, PairWriter* writer)
+{
+    const double dx = p->x - q->x, dy = p->y - q->y;
+    if (sqrt(dx * dx + dy * dy) < radius)
+        writePair(writer, p, q);
+}
+
+// Pairs of one column, sorted by Y
+static void scanWithin(const Point column[], const size_t count, const double radius, PairWriter* writer)
+{
+    size_t i, j;
+    for (i = 0; i < count; i++)
+        for (j = i + 1; j < count && column[j].y - column[i].y < radius; j++)
+            testPair(&column[i], &column[j], radius, writer);
+}
+
+// Pairs of one point of a and one of b, both sorted by Y; low only moves up as a does
+static void scanCross(const Point a[], const size_t countA, const Point b[], const size_t countB, const double radius, PairWriter* writer)
+{
+    size_t i, j, low = 0;
+    for (i = 0; i < countA; i++) {
+        while (low < countB && a[i].y - b[low].y >= radius)
+            low++;
+        for (j = low; j < countB && b[j].y - a[i].y < radius; j++)
+            testPair(&a[i], &b[j], radius, writer);
+    }
+}
+
+int radiusPairsBruteForce(const Point points[], const size_t numPoints, const double radius, PairWriter* writer)
+{
+    size_t i, j;
+    for (i = 0; i < numPoints; i++)
+        for (j = i + 1; j < numPoints; j++)
+            if (calculateDistance(&points[i], &points[j]) < radius)
+                writePair(writer, &points[i], &points[j]);
+    return 0;
+}
+
+int radiusPairsSorted(const Point points[], const size_t numPoints, const double radius, PairWriter* writer)
+{
+    if (numPoints < 2)
+        return 0;
+    Point* columns = allocatePoints(numPoints);
+    if (columns == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    memcpy(columns, points, numPoints * sizeof(Point));
+
+    // The X differences decide the columns, like they decide the pairs: a point two columns
+    // away is radius or more away in X from every point of this one
+    size_t start = 0, previous = 0, previousCount = 0;
+    while (start < numPoints) {
+        size_t end = start + 1;
+        while (end < numPoints && columns[end].x - columns[start].x < radius)
+            end++;
+        NaturalPointSort(columns + start, end - start, 0);
+        scanWithin(columns + start, end - start, radius, writer);
+        if (previousCount > 0)
+            scanCross(columns + previous, previousCount, columns + start, end - start, radius, writer);
+        previous = start;
+        previousCount = end - start;
+        start = end;
+    }
+    free(columns);
+    return 0;
+}
+
+// Pairs of a left and a right point only; both arrays are sorted by Y in place
+int radiusPairsCross(Point left[], const size_t numLeft, Point right[], const size_t numRight, const double radius, PairWriter* writer)
+{
+    if (numLeft == 0 || numRight == 0)
+        return 0;
+    NaturalPointSort(left, numLeft, 0);
+    NaturalPointSort(right, numRight, 0);
+    scanCross(left, numLeft, right, numRight, radius, writer);
+    return 0;
+}
+
+void printRadiusResult(FILE* fp, const uint64_t numPairs, const uint64_t checksum, const double radius)
+{
+    fprintf(fp, "Pairs closer than %g: %lu (checksum %016llx)\n", radius, (unsigned long)numPairs, (unsigned long long)checksum);
+}
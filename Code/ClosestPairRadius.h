@@ -0,0 +1,23 @@
+#ifndef ClosestPairRadius_h
+
+#define ClosestPairRadius_h
+#include "ClosestPairUtilities.h"
+#include "PointPairIO.h"
+
+// Fixed-radius pairs: every pair closer than radius, in time linear in the points plus the
+// pairs found (after the sort).
+//  - Points sorted by X are cut into columns: a column starts at the first point radius or
+//    more right of the previous column's first point, so a pair closer than radius lies in
+//    one column or in two neighbouring ones.
+//  - Every column is sorted by Y and scanned in rows of height radius, so each point is only
+//    compared with the few cells of side radius around it: a comparison that does not
+//    report a pair is paid for by the points of its own cell.
+//  - A pair counts when its distance, computed like calculateDistance, is below radius.
+
+// Definition
+int radiusPairsBruteForce(const Point points[], const size_t numPoints, const double radius, PairWriter* writer);
+int radiusPairsSorted(const Point points[], const size_t numPoints, const double radius, PairWriter* writer);
+int radiusPairsCross(Point left[], const size_t numLeft, Point right[], const size_t numRight, const double radius, PairWriter* writer);
+void printRadiusResult(FILE* fp, const uint64_t numPairs, const uint64_t checksum, const double radius);
+
+#endif
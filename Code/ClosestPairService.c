@@ -0,0 +1,355 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ClosestPairService.h"
+
+typedef struct {
+    double distance;
+    size_t a, b;
+} ServicePair;
+
+int hashFileFNV1a(const char* filename, uint64_t* hash)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    *hash = 14695981039346656037ULL;
+    if (st.st_size > 0) {
+        const unsigned char* data = (const unsigned char*) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -2;
+        }
+        off_t i;
+        for (i = 0; i < st.st_size; i++) {
+            *hash ^= data[i];
+            *hash *= 1099511628211ULL;
+        }
+        munmap((void*) data, st.st_size);
+    }
+    close(fd);
+    return 0;
+}
+
+static void freeDataset(ServiceDataset* set)
+{
+    free(set->points);
+    free(set->sortedX);
+    if (set->hasTree)
+        kdTreeFree(&set->tree);
+    memset(set, 0, sizeof(ServiceDataset));
+}
+
+void serviceInit(ClosestPairService* service)
+{
+    memset(service, 0, sizeof(ClosestPairService));
+}
+
+void serviceFree(ClosestPairService* service)
+{
+    int i;
+    for (i = 0; i < CP_SERVICE_CACHE_SIZE; i++)
+        freeDataset(&service->datasets[i]);
+}
+
+static void rememberFile(ServiceDataset* set, const char* path, const struct stat* st)
+{
+    snprintf(set->path, sizeof(set->path), "%s", path);
+    set->size = st->st_size;
+    set->mtime = st->st_mtim;
+}
+
+// Cached point set of a file: unchanged paths skip hashing, renamed or copied files hit by hash
+static ServiceDataset* findDataset(ClosestPairService* service, const char* path, int* hit, char* response, const size_t responseSize)
+{
+    struct stat st;
+    int i, slot = 0;
+    if (strlen(path) >= CP_SERVICE_PATH_SIZE || stat(path, &st) != 0) {
+        snprintf(response, responseSize, "ERR cannot open %s", path);
+        return NULL;
+    }
+
+    ServiceDataset* datasets = service->datasets;
+    for (i = 0; i < CP_SERVICE_CACHE_SIZE; i++) {
+        if (datasets[i].points != NULL && strcmp(datasets[i].path, path) == 0 && datasets[i].size == st.st_size &&
+            datasets[i].mtime.tv_sec == st.st_mtim.tv_sec && datasets[i].mtime.tv_nsec == st.st_mtim.tv_nsec) {
+            *hit = 1;
+            datasets[i].lastUsed = ++service->clock;
+            return &datasets[i];
+        }
+    }
+
+    uint64_t hash;
+    if (hashFileFNV1a(path, &hash)) {
+        snprintf(response, responseSize, "ERR cannot read %s", path);
+        return NULL;
+    }
+    for (i = 0; i < CP_SERVICE_CACHE_SIZE; i++) {
+        if (datasets[i].points != NULL && datasets[i].hash == hash) {
+            *hit = 1;
+            rememberFile(&datasets[i], path, &st);
+            datasets[i].lastUsed = ++service->clock;
+            return &datasets[i];
+        }
+    }
+
+    // Miss: parse into a free slot or the least recently used one
+    for (i = 0; i < CP_SERVICE_CACHE_SIZE; i++) {
+        if (datasets[i].points == NULL) {
+            slot = i;
+            break;
+        }
+        if (datasets[i].lastUsed < datasets[slot].lastUsed)
+            slot = i;
+    }
+    ServiceDataset* set = &datasets[slot];
+    freeDataset(set);
+    double minX, maxX, minY, maxY;
+    int dimension;
+    int errcode = readPointsFromFile(path, &set->points, &set->numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+    if (errcode) {
+        set->points = NULL;
+        snprintf(response, responseSize, "ERR reading %s failed with error code %d", path, errcode);
+        return NULL;
+    }
+    *hit = 0;
+    rememberFile(set, path, &st);
+    set->hash = hash;
+    set->lastUsed = ++service->clock;
+    return set;
+}
+
+static int ensureTree(ServiceDataset* set)
+{
+    if (!set->hasTree) {
+        if (kdTreeBuild(&set->tree, set->points, set->numPoints))
+            return -2;
+        set->hasTree = 1;
+    }
+    return 0;
+}
+
+static int ensureSortedX(ServiceDataset* set)
+{
+    if (set->sortedX == NULL) {
+        set->sortedX = allocatePoints(set->numPoints + 1);
+        if (set->sortedX == NULL)
+            return -2;
+        memcpy(set->sortedX, set->points, set->numPoints * sizeof(Point));
+        NaturalPointSort(set->sortedX, set->numPoints, 1);
+    }
+    return 0;
+}
+
+static void siftDownPair(ServicePair heap[], const size_t count, size_t i)
+{
+    size_t child;
+    ServicePair entry = heap[i];
+    for (; (child = 2 * i + 1) < count; i = child) {
+        if (child + 1 < count && heap[child + 1].distance > heap[child].distance)
+            child++;
+        if (heap[child].distance <= entry.distance)
+            break;
+        heap[i] = heap[child];
+    }
+    heap[i] = entry;
+}
+
+static int comparePairs(const void *a, const void *b)
+{
+    const ServicePair *p1 = (const ServicePair *)a, *p2 = (const ServicePair *)b;
+    return (p1->distance > p2->distance) - (p1->distance < p2->distance);
+}
+
+// The k closest pairs are among the k nearest neighbours of their endpoints,
+// every pair is taken once, from its endpoint with the smaller index
+static int closestPairsK(const KDTree* tree, const size_t k, ServicePair pairs[], size_t* count)
+{
+    size_t* neighbours = (size_t*) malloc((k + 1) * sizeof(size_t));
+    double* distances = (double*) malloc((k + 1) * sizeof(double));
+    if (neighbours == NULL || distances == NULL) {
+        free(neighbours); free(distances);
+        return -2;
+    }
+
+    size_t i, m, found, size = 0;
+    for (i = 0; i < tree->numPoints; i++) {
+        const size_t self = tree->index[i];
+        kdTreeKNearest(tree, &tree->points[i], k + 1, neighbours, distances, &found);
+        for (m = 0; m < found; m++) {
+            if (neighbours[m] <= self)
+                continue;
+            if (size == k && distances[m] >= pairs[0].distance)
+                break;
+            ServicePair pair = {distances[m], self, neighbours[m]};
+            if (size < k) {
+                // Sift up
+                size_t j = size++, parent;
+                for (; j > 0 && pairs[(parent = (j - 1) / 2)].distance < pair.distance; j = parent)
+                    pairs[j] = pairs[parent];
+                pairs[j] = pair;
+            } else {
+                pairs[0] = pair;
+                siftDownPair(pairs, size, 0);
+            }
+        }
+    }
+    qsort(pairs, size, sizeof(ServicePair), comparePairs);
+    *count = size;
+    free(neighbours);
+    free(distances);
+    return 0;
+}
+
+static int latencyPercentile(const ClosestPairService* service, const double fraction)
+{
+    uint64_t seen = 0;
+    int b;
+    for (b = 0; b < CP_SERVICE_LATENCY_BUCKETS; b++) {
+        seen += service->latency[b];
+        if (seen > 0 && (double)seen >= fraction * (double)service->requests)
+            return b;
+    }
+    return CP_SERVICE_LATENCY_BUCKETS - 1;
+}
+
+static int dispatchRequest(ClosestPairService* service, char* line, char* response, const size_t responseSize)
+{
+    char* save = NULL;
+    char* command = strtok_r(line, " \t\r\n", &save);
+    char* path = command ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    char* arg1 = path ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    char* arg2 = arg1 ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    char* end;
+    int hit;
+
+    if (command == NULL) {
+        snprintf(response, responseSize, "ERR empty request");
+        return CP_SERVICE_CONTINUE;
+    }
+    if (strcmp(command, "QUIT") == 0) {
+        snprintf(response, responseSize, "OK bye");
+        return CP_SERVICE_CLOSE;
+    }
+    if (strcmp(command, "SHUTDOWN") == 0) {
+        snprintf(response, responseSize, "OK shutting down");
+        return CP_SERVICE_SHUTDOWN;
+    }
+    if (strcmp(command, "STATS") == 0) {
+        int i, datasets = 0;
+        for (i = 0; i < CP_SERVICE_CACHE_SIZE; i++)
+            datasets += (service->datasets[i].points != NULL);
+        snprintf(response, responseSize,
+                 "OK requests=%llu errors=%llu hits=%llu misses=%llu datasets=%d mean_us=%.1f p50_us=%llu p99_us=%llu max_us=%.1f",
+                 (unsigned long long)service->requests, (unsigned long long)service->errors,
+                 (unsigned long long)service->hits, (unsigned long long)service->misses, datasets,
+                 service->requests ? service->totalLatency / service->requests : 0.0,
+                 1ULL << latencyPercentile(service, 0.50), 1ULL << latencyPercentile(service, 0.99), service->maxLatency);
+        return CP_SERVICE_CONTINUE;
+    }
+    if (strcmp(command, "LOAD") != 0 && strcmp(command, "CLOSEST") != 0 &&
+        strcmp(command, "KPAIRS") != 0 && strcmp(command, "NEAREST") != 0) {
+        snprintf(response, responseSize, "ERR unknown command %s", command);
+        return CP_SERVICE_CONTINUE;
+    }
+    if (path == NULL) {
+        snprintf(response, responseSize, "ERR %s needs a file path", command);
+        return CP_SERVICE_CONTINUE;
+    }
+
+    ServiceDataset* set = findDataset(service, path, &hit, response, responseSize);
+    if (set == NULL)
+        return CP_SERVICE_CONTINUE;
+    if (hit) service->hits++; else service->misses++;
+
+    if (strcmp(command, "LOAD") == 0) {
+        snprintf(response, responseSize, "OK %016llx %zu %s", (unsigned long long)set->hash, set->numPoints, hit ? "hit" : "miss");
+    }
+    else if (strcmp(command, "CLOSEST") == 0) {
+        double minDistance;
+        size_t index1 = 0, index2 = 0;
+        if (arg1 != NULL && strcmp(arg1, "DAC") == 0) {
+            if (ensureSortedX(set)) {
+                snprintf(response, responseSize, "ERR out of memory");
+                return CP_SERVICE_CONTINUE;
+            }
+            minDistance = (set->numPoints < 2) ? DBL_MAX : closestPairRecursive(set->sortedX, set->numPoints);
+            snprintf(response, responseSize, "OK %.17g", minDistance);
+            return CP_SERVICE_CONTINUE;
+        }
+        if (ensureTree(set)) {
+            snprintf(response, responseSize, "ERR out of memory");
+            return CP_SERVICE_CONTINUE;
+        }
+        kdTreeClosestPair(&set->tree, &minDistance, &index1, &index2);
+        snprintf(response, responseSize, "OK %.17g %zu %zu", minDistance, index1, index2);
+    }
+    else if (strcmp(command, "NEAREST") == 0) {
+        Point query;
+        size_t index;
+        double distance;
+        query.x = arg1 ? strtod(arg1, &end) : 0.0;
+        if (arg1 == NULL || *end != '\0' || arg2 == NULL || (query.y = strtod(arg2, &end), *end != '\0')) {
+            snprintf(response, responseSize, "ERR NEAREST needs x and y");
+            return CP_SERVICE_CONTINUE;
+        }
+        if (ensureTree(set)) {
+            snprintf(response, responseSize, "ERR out of memory");
+            return CP_SERVICE_CONTINUE;
+        }
+        if (kdTreeNearest(&set->tree, &query, &index, &distance)) {
+            snprintf(response, responseSize, "ERR empty point set");
+            return CP_SERVICE_CONTINUE;
+        }
+        snprintf(response, responseSize, "OK %zu %.17g", index, distance);
+    }
+    else {
+        size_t k = arg1 ? strtoul(arg1, &end, 10) : 0, count, i;
+        if (arg1 == NULL || *end != '\0' || k == 0 || k > CP_SERVICE_MAX_K) {
+            snprintf(response, responseSize, "ERR KPAIRS needs 1 <= k <= %d", CP_SERVICE_MAX_K);
+            return CP_SERVICE_CONTINUE;
+        }
+        ServicePair* pairs = (ServicePair*) malloc(k * sizeof(ServicePair));
+        if (pairs == NULL || ensureTree(set) || closestPairsK(&set->tree, k, pairs, &count)) {
+            free(pairs);
+            snprintf(response, responseSize, "ERR out of memory");
+            return CP_SERVICE_CONTINUE;
+        }
+        size_t used = snprintf(response, responseSize, "OK %zu", count);
+        for (i = 0; i < count && used < responseSize; i++)
+            used += snprintf(response + used, responseSize - used, " %.17g %zu %zu", pairs[i].distance, pairs[i].a, pairs[i].b);
+        free(pairs);
+        // A cut pair list would read as fewer, wrong pairs: report it instead
+        if (used >= responseSize)
+            snprintf(response, responseSize, "ERR KPAIRS response exceeds %zu bytes", responseSize);
+    }
+    return CP_SERVICE_CONTINUE;
+}
+
+// Handles one request line and records its latency
+int serviceHandleRequest(ClosestPairService* service, char* line, char* response, const size_t responseSize)
+{
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int result = dispatchRequest(service, line, response, responseSize);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double micros = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) * 1e-3;
+    int bucket = 0;
+    while (bucket < CP_SERVICE_LATENCY_BUCKETS - 1 && (double)(1ULL << bucket) < micros)
+        bucket++;
+    service->requests++;
+    service->errors += (strncmp(response, "ERR", 3) == 0);
+    service->latency[bucket]++;
+    service->totalLatency += micros;
+    if (micros > service->maxLatency)
+        service->maxLatency = micros;
+    return result;
+}
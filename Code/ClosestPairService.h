@@ -0,0 +1,60 @@
+#ifndef ClosestPairService_h
+
+#define ClosestPairService_h
+#include <stdint.h>
+#include <sys/types.h>
+#include "ClosestPairUtilities.h"
+#include "KDTree.h"
+
+// Request handling of the CP-Service daemon, independent of the socket.
+// One request per line, one response line per request ("OK ..." or "ERR ..."):
+//   LOAD path                 -> OK hash numPoints hit|miss
+//   CLOSEST path [DAC]        -> OK distance index1 index2 (DAC: OK distance)
+//   KPAIRS path k             -> OK count distance index1 index2 ... (closest first)
+//   NEAREST path x y          -> OK index distance
+//   STATS                     -> OK requests= errors= hits= misses= datasets= mean_us= p50_us= p99_us= max_us=
+//   QUIT | SHUTDOWN
+// Point sets are cached by the FNV-1a hash of the file, the sorted-by-X copy and the
+// kd-tree are built on first use and kept until the set is evicted (least recently used).
+#define CP_SERVICE_CACHE_SIZE 8
+#define CP_SERVICE_MAX_K 10000
+#define CP_SERVICE_PAIR_TEXT 66    // " %.17g %zu %zu": 1 + 23 (1.7976931348623157e+308) + 2 * (1 + 20)
+#define CP_SERVICE_RESPONSE_SIZE (CP_SERVICE_PAIR_TEXT * CP_SERVICE_MAX_K + 256)
+#define CP_SERVICE_MAX_CLIENTS 64
+#define CP_SERVICE_PATH_SIZE 4096
+#define CP_SERVICE_LATENCY_BUCKETS 40
+
+// serviceHandleRequest results
+#define CP_SERVICE_CONTINUE 0
+#define CP_SERVICE_CLOSE 1
+#define CP_SERVICE_SHUTDOWN 2
+
+// Definition Data Types
+typedef struct {
+    char path[CP_SERVICE_PATH_SIZE];
+    off_t size;
+    struct timespec mtime;
+    uint64_t hash;
+    uint64_t lastUsed;
+    Point* points;      // File order
+    Point* sortedX;     // Built on the first DAC request
+    KDTree tree;        // Built on the first kd-tree request
+    int hasTree;
+    size_t numPoints;
+} ServiceDataset;
+
+typedef struct {
+    ServiceDataset datasets[CP_SERVICE_CACHE_SIZE];
+    uint64_t clock;
+    uint64_t requests, errors, hits, misses;
+    uint64_t latency[CP_SERVICE_LATENCY_BUCKETS]; // Requests per power-of-two microsecond bucket
+    double totalLatency, maxLatency;             // Microseconds
+} ClosestPairService;
+
+// Definition
+int hashFileFNV1a(const char* filename, uint64_t* hash);
+void serviceInit(ClosestPairService* service);
+void serviceFree(ClosestPairService* service);
+int serviceHandleRequest(ClosestPairService* service, char* line, char* response, const size_t responseSize);
+
+#endif
@@ -0,0 +1,668 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include "ClosestPairUtilities.h"
+
+static int arePointsSortedX(const Point points[], const size_t numPoints) {
+    size_t i;
+    for (i = 1; i < numPoints; i++)
+        if (points[i].x < points[i - 1].x)
+            return 0;
+    return 1;
+}
+
+int writePointsToFile(const char* filename, Point points[], const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const int dimension) {
+    
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+
+    // Write header information
+    fprintf(file, "%ld\n", numPoints);
+    fprintf(file, "%f %f %f %f\n", minX, maxX, minY, maxY);
+    // Number of dimensions, flagged when the points are already sorted by X
+    if (numPoints > 1 && arePointsSortedX(points, numPoints))
+        fprintf(file, "%d %s\n", dimension, CP_TEXT_SORTED_X_TAG);
+    else
+        fprintf(file, "%d\n", dimension);
+
+    // Write points, shortest round-trip decimals staged in a block buffer
+    const size_t blockSize = 1 << 16;
+    char* block = (char*) malloc(blockSize + 2 * CP_TEXT_NUMBER_SIZE);
+    if (block == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        fclose(file);
+        return -2;
+    }
+    size_t i, used = 0;
+    for (i = 0; i < numPoints; i++) {
+        used += formatDouble(points[i].x, block + used);
+        block[used++] = ' ';
+        used += formatDouble(points[i].y, block + used);
+        block[used++] = '\n';
+        if (used >= blockSize) {
+            fwrite(block, 1, used, file);
+            used = 0;
+        }
+    }
+    fwrite(block, 1, used, file);
+    free(block);
+
+    if (fclose(file) != 0) {
+        fprintf(stderr, "Failed to write %s.\n", filename);
+        return -1;
+    }
+
+    return 0;
+}
+
+int readPointsFromFile(const char* filename, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions) {
+    const char* data;
+    size_t size;
+    if (mapTextFile(filename, &data, &size))
+        return -1;
+
+    // Compressed files are recognised by their magic, so every reader accepts them
+    int errcode = isCompressedPoints(data, size)
+                ? parsePointsCompressed(data, size, points, numPoints, minX, maxX, minY, maxY, dimensions)
+                : parsePointsText(data, size, points, numPoints, minX, maxX, minY, maxY, dimensions);
+    unmapTextFile(data, size);
+    return errcode;
+}
+
+int readPointsHeader(const char* filename, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions) {
+    const char* data;
+    size_t size, bodyOffset;
+    if (mapTextFile(filename, &data, &size))
+        return -1;
+
+    int errcode;
+    if (isCompressedPoints(data, size)) {
+        CompressedIndex index;
+        unmapTextFile(data, size);
+        errcode = readCompressedIndex(filename, &index);
+        if (errcode)
+            return errcode;
+        *numPoints = index.numPoints;
+        *minX = index.minX; *maxX = index.maxX;
+        *minY = index.minY; *maxY = index.maxY;
+        *dimensions = index.dimension;
+        freeCompressedIndex(&index);
+        return 0;
+    }
+    errcode = parsePointsHeaderText(data, size, numPoints, minX, maxX, minY, maxY, dimensions, NULL, &bodyOffset);
+    unmapTextFile(data, size);
+    return errcode;
+}
+
+// Pipelined text loader: the reading thread parses one CP_PIPELINE_CHUNK_BYTES piece at a
+// time and hands every parsed run to an OpenMP task that sorts it by X, so the sort overlaps
+// the read. The sorted runs are then merged pairwise, each merge split across threads. Files whose header carries the
+// sorted-x flag are only parsed and checked.
+static int readPointsTextSortedX(const int fd, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions)
+{
+    const size_t chunkBytes = CP_PIPELINE_CHUNK_BYTES;
+    char* buffer = (char*) malloc(2 * chunkBytes);
+    size_t maxRuns = 64, numRuns = 0, filled = 0, pending = 0, bodyOffset, firstLine = 1, i;
+    size_t* runs = (size_t*) malloc((maxRuns + 1) * sizeof(size_t));
+    if (buffer == NULL || runs == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(buffer); free(runs);
+        return -2;
+    }
+
+    // The header must fit in the first piece
+    int sortedX = 0;
+    ssize_t got = read(fd, buffer, chunkBytes);
+    int errcode = (got < 0) ? -1 : parsePointsHeaderText(buffer, (size_t)got, numPoints, minX, maxX, minY, maxY, dimensions, &sortedX, &bodyOffset);
+    if (errcode == 0 && *dimensions != 2) {
+        fprintf(stderr, "Expected 2-dimensional points, the file has %d dimensions.\n", *dimensions);
+        errcode = -4;
+    }
+    if (errcode == 0 && (*points = allocatePoints(*numPoints + 1)) == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        errcode = -2;
+    }
+    if (errcode) {
+        free(buffer); free(runs);
+        return errcode;
+    }
+    for (i = 0; i < bodyOffset; i++)
+        firstLine += (buffer[i] == '\n');
+    pending = (size_t)got - bodyOffset;
+    memmove(buffer, buffer + bodyOffset, pending);
+    runs[0] = 0;
+
+    Point* sorted = *points;
+    #pragma omp parallel
+    #pragma omp single
+    {
+        int atEnd = 0;
+        while (errcode == 0 && !atEnd) {
+            got = read(fd, buffer + pending, chunkBytes);
+            if (got < 0) {
+                fprintf(stderr, "Error reading file.\n");
+                errcode = -1;
+                break;
+            }
+            atEnd = (got == 0);
+            pending += (size_t)got;
+
+            // Parse up to the last complete line, the rest waits for the next piece
+            size_t complete = pending;
+            if (!atEnd) {
+                while (complete > 0 && buffer[complete - 1] != '\n')
+                    complete--;
+                if (complete == 0 && pending < chunkBytes)
+                    continue;
+                if (complete == 0) {
+                    fprintf(stderr, "Line %zu: line too long.\n", firstLine + filled);
+                    errcode = -3;
+                    break;
+                }
+            }
+            size_t numLines;
+            errcode = parsePointLines(buffer, complete, *points, filled, *numPoints, firstLine, &numLines);
+            pending -= complete;
+            memmove(buffer, buffer + complete, pending);
+            // The next piece is read behind the rest: a rest longer than a piece is a line too long
+            if (errcode == 0 && pending > chunkBytes) {
+                fprintf(stderr, "Line %zu: line too long.\n", firstLine + filled + numLines);
+                errcode = -3;
+                break;
+            }
+            size_t first = filled;
+            filled += numLines;
+            if (filled > *numPoints)
+                filled = *numPoints;
+            // The flag is checked as the pieces come in: once a piece is out of order, what was
+            // read so far becomes the first run and the rest is sorted as if the flag were absent
+            if (errcode == 0 && sortedX && filled > first && !arePointsSortedX(*points + first - (first > 0), filled - first + (first > 0))) {
+                sortedX = 0;
+                if (first > 0)
+                    runs[++numRuns] = first;
+            }
+            if (errcode || filled == first || sortedX)
+                continue;
+
+            if (numRuns == maxRuns) {
+                size_t* grown = (size_t*) realloc(runs, (2 * maxRuns + 1) * sizeof(size_t));
+                if (grown == NULL) {
+                    fprintf(stderr, "Memory allocation failed.\n");
+                    errcode = -2;
+                    break;
+                }
+                runs = grown;
+                maxRuns *= 2;
+            }
+            runs[++numRuns] = filled;
+            Point* run = *points + first;
+            const size_t runPoints = filled - first;
+            #pragma omp task firstprivate(run, runPoints)
+            NaturalPointSort(run, runPoints, 1);
+        }
+        #pragma omp taskwait
+    }
+    free(buffer);
+    if (errcode == 0 && filled < *numPoints) {
+        fprintf(stderr, "Line %zu: expected %zu points, the file ends after %zu.\n", firstLine + filled, *numPoints, filled);
+        errcode = -3;
+    }
+
+    // Runs already in order across their border are one run (nearly sorted input)
+    size_t kept = 0;
+    for (i = 1; i <= numRuns; i++)
+        if (i == numRuns || sorted[runs[i]].x < sorted[runs[i] - 1].x)
+            runs[++kept] = runs[i];
+    numRuns = kept;
+
+    // Pairwise merge rounds, ping-ponging between the points and a scratch array
+    profileBegin("merge");
+    Point* scratch = (errcode == 0 && numRuns > 1) ? allocatePoints(*numPoints + 1) : NULL;
+    if (errcode == 0 && numRuns > 1 && scratch == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        errcode = -2;
+    }
+    while (errcode == 0 && numRuns > 1) {
+        for (i = 0; i + 1 < numRuns; i += 2)
+            ParallelMergePointArrays(sorted + runs[i], runs[i + 1] - runs[i], sorted + runs[i + 1], runs[i + 2] - runs[i + 1], scratch + runs[i], 1);
+        if (numRuns % 2)
+            memcpy(scratch + runs[numRuns - 1], sorted + runs[numRuns - 1], (runs[numRuns] - runs[numRuns - 1]) * sizeof(Point));
+        for (i = 0; 2 * i < numRuns; i++)
+            runs[i] = runs[2 * i];
+        runs[(numRuns + 1) / 2] = runs[numRuns];
+        numRuns = (numRuns + 1) / 2;
+        Point* swap = sorted;
+        sorted = scratch;
+        scratch = swap;
+    }
+    free(runs);
+    if (errcode) {
+        free(*points); *points = NULL;
+        free(scratch);
+        return errcode;
+    }
+    // The result may have ended up in the scratch array
+    if (sorted != *points) {
+        scratch = *points;
+        *points = sorted;
+    }
+    free(scratch);
+    return 0;
+}
+
+// readPointsFromFile with the points returned sorted by X. Text files go through the
+// pipelined loader, compressed files already in order are returned as they are.
+int readPointsFromFileSortedX(const char* filename, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions)
+{
+    char magic[4] = {0};
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    ssize_t got = pread(fd, magic, sizeof(magic), 0);
+    if (got == (ssize_t)sizeof(magic) && memcmp(magic, CP_CPZ_MAGIC, 4) == 0) {
+        close(fd);
+        int errcode = readPointsFromFile(filename, points, numPoints, minX, maxX, minY, maxY, dimensions);
+        if (errcode == 0 && !arePointsSortedX(*points, *numPoints))
+            NaturalPointSort(*points, *numPoints, 1);
+        return errcode;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    int errcode = readPointsTextSortedX(fd, points, numPoints, minX, maxX, minY, maxY, dimensions);
+    close(fd);
+    return errcode;
+}
+
+int generateRandomPoints(Point** points, const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY) {
+
+    *points = allocatePoints(numPoints);
+    if (points == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -1;
+    }
+
+    // Generate random points
+    size_t i;
+    for (i = 0; i < numPoints; i++) {
+        (*points)[i].x = minX + (double)rand() / RAND_MAX * (maxX - minX);
+        (*points)[i].y = minY + (double)rand() / RAND_MAX * (maxY - minY);
+    }
+
+    return 0;
+}
+
+// Distributions: uniform, gaussian, clustered, duplicates, collinear, boundary, sorted, lattice
+// The caller seeds rand() so that a corpus can be regenerated bit for bit
+int generatePointsByDistribution(Point** points, const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const char* distribution) {
+
+    if (strcmp(distribution, "uniform") == 0) {
+        return generateRandomPoints(points, numPoints, minX, maxX, minY, maxY);
+    }
+
+    *points = allocatePoints(numPoints);
+    if (*points == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -1;
+    }
+
+    size_t i;
+    double u1, u2, r;
+    double midX = 0.5 * (minX + maxX), midY = 0.5 * (minY + maxY);
+    if (strcmp(distribution, "gaussian") == 0) {
+        // Box-Muller around the domain centre, clamped to the domain
+        for (i = 0; i < numPoints; i++) {
+            u1 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+            u2 = (double)rand() / RAND_MAX;
+            r = sqrt(-2.0 * log(u1));
+            (*points)[i].x = fmin(maxX, fmax(minX, midX + 0.125 * (maxX - minX) * r * cos(2.0 * M_PI * u2)));
+            (*points)[i].y = fmin(maxY, fmax(minY, midY + 0.125 * (maxY - minY) * r * sin(2.0 * M_PI * u2)));
+        }
+    }
+    else if (strcmp(distribution, "clustered") == 0) {
+        // 16 tight clusters, each 1/1000 of the domain wide
+        double centers[16][2];
+        for (i = 0; i < 16; i++) {
+            centers[i][0] = minX + (double)rand() / RAND_MAX * (maxX - minX);
+            centers[i][1] = minY + (double)rand() / RAND_MAX * (maxY - minY);
+        }
+        for (i = 0; i < numPoints; i++) {
+            int c = rand() % 16;
+            (*points)[i].x = fmin(maxX, fmax(minX, centers[c][0] + ((double)rand() / RAND_MAX - 0.5) * 1e-3 * (maxX - minX)));
+            (*points)[i].y = fmin(maxY, fmax(minY, centers[c][1] + ((double)rand() / RAND_MAX - 0.5) * 1e-3 * (maxY - minY)));
+        }
+    }
+    else if (strcmp(distribution, "duplicates") == 0) {
+        // Every other point on average is an exact copy of an earlier one
+        for (i = 0; i < numPoints; i++) {
+            if (i > 0 && rand() % 2) {
+                (*points)[i] = (*points)[rand() % i];
+            } else {
+                (*points)[i].x = minX + (double)rand() / RAND_MAX * (maxX - minX);
+                (*points)[i].y = minY + (double)rand() / RAND_MAX * (maxY - minY);
+            }
+        }
+    }
+    else if (strcmp(distribution, "collinear") == 0) {
+        // All points on the diagonal of the domain
+        for (i = 0; i < numPoints; i++) {
+            u1 = (double)rand() / RAND_MAX;
+            (*points)[i].x = minX + u1 * (maxX - minX);
+            (*points)[i].y = minY + u1 * (maxY - minY);
+        }
+    }
+    else if (strcmp(distribution, "boundary") == 0) {
+        // All points share one X, so every slab cut falls on the same line
+        for (i = 0; i < numPoints; i++) {
+            (*points)[i].x = midX;
+            (*points)[i].y = minY + (double)rand() / RAND_MAX * (maxY - minY);
+        }
+    }
+    else if (strcmp(distribution, "sorted") == 0) {
+        for (i = 0; i < numPoints; i++) {
+            (*points)[i].x = minX + (double)rand() / RAND_MAX * (maxX - minX);
+            (*points)[i].y = minY + (double)rand() / RAND_MAX * (maxY - minY);
+        }
+        qsort(*points, numPoints, sizeof(Point), compareX);
+    }
+    else if (strcmp(distribution, "lattice") == 0) {
+        // Integer grid coordinates, readable by the --exact solvers
+        for (i = 0; i < numPoints; i++) {
+            (*points)[i].x = floor(minX + (double)rand() / RAND_MAX * (maxX - minX));
+            (*points)[i].y = floor(minY + (double)rand() / RAND_MAX * (maxY - minY));
+        }
+    }
+    else {
+        fprintf(stderr, "Unknown distribution %s.\n", distribution);
+        free(*points); *points = NULL;
+        return -2;
+    }
+
+    return 0;
+}
+
+int printPointsAndHeader(const Point points[], const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const int dimension) {
+    // Print header information
+    printf("Number of Points: %ld\n", numPoints);
+    printf("Domain Limits: X(%f, %f) Y(%f, %f)\n", minX, maxX, minY, maxY);
+    printf("Dimensions: %d\n", dimension);
+
+    // Check if points are NULL to avoid dereferencing NULL pointer
+    if (points == NULL) {
+        printf("No points to display.\n");
+        return -1;
+    }
+
+    // Print point data
+    size_t i;
+    for (i = 0; i < numPoints; i++) {
+        printf("Point %3ld: (%15.10f, %15.10f)\n", i + 1, points[i].x, points[i].y);
+    }
+
+    return 0;
+}
+
+double calculateDistance(const Point* p1, const Point* p2) {
+    return sqrt((p1->x - p2->x) * (p1->x - p2->x) + (p1->y - p2->y) * (p1->y - p2->y));
+}
+
+int compareX(const void *a, const void *b) {
+    Point *p1 = (Point *)a, *p2 = (Point *)b;
+    return (p1->x > p2->x) - (p1->x < p2->x);
+}
+
+int compareY(const void *a, const void *b) {
+    Point *p1 = (Point *)a, *p2 = (Point *)b;
+    return (p1->y > p2->y) - (p1->y < p2->y);
+}
+
+int closestPairBruteForce(const Point points[], const size_t numPoints, double* minDistance) {
+    
+    *minDistance = DBL_MAX;
+    if (numPoints <= 1)
+    {
+        return 0;
+    }
+    if (numPoints == 2) {
+        *minDistance = calculateDistance(&points[0], &points[1]);
+        return 0;
+    }
+    
+    size_t i, j;
+    double distance;
+    for (i = 0; i < numPoints; i++) 
+    {
+        for (j = i + 1; j < numPoints; j++) 
+        {
+            distance = calculateDistance(&points[i], &points[j]);
+            if (distance < *minDistance) 
+            {
+                *minDistance = distance;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// The main function that finds the smallest distance
+int closestPairDAC(Point points[], const size_t numPoints, double* minDistance)
+{
+    NaturalPointSort(points, numPoints, 1);
+    return closestPairDACSorted(points, numPoints, minDistance);
+}
+
+// closestPairDAC on points already sorted by X
+int closestPairDACSorted(const Point points[], const size_t numPoints, double* minDistance)
+{
+    // Use recursion to find the smallest distance
+    *minDistance = closestPairRecursive(points, numPoints);
+
+    return (*minDistance < 0) ? -2 : 0;
+}
+
+int closestPairDACMPI(Point points[], const size_t numPoints, double* minDistance)
+{
+    // Use recursion to find the smallest distance
+    *minDistance = closestPairRecursive(points, numPoints);
+    return (*minDistance < 0) ? -2 : 0;
+}
+ 
+// Below this many points the recursion hands over to closestPairLeaf
+static size_t leafSize = CP_LEAF_SIZE_DEFAULT;
+
+void setLeafSize(const size_t size)
+{
+    leafSize = (size < CP_LEAF_SIZE_MIN) ? CP_LEAF_SIZE_MIN : (size > CP_LEAF_SIZE_MAX) ? CP_LEAF_SIZE_MAX : size;
+}
+
+size_t getLeafSize(void)
+{
+    return leafSize;
+}
+
+// Brute force base case of the recursion. A leaf fits in L1, so two rows are checked
+// per pass over the rest of it and both minima stay in registers; distances are
+// compared squared and the square root is taken once.
+double closestPairLeaf(const Point points[], const size_t numPoints)
+{
+    double bestSq = DBL_MAX;
+    size_t i, j;
+    for (i = 0; i + 1 < numPoints; i += 2) {
+        const double x0 = points[i].x, y0 = points[i].y;
+        const double x1 = points[i + 1].x, y1 = points[i + 1].y;
+        double best0 = (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0), best1 = DBL_MAX;
+        for (j = i + 2; j < numPoints; j++) {
+            const double dx0 = points[j].x - x0, dy0 = points[j].y - y0;
+            const double dx1 = points[j].x - x1, dy1 = points[j].y - y1;
+            const double d0 = dx0 * dx0 + dy0 * dy0, d1 = dx1 * dx1 + dy1 * dy1;
+            best0 = (d0 < best0) ? d0 : best0;
+            best1 = (d1 < best1) ? d1 : best1;
+        }
+        best0 = (best1 < best0) ? best1 : best0;
+        bestSq = (best0 < bestSq) ? best0 : bestSq;
+    }
+    return (numPoints < 2) ? DBL_MAX : sqrt(bestSq);
+}
+
+// Points sorted by X, all on one side of x: those within delta of x in X are a prefix
+// (right = 1, points at or after x) or a suffix (right = 0). Returns the prefix length
+// or the start of the suffix. The test is the same fabs the scan used, so the strip
+// holds exactly the points it held before.
+size_t nearPointsBoundX(const Point points[], const size_t numPoints, const double x, const double delta, const int right)
+{
+    size_t low = 0, high = numPoints;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if ((fabs(points[middle].x - x) < delta) == right)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+double closestPairRecursive(const Point points[], const size_t numPoints)
+{
+    // Only one strip is alive at a time, so numPoints points of scratch cover the whole recursion
+    Arena arena;
+    if (arenaInit(&arena, CP_DAC_ARENA_BYTES(numPoints)))
+        return -1.0;
+    double minDistance = closestPairRecursiveArena(points, numPoints, &arena);
+    arenaFree(&arena);
+    return minDistance;
+}
+
+double closestPairRecursiveArena(const Point points[], const size_t numPoints, Arena* arena)
+{
+    // Small ranges are solved by brute force
+    if (numPoints <= leafSize){
+        return closestPairLeaf(points, numPoints);
+    }
+    // Find the middle point
+    int mid = numPoints/2;
+    Point midPoint = points[mid];
+    // Consider the vertical line passing through the middle point
+    // calculate the smallest distance dl on left of middle point and
+    // dr on right side
+    double dl = closestPairRecursiveArena(points, mid, arena);
+    double dr = closestPairRecursiveArena(points + mid, numPoints-mid, arena);
+    // Find the smaller of two distances
+    double minlr = (dl>dr) ? dr : dl; // minDouble(dl, dr);
+    // The points closer than minlr to the line passing through the middle point are a
+    // contiguous range of the sorted array, found by two binary searches and copied
+    // once into strip[], left half first
+    const size_t first = nearPointsBoundX(points, mid, midPoint.x, minlr, 0);
+    const size_t last = mid + nearPointsBoundX(points + mid, numPoints - mid, midPoint.x, minlr, 1);
+    ArenaMark mark = arenaMark(arena);
+    Point* strip = (Point*) arenaAlloc(arena, sizeof(Point) * (last - first));
+    if (strip == NULL && last > first)
+        return -1.0;
+    memcpy(strip, points + first, (last - first) * sizeof(Point));
+    const size_t numLeft = mid - first;
+    // Find the closest pair across the middle line. Return the minimum of d and closest
+    // distance is strip[]
+    double strpmin = stripClosestSplit(strip, numLeft, strip + numLeft, last - mid, minlr, 1, arena);
+    minlr = (minlr>strpmin) ? strpmin : minlr;
+    arenaReset(arena, mark);
+    return minlr;
+}
+
+// Closest pair with one point in each of two strips, left and right of a dividing line.
+// Both strips are sorted by Y here, distances are compared squared and only the square
+// root of the winner is taken. bounded: the points of each side are at least delta apart,
+// so for every left point the right points within delta in Y are among the next
+// CP_STRIP_WINDOW from the first one above y - delta (at most 6 fit in a delta x 2delta box),
+// and that fixed block is checked unconditionally. Otherwise the scan runs until the
+// Y difference reaches the running minimum. The sorts take their scratch from arena, released
+// on return; without an arena they allocate their own.
+double stripClosestSplit(Point left[], const size_t numLeft, Point right[], const size_t numRight, const double delta, const int bounded, Arena* arena)
+{
+    if (numLeft == 0 || numRight == 0)
+        return delta;
+    Point* scratch = NULL;
+    ArenaMark mark;
+    if (arena != NULL) {
+        mark = arenaMark(arena);
+        scratch = (Point*) arenaAlloc(arena, ((numLeft > numRight) ? numLeft : numRight) * sizeof(Point));
+    }
+    if (scratch != NULL) {
+        MergePointSort(left, numLeft, 0, scratch);
+        MergePointSort(right, numRight, 0, scratch);
+        arenaReset(arena, mark);
+    } else {
+        NaturalPointSort(left, numLeft, 0);
+        NaturalPointSort(right, numRight, 0);
+    }
+
+    double best = delta, bestSq = delta * delta;
+    size_t i, k, low = 0;
+    for (i = 0; i < numLeft; i++) {
+        const double xi = left[i].x, yi = left[i].y;
+        while (low < numRight && right[low].y <= yi - best)
+            low++;
+        if (low == numRight)
+            break;
+        double candidateSq = bestSq;
+        if (bounded && low + CP_STRIP_WINDOW <= numRight) {
+            const Point* window = right + low;
+            for (k = 0; k < CP_STRIP_WINDOW; k++) {
+                const double dx = window[k].x - xi, dy = window[k].y - yi;
+                const double distanceSq = dx * dx + dy * dy;
+                candidateSq = (distanceSq < candidateSq) ? distanceSq : candidateSq;
+            }
+        } else {
+            for (k = low; k < numRight && right[k].y - yi < best; k++) {
+                const double dx = right[k].x - xi, dy = right[k].y - yi;
+                const double distanceSq = dx * dx + dy * dy;
+                candidateSq = (distanceSq < candidateSq) ? distanceSq : candidateSq;
+            }
+        }
+        if (candidateSq < bestSq) {
+            bestSq = candidateSq;
+            best = sqrt(bestSq);
+        }
+    }
+    return best;
+}
+
+double stripClosest(Point strip[], const size_t stripSize, const double min_lr)
+{
+    double min_tot = min_lr;
+    qsort(strip, stripSize, sizeof(Point), compareY); 
+ 
+    // Pick all points one by one and try the next points till the difference
+    // between y coordinates is smaller than d.
+    // This is a proven fact that this loop runs at most 6 times
+    int i, j;
+    double dist;
+    for (i = 0; i < stripSize; i++)
+    {
+        for (j = i+1; j < stripSize && (strip[j].y - strip[i].y) < min_tot; j++) // 
+        {
+            dist = calculateDistance(&strip[i], &strip[j]);
+            if (dist < min_tot)
+            {
+                min_tot = dist;
+            }
+        }
+    }
+    return min_tot;
+}
+
+int IsSortingPointsXCorrect(Point array[], int arr_count, int* j)
+{
+    int i;
+    *j = -1;
+    for (i = 0; i < arr_count - 1; i++)
+    {
+        if (array[i].x > array[i + 1].x)
+        {
+            *j = i;
+            return 0;
+        }
+    }
+    return 1;
+}
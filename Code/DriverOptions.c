@@ -0,0 +1,175 @@
+#include "DriverOptions.h"
+
+// Every option and the CP_OPTION_* bit a driver passes to accept it
+static const struct {
+    const char* name;
+    int flag;
+} optionFlags[] = {
+    {"--exact", CP_OPTION_EXACT}, {"--float", CP_OPTION_FLOAT}, {"--calibrate", CP_OPTION_CALIBRATE},
+    {"--numa", CP_OPTION_PLACEMENT}, {"--pin", CP_OPTION_PLACEMENT}, {"--blue", CP_OPTION_BLUE},
+    {"--profile", CP_OPTION_PROFILE}, {"--batch", CP_OPTION_BATCH}, {"--approx", CP_OPTION_APPROX},
+    {"--threshold", CP_OPTION_THRESHOLD}, {"--radius", CP_OPTION_RADIUS}, {"--pairs", CP_OPTION_RADIUS},
+    {"--index", CP_OPTION_INDEX}, {"--checkpoint", CP_OPTION_CHECKPOINT}, {"--restart", CP_OPTION_CHECKPOINT},
+    {"--solver", CP_OPTION_SOLVER}
+};
+
+static int optionFlag(const char* name)
+{
+    size_t k;
+    for (k = 0; k < sizeof(optionFlags) / sizeof(optionFlags[0]); k++)
+        if (strcmp(name, optionFlags[k].name) == 0)
+            return optionFlags[k].flag;
+    return 0;
+}
+
+// supported: the CP_OPTION_* bits of the options this driver implements
+int parseDriverOptions(int argc, char* argv[], DriverOptions* options, const int supported)
+{
+    int i, positional = 0;
+    memset(options, 0, sizeof(DriverOptions));
+
+    for (i = 1; i < argc; i++) {
+        const int flag = optionFlag(argv[i]);
+        if (flag != 0 && !(supported & flag)) {
+            fprintf(stderr, "%s does not support %s.\n", argv[0], argv[i]);
+            return -1;
+        }
+        if (strcmp(argv[i], "--exact") == 0) {
+            options->exact = 1;
+        }
+        else if (strcmp(argv[i], "--float") == 0) {
+            options->singlePrecision = 1;
+        }
+        else if (strcmp(argv[i], "--calibrate") == 0) {
+            options->calibrate = 1;
+        }
+        else if (strcmp(argv[i], "--numa") == 0 && i + 1 < argc) {
+            options->numaPolicyName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--blue") == 0 && i + 1 < argc) {
+            options->blueFilePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--profile") == 0) {
+            options->profile = 1;
+        }
+        else if (strcmp(argv[i], "--batch") == 0) {
+            options->batch = 1;
+        }
+        else if (strcmp(argv[i], "--approx") == 0 && i + 1 < argc) {
+            char* end;
+            options->approx = 1;
+            options->epsilon = strtod(argv[++i], &end);
+            if (*end != '\0' || !(options->epsilon >= 0.0) || isinf(options->epsilon)) {
+                fprintf(stderr, "Invalid epsilon %s.\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            char* end;
+            options->threshold = strtod(argv[++i], &end);
+            if (*end != '\0' || !(options->threshold >= 0.0)) {
+                fprintf(stderr, "Invalid threshold %s.\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "--radius") == 0 && i + 1 < argc) {
+            char* end;
+            options->radius = strtod(argv[++i], &end);
+            if (*end != '\0' || !(options->radius > 0.0) || isinf(options->radius)) {
+                fprintf(stderr, "Invalid radius %s.\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "--pairs") == 0 && i + 1 < argc) {
+            options->pairsFilePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--pin") == 0) {
+            options->pin = 1;
+        }
+        else if (strcmp(argv[i], "--index") == 0 && i + 1 < argc) {
+            options->indexFilePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            options->checkpointDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--restart") == 0 && i + 1 < argc) {
+            options->restartDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            options->solverName = argv[++i];
+        }
+        else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Unknown option %s.\n", argv[i]);
+            return -1;
+        }
+        else if (positional == 0) {
+            options->sampleFilePath = argv[i];
+            positional++;
+        }
+        else if (positional == 1) {
+            options->resultFilePath = argv[i];
+            positional++;
+        }
+        else {
+            fprintf(stderr, "Unexpected argument %s.\n", argv[i]);
+            return -1;
+        }
+    }
+
+    if (options->pairsFilePath != NULL && options->radius == 0.0) {
+        fprintf(stderr, "--pairs needs --radius.\n");
+        return -1;
+    }
+    // A restart does not read the sample: the only positional argument is the result file
+    if (options->restartDir != NULL && positional == 1) {
+        options->resultFilePath = options->sampleFilePath;
+        options->sampleFilePath = NULL;
+        return 0;
+    }
+    // Calibration alone needs no files
+    if (options->calibrate && positional == 0)
+        return 0;
+    return (positional == 2) ? 0 : -1;
+}
+
+void printDriverOptions(void)
+{
+    printf("Options:\n");
+    printf("\t--exact: Integer grid coordinates, solved exactly with integer squared distances (CP-BF-Seq, CP-DAC-Seq)\n");
+    printf("\t--float: Solve in single precision and recheck the closest candidates in double (not CP-KD-Seq)\n");
+    printf("\t--calibrate: Measure the fastest DAC leaf size on this machine and store it for later runs; files may be omitted (CP-DAC-Seq, MPI)\n");
+    printf("\t--numa default|first-touch|interleave: NUMA placement of the point arrays, with a report of the local and remote pages\n");
+    printf("\t--pin: Bind the process and each of its threads to CPUs (MPI ranks on a node split the CPUs)\n");
+    printf("\t--blue bluePath: Closest pair between the sample points (red) and the points of bluePath, never two of one set (not CP-KD-Seq)\n");
+    printf("\t--batch: sampleFilePath is a batch (.cpb) of independent instances, each solved on its own, one distance per instance (not CP-KD-Seq)\n");
+    printf("\t--approx epsilon: Distance within a factor 1 + epsilon of the exact one, with a lower bound; epsilon = 0 is exact (CP-DAC-Seq, MPI)\n");
+    printf("\t--threshold r: Only answer whether a pair closer than r exists, stopping at the first one (CP-BF-Seq, MPI)\n");
+    printf("\t--radius r: Report every pair closer than r (count and checksum) instead of the closest pair (not CP-KD-Seq)\n");
+    printf("\t--pairs pairsPath: With --radius, stream the pairs to pairsPath in the binary .cpr format\n");
+    printf("\t--profile: Cycles, instructions, LLC and branch misses of every phase (and rank), written to the result file\n");
+    printf("\t--index indexFilePath: kd-tree index, loaded when it exists and built and saved otherwise (CP-KD-Seq)\n");
+    printf("\t--checkpoint dir: Save every rank's sorted slab and the slab boundaries after the sort (MPI)\n");
+    printf("\t--restart dir: Solve the slabs of a checkpoint, skipping the read and the sort; sampleFilePath may be omitted (MPI)\n");
+    printf("\t--solver bf|dac: Slab and strip solver, overriding the driver's own (MPI)\n");
+}
+
+// Placement before the points are read. part/parts: this process among those sharing the node
+int applyPlacementOptions(const DriverOptions* options, const int part, const int parts, NumaCounters* before)
+{
+    readNumaCounters(before);
+    int policy = parseNumaPolicy(options->numaPolicyName);
+    if (policy < 0 || setNumaPolicy(policy))
+        return -1;
+    if (options->pin && pinThreads(part, parts))
+        return -1;
+    return 0;
+}
+
+void reportPlacement(const DriverOptions* options, const NumaCounters* before)
+{
+    if (options->numaPolicyName == NULL)
+        return;
+    NumaCounters after;
+    readNumaCounters(&after);
+    printNumaReport(stdout, before, &after);
+}
@@ -0,0 +1,52 @@
+#ifndef DriverOptions_h
+
+#define DriverOptions_h
+#include "PointSortUtilities.h"
+#include "NumaPlacement.h"
+#include "Profiler.h"
+
+// Options a driver accepts, passed to parseDriverOptions: the others are rejected
+#define CP_OPTION_EXACT      0x0001 // --exact
+#define CP_OPTION_FLOAT      0x0002 // --float
+#define CP_OPTION_CALIBRATE  0x0004 // --calibrate
+#define CP_OPTION_PLACEMENT  0x0008 // --numa, --pin
+#define CP_OPTION_BLUE       0x0010 // --blue
+#define CP_OPTION_PROFILE    0x0020 // --profile
+#define CP_OPTION_BATCH      0x0040 // --batch
+#define CP_OPTION_APPROX     0x0080 // --approx
+#define CP_OPTION_THRESHOLD  0x0100 // --threshold
+#define CP_OPTION_RADIUS     0x0200 // --radius, --pairs
+#define CP_OPTION_INDEX      0x0400 // --index
+#define CP_OPTION_CHECKPOINT 0x0800 // --checkpoint, --restart
+#define CP_OPTION_SOLVER     0x1000 // --solver
+
+// Command line of the CP-* drivers: sampleFilePath resultFilePath [options]
+typedef struct {
+    const char* sampleFilePath;
+    const char* resultFilePath;
+    int exact;      // --exact: integer coordinates, exact squared distances
+    int singlePrecision; // --float: float screening with a double recheck
+    const char* indexFilePath; // --index path: kd-tree index reused across runs
+    const char* checkpointDir; // --checkpoint dir: sorted slabs saved after the distributed sort
+    const char* restartDir;    // --restart dir: slabs restored instead of read and sorted
+    const char* solverName;    // --solver bf|dac: slab and strip solver of the MPI drivers
+    int calibrate;  // --calibrate: measure the DAC leaf size of this machine and store it
+    const char* numaPolicyName; // --numa default|first-touch|interleave: placement of the point arrays
+    int pin;        // --pin: bind the process and its threads to CPUs
+    const char* blueFilePath;  // --blue path: closest pair between the sample (red) and these points
+    int profile;    // --profile: hardware counters of every phase, in the result file
+    int batch;      // --batch: the sample is a .cpb file of many instances, one distance each
+    int approx;     // --approx epsilon: (1 + epsilon)-approximate distance with a certified lower bound
+    double epsilon;
+    double threshold; // --threshold r: stop at the first pair closer than r (0: the full minimum)
+    double radius;  // --radius r: every pair closer than r instead of the minimum (0: off)
+    const char* pairsFilePath; // --pairs path: the pairs of --radius, in the .cpr format
+} DriverOptions;
+
+// Definition
+int parseDriverOptions(int argc, char* argv[], DriverOptions* options, const int supported);
+void printDriverOptions(void);
+int applyPlacementOptions(const DriverOptions* options, const int part, const int parts, NumaCounters* before);
+void reportPlacement(const DriverOptions* options, const NumaCounters* before);
+
+#endif
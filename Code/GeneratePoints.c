@@ -1,20 +1,25 @@
 #include"ClosestPairUtilities.h"
+#include"ClosestPairND.h"
+#include"PointBatchIO.h"
 
 int main (int argc, char* argv[])
 {
   // Argument Managment 
-  if (argc != 8)
+  if (argc < 8 || argc > 11)
   {
     printf("Definition:\n\tThis Function Generates Points For Closest Point Problem\n");
-    printf("Usage:\n\tGeneratePoint filePath numPoints minX maxX minY maxY dimension\n");
+    printf("Usage:\n\tGeneratePoint filePath numPoints minX maxX minY maxY dimension [seed] [distribution] [instances]\n");
     printf("Arguments:\n");
-    printf("\t- filePath: Path to save the points\n");
+    printf("\t- filePath: Path to save the points (a .cpz path writes the compressed format, sorted by x; a .cpb path writes a batch of instances)\n");
     printf("\t- numPoints: Number of points to be printed\n");
     printf("\t- minX: Lower bound of x-direction\n");
     printf("\t- maxX: Upper bound of x-direction\n");
     printf("\t- minY: Lower bound of y-direction\n");
     printf("\t- maxY: Upper bound of y-direction\n");
-    printf("\t- dimension: Dimensionality of the points\n");
+    printf("\t- dimension: Dimensionality of the points (other than 2: uniform only, extra coordinates use the y bounds)\n");
+    printf("\t- seed: Random seed for a reproducible corpus (Optional, default: current time)\n");
+    printf("\t- distribution: uniform, gaussian, clustered, duplicates, collinear, boundary, sorted or lattice (Optional, default: uniform)\n");
+    printf("\t- instances: Number of instances of a .cpb batch, each of 1 to numPoints points (Optional, default: 1000)\n");
     return 0;
   }
   
@@ -57,13 +62,119 @@ int main (int argc, char* argv[])
         return -1;
     }
 
+    unsigned int seed = (unsigned int) time(NULL);
+    if (argc > 8) {
+        seed = (unsigned int) strtoul(argv[8], &end, 10);
+        if (*end != '\0') {
+            printf("Error: Invalid seed value.\n");
+            return -1;
+        }
+    }
+
+    const char* distribution = (argc > 9) ? argv[9] : "uniform";
+
+    size_t numInstances = 1000;
+    if (argc > 10) {
+        numInstances = strtoul(argv[10], &end, 10);
+        if (*end != '\0' || numInstances == 0) {
+            printf("Error: Invalid number of instances.\n");
+            return -1;
+        }
+    }
+
+  size_t pathLength = strlen(filePath);
+  int compressed = pathLength > 4 && strcmp(filePath + pathLength - 4, ".cpz") == 0;
+  int batch = pathLength > 4 && strcmp(filePath + pathLength - 4, ".cpb") == 0;
+  if ((compressed || batch) && dimension != 2)
+  {
+    printf("Error: The compressed and batch formats hold 2-dimensional points only.\n");
+    return -1;
+  }
+
   // Seed the random number generator
-  srand(time(NULL));
+  srand(seed);
   
+  // d-dimensional corpus
+  if (dimension != 2)
+  {
+    if (strcmp(distribution, "uniform") != 0)
+    {
+      printf("Error: Only the uniform distribution supports %d dimensions.\n", dimension);
+      return -1;
+    }
+    double *coords = NULL;
+    printf("Start Generating the Points (%s, %dD, seed %u)...\n", distribution, dimension, seed);
+    if (generateRandomPointsND(&coords, numPoints, dimension, minX, maxX, minY, maxY) ||
+        writePointsToFileND(filePath, coords, numPoints, minX, maxX, minY, maxY, dimension))
+    {
+      printf("Random Point Generation Failed!\n");
+      free(coords);
+      return -1;
+    }
+    free(coords); coords = NULL;
+    int errcode = readPointsFromFileND(filePath, &coords, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+    if (errcode)
+    {
+      printf("Validation From File Failed with Error Code %d!\n", errcode);
+      return -1;
+    }
+    printf("Written File is Valid!\n");
+    free(coords);
+    printf("Done!\n");
+    return 0;
+  }
+
+  // Batch of instances of random sizes, each drawn from the distribution on its own
+  if (batch)
+  {
+    size_t i, total = 0;
+    uint64_t *offsets = (uint64_t*) malloc((numInstances + 1) * sizeof(uint64_t));
+    Point *all = NULL, *instance = NULL;
+    if (offsets == NULL)
+    {
+      printf("Random Point Generation Failed!\n");
+      return -1;
+    }
+    offsets[0] = 0;
+    for (i = 0; i < numInstances; i++)
+      offsets[i + 1] = offsets[i] + 1 + (size_t)rand() % numPoints;
+    total = offsets[numInstances];
+    all = allocatePoints(total + 1);
+    printf("Start Generating %lu Instances of %lu Points in Total (%s, seed %u)...\n", numInstances, total, distribution, seed);
+    for (i = 0; all != NULL && i < numInstances; i++)
+    {
+      if (generatePointsByDistribution(&instance, offsets[i + 1] - offsets[i], minX, maxX, minY, maxY, distribution))
+        break;
+      memcpy(all + offsets[i], instance, (offsets[i + 1] - offsets[i]) * sizeof(Point));
+      free(instance); instance = NULL;
+    }
+    if (all == NULL || i < numInstances || writePointBatch(filePath, all, offsets, numInstances))
+    {
+      printf("Random Point Generation Failed!\n");
+      free(all); free(offsets);
+      return -1;
+    }
+    free(all); free(offsets);
+    printf("Validating Written File...\n");
+    BatchIndex index;
+    int errcode = readPointBatch(filePath, &index, &all);
+    if (errcode)
+    {
+      printf("Validation From File Failed with Error Code %d!\n", errcode);
+      return -1;
+    }
+    printf("Written File is Valid!\n");
+    freeBatchIndex(&index);
+    free(all);
+    printf("Done!\n");
+    return 0;
+  }
+
   // Implementation
   Point *points = NULL;
-  printf("Start Generating the Points...\n");
-  if (generateRandomPoints(&points, numPoints, minX, maxX, minY, maxY)) 
+  int errcode;
+  printf("Start Generating the Points (%s, seed %u)...\n", distribution, seed);
+  if (generatePointsByDistribution(&points, numPoints, minX, maxX, minY, maxY, distribution)) 
   {
     printf("Random Point Generation Failed!\n");
     return -1;
@@ -71,7 +182,9 @@ int main (int argc, char* argv[])
   printf("Points Generated!\n");
 
   printf("Writing Points to %s...\n", filePath);
-  if (writePointsToFile(filePath, points, numPoints, minX, maxX, minY, maxY, dimension)) 
+  errcode = compressed ? writePointsCompressed(filePath, points, numPoints, minX, maxX, minY, maxY, dimension, CP_CPZ_SORTED_X)
+                      : writePointsToFile(filePath, points, numPoints, minX, maxX, minY, maxY, dimension);
+  if (errcode) 
   {
     printf("Random Point Generation Failed!\n");
     return -1;
@@ -79,8 +192,8 @@ int main (int argc, char* argv[])
   printf("Points Writed!\n");
 
   printf("Validating Written File...\n");
-  points = NULL;
-  int errcode = readPointsFromFile(filePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+  free(points); points = NULL;
+  errcode = readPointsFromFile(filePath, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
   if (errcode)
   {
     printf("Validation From File Failed with Error Code %d!\n", errcode);
@@ -0,0 +1,535 @@
+#include "KDTree.h"
+
+#define KD_MAGIC "CPKD"
+#define KD_VERSION 1
+
+static inline double coordinate(const Point* p, const int dim)
+{
+    return dim ? p->y : p->x;
+}
+
+static inline void swapEntries(Point points[], size_t index[], const long a, const long b)
+{
+    Point p = points[a]; points[a] = points[b]; points[b] = p;
+    size_t i = index[a]; index[a] = index[b]; index[b] = i;
+}
+
+// Hoare selection: after the call points[k] holds the k-th smallest coordinate of [lo, hi)
+static void selectPoints(Point points[], size_t index[], long lo, long hi, const long k, const int dim)
+{
+    while (hi - lo > 1) {
+        const double pivot = coordinate(&points[lo + (hi - lo) / 2], dim);
+        long i = lo, j = hi - 1;
+        while (i <= j) {
+            while (coordinate(&points[i], dim) < pivot) i++;
+            while (coordinate(&points[j], dim) > pivot) j--;
+            if (i <= j) {
+                swapEntries(points, index, i, j);
+                i++; j--;
+            }
+        }
+        if (k <= j)
+            hi = j + 1;
+        else if (k >= i)
+            lo = i;
+        else
+            return; // Between the partitions every coordinate equals the pivot
+    }
+}
+
+static void boxOfRange(KDBox* box, const Point points[], const size_t lo, const size_t hi)
+{
+    size_t i;
+    box->minX = box->minY = DBL_MAX;
+    box->maxX = box->maxY = -DBL_MAX;
+    for (i = lo; i < hi; i++) {
+        if (points[i].x < box->minX) box->minX = points[i].x;
+        if (points[i].x > box->maxX) box->maxX = points[i].x;
+        if (points[i].y < box->minY) box->minY = points[i].y;
+        if (points[i].y > box->maxY) box->maxY = points[i].y;
+    }
+}
+
+static void buildNode(KDTree* tree, const size_t node, const size_t lo, const size_t hi, const int depth)
+{
+    KDBox* box = &tree->boxes[node];
+    if (depth == tree->levels) {
+        boxOfRange(box, tree->points, lo, hi);
+        return;
+    }
+
+    const size_t mid = lo + (hi - lo) / 2;
+    selectPoints(tree->points, tree->index, lo, hi, mid, depth & 1);
+    #pragma omp task if (hi - lo > CP_KD_TASK_CUTOFF)
+    buildNode(tree, 2 * node + 1, lo, mid, depth + 1);
+    buildNode(tree, 2 * node + 2, mid, hi, depth + 1);
+    #pragma omp taskwait
+
+    const KDBox* left = &tree->boxes[2 * node + 1];
+    const KDBox* right = &tree->boxes[2 * node + 2];
+    box->minX = fmin(left->minX, right->minX); box->maxX = fmax(left->maxX, right->maxX);
+    box->minY = fmin(left->minY, right->minY); box->maxY = fmax(left->maxY, right->maxY);
+}
+
+static int allocateTree(KDTree* tree, const size_t numPoints, const int levels)
+{
+    tree->numPoints = numPoints;
+    tree->levels = levels;
+    tree->numNodes = ((size_t)2 << levels) - 1;
+    tree->points = allocatePoints(numPoints + 1);
+    tree->index = (size_t*) malloc((numPoints + 1) * sizeof(size_t));
+    tree->boxes = (KDBox*) malloc(tree->numNodes * sizeof(KDBox));
+    if (tree->points == NULL || tree->index == NULL || tree->boxes == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        kdTreeFree(tree);
+        return -2;
+    }
+    return 0;
+}
+
+// Fewest levels that bring every leaf down to CP_KD_LEAF_SIZE points
+static int levelsFor(const size_t numPoints)
+{
+    int levels = 0;
+    while (((numPoints + ((size_t)1 << levels) - 1) >> levels) > CP_KD_LEAF_SIZE)
+        levels++;
+    return levels;
+}
+
+// A loaded index is only queried after every box has been checked to hold its range,
+// so a corrupt file is rejected instead of answering wrongly
+static int checkNode(const KDTree* tree, const size_t node, const size_t lo, const size_t hi, const int depth)
+{
+    const KDBox* box = &tree->boxes[node];
+    if (depth == tree->levels) {
+        size_t i;
+        for (i = lo; i < hi; i++) {
+            if (!(tree->points[i].x >= box->minX && tree->points[i].x <= box->maxX &&
+                  tree->points[i].y >= box->minY && tree->points[i].y <= box->maxY))
+                return -1;
+        }
+        return 0;
+    }
+    const size_t mid = lo + (hi - lo) / 2;
+    if (checkNode(tree, 2 * node + 1, lo, mid, depth + 1) || checkNode(tree, 2 * node + 2, mid, hi, depth + 1))
+        return -1;
+    const KDBox* left = &tree->boxes[2 * node + 1];
+    const KDBox* right = &tree->boxes[2 * node + 2];
+    if (!(box->minX <= fmin(left->minX, right->minX) && box->maxX >= fmax(left->maxX, right->maxX) &&
+          box->minY <= fmin(left->minY, right->minY) && box->maxY >= fmax(left->maxY, right->maxY)))
+        return -1;
+    return 0;
+}
+
+// Every original position appears exactly once
+static int checkIndex(const KDTree* tree)
+{
+    size_t i;
+    int valid = 1;
+    unsigned char* seen = (unsigned char*) calloc(tree->numPoints + 1, 1);
+    if (seen == NULL)
+        return -2;
+    for (i = 0; i < tree->numPoints && valid; i++) {
+        valid = tree->index[i] < tree->numPoints && !seen[tree->index[i]];
+        if (valid)
+            seen[tree->index[i]] = 1;
+    }
+    free(seen);
+    return valid ? 0 : -3;
+}
+
+int kdTreeBuild(KDTree* tree, const Point points[], const size_t numPoints)
+{
+    int levels = levelsFor(numPoints);
+    if (allocateTree(tree, numPoints, levels))
+        return -2;
+
+    size_t i;
+    memcpy(tree->points, points, numPoints * sizeof(Point));
+    for (i = 0; i < numPoints; i++)
+        tree->index[i] = i;
+
+    #pragma omp parallel
+    #pragma omp single
+    buildNode(tree, 0, 0, numPoints, 0);
+    return 0;
+}
+
+void kdTreeFree(KDTree* tree)
+{
+    free(tree->points);
+    free(tree->index);
+    free(tree->boxes);
+    memset(tree, 0, sizeof(KDTree));
+}
+
+// On-disk form: magic, version, sizes, then the points, index and boxes arrays
+int kdTreeSave(const KDTree* tree, const char* filename)
+{
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+
+    const uint32_t version = KD_VERSION, indexBytes = sizeof(size_t);
+    const uint64_t numPoints = tree->numPoints;
+    const int32_t levels = tree->levels;
+    int failed = fwrite(KD_MAGIC, 1, 4, file) != 4 ||
+                 fwrite(&version, sizeof(version), 1, file) != 1 ||
+                 fwrite(&indexBytes, sizeof(indexBytes), 1, file) != 1 ||
+                 fwrite(&numPoints, sizeof(numPoints), 1, file) != 1 ||
+                 fwrite(&levels, sizeof(levels), 1, file) != 1 ||
+                 fwrite(tree->points, sizeof(Point), tree->numPoints, file) != tree->numPoints ||
+                 fwrite(tree->index, sizeof(size_t), tree->numPoints, file) != tree->numPoints ||
+                 fwrite(tree->boxes, sizeof(KDBox), tree->numNodes, file) != tree->numNodes;
+    if (fclose(file) != 0 || failed) {
+        fprintf(stderr, "Failed to write the index.\n");
+        return -3;
+    }
+    return 0;
+}
+
+int kdTreeLoad(KDTree* tree, const char* filename)
+{
+    FILE *file = fopen(filename, "rb");
+    memset(tree, 0, sizeof(KDTree));
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+
+    char magic[4];
+    uint32_t version, indexBytes;
+    uint64_t numPoints;
+    int32_t levels;
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, KD_MAGIC, 4) != 0 ||
+        fread(&version, sizeof(version), 1, file) != 1 || version != KD_VERSION ||
+        fread(&indexBytes, sizeof(indexBytes), 1, file) != 1 || indexBytes != sizeof(size_t) ||
+        fread(&numPoints, sizeof(numPoints), 1, file) != 1 ||
+        fread(&levels, sizeof(levels), 1, file) != 1 || levels < 0 || levels > 48) {
+        fprintf(stderr, "Not a kd-tree index of this version.\n");
+        fclose(file);
+        return -3;
+    }
+    // The header must describe exactly the tree kdTreeBuild makes and the arrays that follow it,
+    // checked before numPoints sizes any allocation
+    const long header = ftell(file);
+    const uint64_t maxPoints = (uint64_t)LONG_MAX / (sizeof(Point) + sizeof(size_t));
+    if (header < 0 || fseek(file, 0, SEEK_END) != 0 || numPoints > maxPoints || levels != levelsFor(numPoints) ||
+        (uint64_t)ftell(file) != header + numPoints * (sizeof(Point) + sizeof(size_t)) + (((uint64_t)2 << levels) - 1) * sizeof(KDBox) ||
+        fseek(file, header, SEEK_SET) != 0) {
+        fprintf(stderr, "Corrupt kd-tree index header.\n");
+        fclose(file);
+        return -3;
+    }
+    if (allocateTree(tree, numPoints, levels)) {
+        fclose(file);
+        return -2;
+    }
+    if (fread(tree->points, sizeof(Point), tree->numPoints, file) != tree->numPoints ||
+        fread(tree->index, sizeof(size_t), tree->numPoints, file) != tree->numPoints ||
+        fread(tree->boxes, sizeof(KDBox), tree->numNodes, file) != tree->numNodes) {
+        fprintf(stderr, "Truncated kd-tree index.\n");
+        kdTreeFree(tree);
+        fclose(file);
+        return -3;
+    }
+    fclose(file);
+    int errcode = checkIndex(tree);
+    if (errcode == 0 && checkNode(tree, 0, 0, tree->numPoints, 0))
+        errcode = -3;
+    if (errcode) {
+        fprintf(stderr, errcode == -2 ? "Memory allocation failed.\n" : "Corrupt kd-tree index.\n");
+        kdTreeFree(tree);
+        return errcode;
+    }
+    return 0;
+}
+
+static inline double squaredDistance(const Point* p1, const Point* p2)
+{
+    double dx = p1->x - p2->x, dy = p1->y - p2->y;
+    return dx * dx + dy * dy;
+}
+
+static inline double boxPointDistanceSq(const KDBox* box, const Point* p)
+{
+    double dx = fmax(fmax(box->minX - p->x, p->x - box->maxX), 0.0);
+    double dy = fmax(fmax(box->minY - p->y, p->y - box->maxY), 0.0);
+    return dx * dx + dy * dy;
+}
+
+static inline double boxBoxDistanceSq(const KDBox* a, const KDBox* b)
+{
+    double dx = fmax(fmax(a->minX - b->maxX, b->minX - a->maxX), 0.0);
+    double dy = fmax(fmax(a->minY - b->maxY, b->minY - a->maxY), 0.0);
+    return dx * dx + dy * dy;
+}
+
+// Query state shared by the traversals
+typedef struct {
+    const KDTree* tree;
+    const Point* query;
+    double bestSq;
+    size_t best1, best2;
+    size_t* found;
+    double* foundSq;    // kNN: max-heap of squared distances parallel to found
+    size_t numFound, capacity;
+    int failed;
+} KDSearch;
+
+static void nearestNode(KDSearch* search, const size_t node, const size_t lo, const size_t hi, const int depth)
+{
+    const KDTree* tree = search->tree;
+    if (boxPointDistanceSq(&tree->boxes[node], search->query) >= search->bestSq)
+        return;
+    if (depth == tree->levels) {
+        size_t i;
+        for (i = lo; i < hi; i++) {
+            double distance = squaredDistance(&tree->points[i], search->query);
+            if (distance < search->bestSq) {
+                search->bestSq = distance;
+                search->best1 = i;
+            }
+        }
+        return;
+    }
+
+    // Descend into the side of the split holding the query first
+    const size_t mid = lo + (hi - lo) / 2;
+    if (coordinate(search->query, depth & 1) < coordinate(&tree->points[mid], depth & 1)) {
+        nearestNode(search, 2 * node + 1, lo, mid, depth + 1);
+        nearestNode(search, 2 * node + 2, mid, hi, depth + 1);
+    } else {
+        nearestNode(search, 2 * node + 2, mid, hi, depth + 1);
+        nearestNode(search, 2 * node + 1, lo, mid, depth + 1);
+    }
+}
+
+int kdTreeNearest(const KDTree* tree, const Point* query, size_t* index, double* distance)
+{
+    if (tree->numPoints == 0)
+        return -1;
+    KDSearch search;
+    memset(&search, 0, sizeof(search));
+    search.tree = tree;
+    search.query = query;
+    search.bestSq = DBL_MAX;
+    nearestNode(&search, 0, 0, tree->numPoints, 0);
+    *index = tree->index[search.best1];
+    *distance = sqrt(search.bestSq);
+    return 0;
+}
+
+static void pushNeighbour(KDSearch* search, const size_t position, const double distanceSq)
+{
+    size_t i = search->numFound, parent, child;
+    if (i < search->capacity) {
+        // Sift up the new entry
+        search->numFound++;
+        for (; i > 0 && search->foundSq[(parent = (i - 1) / 2)] < distanceSq; i = parent) {
+            search->foundSq[i] = search->foundSq[parent];
+            search->found[i] = search->found[parent];
+        }
+    } else {
+        // Replace the farthest neighbour and sift down
+        for (i = 0; (child = 2 * i + 1) < search->numFound; i = child) {
+            if (child + 1 < search->numFound && search->foundSq[child + 1] > search->foundSq[child])
+                child++;
+            if (search->foundSq[child] <= distanceSq)
+                break;
+            search->foundSq[i] = search->foundSq[child];
+            search->found[i] = search->found[child];
+        }
+    }
+    search->foundSq[i] = distanceSq;
+    search->found[i] = position;
+    if (search->numFound == search->capacity)
+        search->bestSq = search->foundSq[0];
+}
+
+static void kNearestNode(KDSearch* search, const size_t node, const size_t lo, const size_t hi, const int depth)
+{
+    const KDTree* tree = search->tree;
+    if (boxPointDistanceSq(&tree->boxes[node], search->query) >= search->bestSq)
+        return;
+    if (depth == tree->levels) {
+        size_t i;
+        for (i = lo; i < hi; i++) {
+            double distance = squaredDistance(&tree->points[i], search->query);
+            if (distance < search->bestSq)
+                pushNeighbour(search, i, distance);
+        }
+        return;
+    }
+
+    const size_t mid = lo + (hi - lo) / 2;
+    if (coordinate(search->query, depth & 1) < coordinate(&tree->points[mid], depth & 1)) {
+        kNearestNode(search, 2 * node + 1, lo, mid, depth + 1);
+        kNearestNode(search, 2 * node + 2, mid, hi, depth + 1);
+    } else {
+        kNearestNode(search, 2 * node + 2, mid, hi, depth + 1);
+        kNearestNode(search, 2 * node + 1, lo, mid, depth + 1);
+    }
+}
+
+// The min(k, n) nearest points, closest first; indices and distances hold k entries
+int kdTreeKNearest(const KDTree* tree, const Point* query, const size_t k, size_t indices[], double distances[], size_t* count)
+{
+    KDSearch search;
+    memset(&search, 0, sizeof(search));
+    search.tree = tree;
+    search.query = query;
+    search.bestSq = DBL_MAX;
+    search.found = indices;
+    search.foundSq = distances;
+    search.capacity = k;
+    *count = 0;
+    if (k == 0 || tree->numPoints == 0)
+        return 0;
+    kNearestNode(&search, 0, 0, tree->numPoints, 0);
+
+    // Heap sort in place, then map to original positions
+    size_t n = search.numFound, i;
+    while (search.numFound > 1) {
+        size_t last = --search.numFound;
+        size_t position = search.found[last];
+        double distanceSq = search.foundSq[last];
+        search.found[last] = search.found[0];
+        search.foundSq[last] = search.foundSq[0];
+        search.capacity = search.numFound;
+        pushNeighbour(&search, position, distanceSq);
+    }
+    for (i = 0; i < n; i++) {
+        indices[i] = tree->index[indices[i]];
+        distances[i] = sqrt(distances[i]);
+    }
+    *count = n;
+    return 0;
+}
+
+static void radiusNode(KDSearch* search, const size_t node, const size_t lo, const size_t hi, const int depth)
+{
+    const KDTree* tree = search->tree;
+    if (search->failed || boxPointDistanceSq(&tree->boxes[node], search->query) > search->bestSq)
+        return;
+    if (depth < tree->levels) {
+        const size_t mid = lo + (hi - lo) / 2;
+        radiusNode(search, 2 * node + 1, lo, mid, depth + 1);
+        radiusNode(search, 2 * node + 2, mid, hi, depth + 1);
+        return;
+    }
+
+    size_t i;
+    for (i = lo; i < hi; i++) {
+        if (squaredDistance(&tree->points[i], search->query) > search->bestSq)
+            continue;
+        if (search->numFound == search->capacity) {
+            size_t* grown = (size_t*) realloc(search->found, 2 * search->capacity * sizeof(size_t));
+            if (grown == NULL) {
+                search->failed = 1;
+                return;
+            }
+            search->found = grown;
+            search->capacity *= 2;
+        }
+        search->found[search->numFound++] = tree->index[i];
+    }
+}
+
+// Original positions of every point within radius (inclusive) of the query, caller frees
+int kdTreeRadius(const KDTree* tree, const Point* query, const double radius, size_t** indices, size_t* count)
+{
+    KDSearch search;
+    memset(&search, 0, sizeof(search));
+    search.tree = tree;
+    search.query = query;
+    search.bestSq = radius * radius;
+    search.capacity = 16;
+    search.found = (size_t*) malloc(search.capacity * sizeof(size_t));
+    if (search.found == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    if (tree->numPoints > 0 && radius >= 0.0)
+        radiusNode(&search, 0, 0, tree->numPoints, 0);
+    if (search.failed) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(search.found);
+        return -2;
+    }
+    *indices = search.found;
+    *count = search.numFound;
+    return 0;
+}
+
+static void leafPairs(KDSearch* search, const size_t aLo, const size_t aHi, const size_t bLo, const size_t bHi)
+{
+    const Point* points = search->tree->points;
+    size_t i, j;
+    for (i = aLo; i < aHi; i++) {
+        for (j = (aLo == bLo) ? i + 1 : bLo; j < bHi; j++) {
+            double distance = squaredDistance(&points[i], &points[j]);
+            if (distance < search->bestSq) {
+                search->bestSq = distance;
+                search->best1 = i;
+                search->best2 = j;
+            }
+        }
+    }
+}
+
+// Dual-tree traversal: a pair of nodes at the same depth is skipped once their boxes
+// are at least the current minimum apart, the closer child pairs are visited first
+static void closestPairNodes(KDSearch* search, const size_t a, const size_t aLo, const size_t aHi,
+                             const size_t b, const size_t bLo, const size_t bHi, const int depth)
+{
+    const KDTree* tree = search->tree;
+    if (a != b && boxBoxDistanceSq(&tree->boxes[a], &tree->boxes[b]) >= search->bestSq)
+        return;
+    if (depth == tree->levels) {
+        leafPairs(search, aLo, aHi, bLo, bHi);
+        return;
+    }
+
+    const size_t aMid = aLo + (aHi - aLo) / 2, bMid = bLo + (bHi - bLo) / 2;
+    if (a == b) {
+        closestPairNodes(search, 2 * a + 1, aLo, aMid, 2 * a + 1, aLo, aMid, depth + 1);
+        closestPairNodes(search, 2 * a + 2, aMid, aHi, 2 * a + 2, aMid, aHi, depth + 1);
+        closestPairNodes(search, 2 * a + 1, aLo, aMid, 2 * a + 2, aMid, aHi, depth + 1);
+        return;
+    }
+
+    const size_t childA[4] = {2 * a + 1, 2 * a + 1, 2 * a + 2, 2 * a + 2};
+    const size_t childB[4] = {2 * b + 1, 2 * b + 2, 2 * b + 1, 2 * b + 2};
+    double gap[4];
+    int order[4] = {0, 1, 2, 3}, i, j;
+    for (i = 0; i < 4; i++)
+        gap[i] = boxBoxDistanceSq(&tree->boxes[childA[i]], &tree->boxes[childB[i]]);
+    for (i = 1; i < 4; i++)
+        for (j = i; j > 0 && gap[order[j]] < gap[order[j - 1]]; j--) {
+            int t = order[j]; order[j] = order[j - 1]; order[j - 1] = t;
+        }
+    for (i = 0; i < 4; i++) {
+        const int c = order[i];
+        closestPairNodes(search, childA[c], (c < 2) ? aLo : aMid, (c < 2) ? aMid : aHi,
+                         childB[c], (c & 1) ? bMid : bLo, (c & 1) ? bHi : bMid, depth + 1);
+    }
+}
+
+int kdTreeClosestPair(const KDTree* tree, double* minDistance, size_t* index1, size_t* index2)
+{
+    *minDistance = DBL_MAX;
+    if (tree->numPoints < 2)
+        return 0;
+    KDSearch search;
+    memset(&search, 0, sizeof(search));
+    search.tree = tree;
+    search.bestSq = DBL_MAX;
+    closestPairNodes(&search, 0, 0, tree->numPoints, 0, 0, tree->numPoints, 0);
+    *minDistance = sqrt(search.bestSq);
+    *index1 = tree->index[search.best1];
+    *index2 = tree->index[search.best2];
+    return 0;
+}
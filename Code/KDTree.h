@@ -0,0 +1,42 @@
+#ifndef KDTree_h
+
+#define KDTree_h
+#include <limits.h>
+#include <stdint.h>
+#include "ClosestPairUtilities.h"
+
+// Implicit kd-tree over a copy of the points.
+// The points are reordered so that every node owns a contiguous range: the root owns
+// [0, n), node i splits its range at the middle into nodes 2i+1 and 2i+2, alternating
+// x and y by depth. All leaves sit at depth `levels` and hold at most CP_KD_LEAF_SIZE
+// points. Only the bounding box of each node is stored, so there are no pointers and
+// the whole index can be written to and read from disk as three flat arrays.
+#define CP_KD_LEAF_SIZE 8
+#define CP_KD_TASK_CUTOFF 16384 // Smallest range built as a separate OpenMP task
+
+// Definition Data Types
+typedef struct {
+    double minX, maxX;
+    double minY, maxY;
+} KDBox;
+
+typedef struct {
+    Point* points;      // Points in tree order
+    size_t* index;      // Original position of every point in tree order
+    KDBox* boxes;       // Bounding box of every node, heap order
+    size_t numPoints;
+    size_t numNodes;
+    int levels;
+} KDTree;
+
+// Definition
+int kdTreeBuild(KDTree* tree, const Point points[], const size_t numPoints);
+void kdTreeFree(KDTree* tree);
+int kdTreeSave(const KDTree* tree, const char* filename);
+int kdTreeLoad(KDTree* tree, const char* filename);
+int kdTreeNearest(const KDTree* tree, const Point* query, size_t* index, double* distance);
+int kdTreeKNearest(const KDTree* tree, const Point* query, const size_t k, size_t indices[], double distances[], size_t* count);
+int kdTreeRadius(const KDTree* tree, const Point* query, const double radius, size_t** indices, size_t* count);
+int kdTreeClosestPair(const KDTree* tree, double* minDistance, size_t* index1, size_t* index2);
+
+#endif
@@ -0,0 +1,200 @@
+#define _GNU_SOURCE
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "NumaPlacement.h"
+
+// From linux/mempolicy.h, so that libnuma is not needed
+#define CP_MPOL_INTERLEAVE 3
+
+static int numaPolicy = CP_NUMA_DEFAULT;
+static int pinnedCpus = 0;     // CPUs of the process share after pinThreads, 0 before
+
+int parseNumaPolicy(const char* name)
+{
+    if (name == NULL || strcmp(name, "default") == 0)
+        return CP_NUMA_DEFAULT;
+    if (strcmp(name, "first-touch") == 0)
+        return CP_NUMA_FIRST_TOUCH;
+    if (strcmp(name, "interleave") == 0)
+        return CP_NUMA_INTERLEAVE;
+    fprintf(stderr, "Unknown NUMA policy %s, expected default, first-touch or interleave.\n", name);
+    return -1;
+}
+
+// Online nodes as a bit mask, from a list such as "0-1,3"
+static unsigned long onlineNodeMask(void)
+{
+    unsigned long mask = 0;
+    FILE* file = fopen("/sys/devices/system/node/online", "r");
+    if (file == NULL)
+        return 1;
+    int first, last;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        int c = fgetc(file);
+        if (c == '-') {
+            if (fscanf(file, "%d", &last) != 1)
+                break;
+            c = fgetc(file);
+        }
+        for (; first <= last && first < (int)(8 * sizeof(mask)); first++)
+            mask |= 1UL << first;
+        if (c != ',')
+            break;
+    }
+    fclose(file);
+    return mask ? mask : 1;
+}
+
+int setNumaPolicy(const int policy)
+{
+    if (policy == CP_NUMA_INTERLEAVE) {
+#ifdef SYS_set_mempolicy
+        unsigned long mask = onlineNodeMask();
+        if (syscall(SYS_set_mempolicy, CP_MPOL_INTERLEAVE, &mask, 8 * sizeof(mask) + 1) != 0) {
+            perror("Failed to set the interleave policy");
+            return -1;
+        }
+#else
+        fprintf(stderr, "The interleave policy is not supported on this system.\n");
+        return -1;
+#endif
+    }
+    numaPolicy = policy;
+    return 0;
+}
+
+int getNumaPolicy(void)
+{
+    return numaPolicy;
+}
+
+// malloc, then under first-touch one write per page by the thread that owns that block
+// of the array under a static schedule. Inside a parallel region the caller's thread
+// touches it all, as malloc would.
+Point* allocatePoints(const size_t count)
+{
+    Point* points = (Point*) malloc(count * sizeof(Point));
+    const size_t bytes = count * sizeof(Point);
+    if (points == NULL || numaPolicy != CP_NUMA_FIRST_TOUCH || bytes < CP_NUMA_TOUCH_MIN)
+        return points;
+#ifdef _OPENMP
+    if (!omp_in_parallel()) {
+        char* base = (char*) points;
+        long page;
+        const long numPages = (long)((bytes + CP_NUMA_PAGE_SIZE - 1) / CP_NUMA_PAGE_SIZE);
+        #pragma omp parallel for schedule(static)
+        for (page = 0; page < numPages; page++)
+            base[(size_t)page * CP_NUMA_PAGE_SIZE] = 0;
+    }
+#endif
+    return points;
+}
+
+int pinThreads(const int part, const int parts)
+{
+    cpu_set_t allowed;
+    int cpus[CPU_SETSIZE], numCpus = 0, c;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        perror("Failed to read the CPU affinity");
+        return -1;
+    }
+    for (c = 0; c < CPU_SETSIZE; c++)
+        if (CPU_ISSET(c, &allowed))
+            cpus[numCpus++] = c;
+    if (numCpus == 0)
+        return -1;
+
+    // Contiguous share of this process; more processes than CPUs share them round robin
+    int first = (int)((long)part * numCpus / parts), count = (int)((long)(part + 1) * numCpus / parts) - first;
+    if (count <= 0) {
+        first = part % numCpus;
+        count = 1;
+    }
+    cpu_set_t share;
+    CPU_ZERO(&share);
+    for (c = first; c < first + count; c++)
+        CPU_SET(cpus[c], &share);
+    if (sched_setaffinity(0, sizeof(share), &share) != 0) {
+        perror("Failed to set the CPU affinity");
+        return -1;
+    }
+    pinnedCpus = count;
+
+    int failed = 0;
+#ifdef _OPENMP
+    #pragma omp parallel reduction(|:failed)
+    {
+        cpu_set_t own;
+        CPU_ZERO(&own);
+        CPU_SET(cpus[first + omp_get_thread_num() % count], &own);
+        failed |= (sched_setaffinity(0, sizeof(own), &own) != 0);
+    }
+#endif
+    if (failed)
+        fprintf(stderr, "Failed to pin the worker threads.\n");
+    return failed ? -1 : 0;
+}
+
+int readNumaCounters(NumaCounters* counters)
+{
+    char path[96], name[32];
+    unsigned long long value;
+    int node;
+    memset(counters, 0, sizeof(NumaCounters));
+    unsigned long mask = onlineNodeMask();
+    for (node = 0; node < (int)(8 * sizeof(mask)); node++) {
+        if (!(mask & (1UL << node)))
+            continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/numastat", node);
+        FILE* file = fopen(path, "r");
+        if (file == NULL)
+            continue;
+        counters->nodes++;
+        while (fscanf(file, "%31s %llu", name, &value) == 2) {
+            if (strcmp(name, "numa_hit") == 0) counters->numaHit += value;
+            else if (strcmp(name, "numa_miss") == 0) counters->numaMiss += value;
+            else if (strcmp(name, "local_node") == 0) counters->localNode += value;
+            else if (strcmp(name, "other_node") == 0) counters->otherNode += value;
+            else if (strcmp(name, "interleave_hit") == 0) counters->interleaveHit += value;
+        }
+        fclose(file);
+    }
+    return (counters->nodes > 0) ? 0 : -1;
+}
+
+void printNumaReport(FILE* file, const NumaCounters* before, const NumaCounters* after)
+{
+    static const char* policies[] = {"default", "first-touch", "interleave"};
+    fprintf(file, "NUMA Policy: %s\n", policies[numaPolicy]);
+    if (before->nodes == 0 || after->nodes == 0) {
+        fprintf(file, "NUMA Counters: not available on this system\n");
+        return;
+    }
+    // Pages, system wide, over the run
+    fprintf(file, "NUMA Nodes: %d\n", after->nodes);
+    fprintf(file, "NUMA Local Pages: %llu\n", after->localNode - before->localNode);
+    fprintf(file, "NUMA Remote Pages: %llu\n", after->otherNode - before->otherNode);
+    fprintf(file, "NUMA Hit/Miss Pages: %llu/%llu\n", after->numaHit - before->numaHit, after->numaMiss - before->numaMiss);
+    fprintf(file, "NUMA Interleaved Pages: %llu\n", after->interleaveHit - before->interleaveHit);
+}
+
+// OpenMP threads of this process that can run at once: its thread count, capped by the CPUs
+// it may use (its pinned share, or the affinity mask it was started with, e.g. by mpirun)
+int availableWorkers(void)
+{
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    int cpus = pinnedCpus;
+    if (cpus == 0) {
+        cpu_set_t allowed;
+        cpus = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) ? CPU_COUNT(&allowed) : 1;
+    }
+    return (threads < cpus) ? threads : cpus;
+}
@@ -0,0 +1,40 @@
+#ifndef NumaPlacement_h
+
+#define NumaPlacement_h
+#include "PointSortUtilities.h"
+
+// NUMA placement of the point arrays and of the threads working on them (Linux).
+//  - first-touch: allocatePoints has the OpenMP threads touch a new array in the same
+//    static blocks the sorts, merges and loaders later split it into, so the pages of
+//    every X range land on the node of the thread that works on it
+//  - interleave: pages allocated from then on are spread round robin over the nodes
+// pinThreads binds the process to its share of the allowed CPUs and every OpenMP
+// thread to one CPU of that share. MPI ranks on a node split the CPUs between them.
+// The counters are the per-node numastat of the system (all processes), summed.
+#define CP_NUMA_DEFAULT 0
+#define CP_NUMA_FIRST_TOUCH 1
+#define CP_NUMA_INTERLEAVE 2
+#define CP_NUMA_TOUCH_MIN (1 << 20)  // Smaller arrays are left to malloc
+#define CP_NUMA_PAGE_SIZE 4096
+
+// Definition Data Types
+typedef struct {
+    int nodes;
+    unsigned long long numaHit;     // Allocated on the intended node
+    unsigned long long numaMiss;    // Allocated elsewhere because the intended node was full
+    unsigned long long localNode;   // Allocated on the node of the allocating CPU
+    unsigned long long otherNode;   // Allocated on another node
+    unsigned long long interleaveHit;
+} NumaCounters;
+
+// Definition
+int parseNumaPolicy(const char* name);
+int setNumaPolicy(const int policy);
+int getNumaPolicy(void);
+Point* allocatePoints(const size_t count);
+int pinThreads(const int part, const int parts);
+int availableWorkers(void);
+int readNumaCounters(NumaCounters* counters);
+void printNumaReport(FILE* file, const NumaCounters* before, const NumaCounters* after);
+
+#endif
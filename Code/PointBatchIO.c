@@ -0,0 +1,146 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include "ClosestPairUtilities.h"
+
+// Fields are written in host byte order (little-endian on every supported target)
+#define CPB_HEADER_SIZE 24
+
+int isBatchFile(const char* filename)
+{
+    char magic[4];
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+        return 0;
+    size_t got = fread(magic, 1, 4, file);
+    fclose(file);
+    return got == 4 && memcmp(magic, CP_CPB_MAGIC, 4) == 0;
+}
+
+int writePointBatch(const char* filename, const Point points[], const uint64_t offsets[], const size_t numInstances)
+{
+    uint8_t header[CPB_HEADER_SIZE];
+    uint32_t version = CP_CPB_VERSION;
+    uint64_t count = numInstances, numPoints = offsets[numInstances];
+    memcpy(header, CP_CPB_MAGIC, 4);
+    memcpy(header + 4, &version, 4);
+    memcpy(header + 8, &count, 8);
+    memcpy(header + 16, &numPoints, 8);
+
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    int failed = fwrite(header, 1, CPB_HEADER_SIZE, file) != CPB_HEADER_SIZE;
+    failed |= fwrite(offsets, sizeof(uint64_t), numInstances + 1, file) != numInstances + 1;
+    failed |= fwrite(points, sizeof(Point), numPoints, file) != numPoints;
+    failed |= (fclose(file) != 0);
+    if (failed)
+        fprintf(stderr, "Error writing file.\n");
+    return failed ? -1 : 0;
+}
+
+int readBatchIndex(const char* filename, BatchIndex* index)
+{
+    size_t i;
+    index->offsets = NULL;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    uint8_t header[CPB_HEADER_SIZE];
+    uint32_t version;
+    uint64_t numInstances, numPoints;
+    off_t fileSize = lseek(fd, 0, SEEK_END);
+    if (pread(fd, header, CPB_HEADER_SIZE, 0) != CPB_HEADER_SIZE || memcmp(header, CP_CPB_MAGIC, 4) != 0) {
+        fprintf(stderr, "Not a batch point file.\n");
+        close(fd);
+        return -3;
+    }
+    memcpy(&version, header + 4, 4);
+    memcpy(&numInstances, header + 8, 8);
+    memcpy(&numPoints, header + 16, 8);
+    // Header, index and points must account for the whole file
+    if (version != CP_CPB_VERSION || numInstances >= (uint64_t)fileSize / sizeof(uint64_t) ||
+        numPoints > ((uint64_t)fileSize - CPB_HEADER_SIZE) / sizeof(Point) ||
+        (uint64_t)fileSize != CPB_HEADER_SIZE + (numInstances + 1) * sizeof(uint64_t) + numPoints * sizeof(Point)) {
+        fprintf(stderr, "Not a batch point file of this version.\n");
+        close(fd);
+        return -3;
+    }
+
+    size_t tableSize = (numInstances + 1) * sizeof(uint64_t);
+    index->offsets = (uint64_t*) malloc(tableSize);
+    if (index->offsets == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        close(fd);
+        return -2;
+    }
+    int errcode = (pread(fd, index->offsets, tableSize, CPB_HEADER_SIZE) == (ssize_t)tableSize) ? 0 : -3;
+    close(fd);
+    for (i = 0; errcode == 0 && i < numInstances; i++)
+        if (index->offsets[i] > index->offsets[i + 1])
+            errcode = -3;
+    if (errcode == 0 && (index->offsets[0] != 0 || index->offsets[numInstances] != numPoints))
+        errcode = -3;
+    if (errcode) {
+        fprintf(stderr, "Corrupt batch index.\n");
+        freeBatchIndex(index);
+        return errcode;
+    }
+    index->numInstances = numInstances;
+    index->numPoints = numPoints;
+    return 0;
+}
+
+void freeBatchIndex(BatchIndex* index)
+{
+    free(index->offsets);
+    index->offsets = NULL;
+}
+
+// Points of instances [first, last), in one read
+int readBatchInstances(const char* filename, const BatchIndex* index, const size_t first, const size_t last, Point points[])
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    const size_t bytes = (index->offsets[last] - index->offsets[first]) * sizeof(Point);
+    const off_t offset = CPB_HEADER_SIZE + (index->numInstances + 1) * sizeof(uint64_t) + index->offsets[first] * sizeof(Point);
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t got = pread(fd, (char*)points + done, bytes - done, offset + done);
+        if (got <= 0)
+            break;
+        done += (size_t)got;
+    }
+    close(fd);
+    if (done != bytes) {
+        fprintf(stderr, "Truncated batch file.\n");
+        return -3;
+    }
+    return 0;
+}
+
+int readPointBatch(const char* filename, BatchIndex* index, Point** points)
+{
+    int errcode = readBatchIndex(filename, index);
+    if (errcode)
+        return errcode;
+    *points = allocatePoints(index->numPoints + 1);
+    if (*points == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        freeBatchIndex(index);
+        return -2;
+    }
+    errcode = readBatchInstances(filename, index, 0, index->numInstances, *points);
+    if (errcode) {
+        free(*points);
+        *points = NULL;
+        freeBatchIndex(index);
+    }
+    return errcode;
+}
@@ -0,0 +1,32 @@
+#ifndef PointBatchIO_h
+
+#define PointBatchIO_h
+#include <stdint.h>
+#include "PointSortUtilities.h"
+
+// Batch format (.cpb): many independent 2-dimensional instances in one file.
+// The points of all instances are stored back to back; an index of numInstances + 1
+// point offsets tells where every instance starts, so a reader can load any range of
+// instances with one read and no parsing.
+//   header:  "CPB1" version numInstances numPoints
+//   offsets: (numInstances + 1) x uint64, offsets[0] = 0 and offsets[numInstances] = numPoints
+//   points:  numPoints x {x y}
+#define CP_CPB_MAGIC "CPB1"
+#define CP_CPB_VERSION 1
+
+// Definition Data Types
+typedef struct {
+    size_t numInstances;
+    size_t numPoints;
+    uint64_t* offsets;
+} BatchIndex;
+
+// Definition
+int isBatchFile(const char* filename);
+int writePointBatch(const char* filename, const Point points[], const uint64_t offsets[], const size_t numInstances);
+int readBatchIndex(const char* filename, BatchIndex* index);
+void freeBatchIndex(BatchIndex* index);
+int readBatchInstances(const char* filename, const BatchIndex* index, const size_t first, const size_t last, Point points[]);
+int readPointBatch(const char* filename, BatchIndex* index, Point** points);
+
+#endif
@@ -0,0 +1,529 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include "ClosestPairUtilities.h"
+
+// Fields are written in host byte order (little-endian on every supported target)
+#define CPZ_HEADER_SIZE 72
+#define CPZ_ENTRY_SIZE 40
+#define CPZ_PADDING 8
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    uint64_t accumulator;
+    int fill;
+} BitWriter;
+
+typedef struct {
+    const uint8_t* data;
+    size_t position;    // In bits
+    size_t limit;       // Bits before the padding; reads past it fail
+    int failed;
+} BitReader;
+
+static inline void putWord(uint8_t* out, const uint64_t word)
+{
+    int i;
+    for (i = 0; i < 8; i++)
+        out[i] = (uint8_t)(word >> (56 - 8 * i));
+}
+
+static inline void putBits(BitWriter* writer, uint64_t value, const int n)
+{
+    if (n == 64) {
+        putBits(writer, value >> 32, 32);
+        putBits(writer, value & 0xFFFFFFFFULL, 32);
+        return;
+    }
+    value &= (1ULL << n) - 1;
+    if (writer->fill + n < 64) {
+        writer->accumulator = (writer->accumulator << n) | value;
+        writer->fill += n;
+        return;
+    }
+    // Top bits complete the current word, the rest starts the next one
+    const int rest = writer->fill + n - 64;
+    writer->accumulator = (writer->accumulator << (n - rest)) | (value >> rest);
+    putWord(writer->data + writer->size, writer->accumulator);
+    writer->size += 8;
+    writer->accumulator = rest ? (value & ((1ULL << rest) - 1)) : 0;
+    writer->fill = rest;
+}
+
+static void flushBits(BitWriter* writer)
+{
+    if (writer->fill > 0) {
+        uint8_t word[8];
+        putWord(word, writer->accumulator << (64 - writer->fill));
+        memcpy(writer->data + writer->size, word, (writer->fill + 7) / 8);
+        writer->size += (writer->fill + 7) / 8;
+    }
+    memset(writer->data + writer->size, 0, CPZ_PADDING);
+    writer->size += CPZ_PADDING;
+    writer->accumulator = 0;
+    writer->fill = 0;
+}
+
+// Up to 57 bits in one unaligned big-endian load; the padding keeps the load in bounds.
+// A read past the limit returns 0 and marks the reader failed.
+static inline uint64_t getBits(BitReader* reader, const int n)
+{
+    if (n == 0)
+        return 0;
+    if (reader->failed || reader->position + (size_t)n > reader->limit) {
+        reader->failed = 1;
+        return 0;
+    }
+    if (n > 57) {
+        uint64_t high = getBits(reader, n - 32);
+        return (high << 32) | getBits(reader, 32);
+    }
+    const uint8_t* p = reader->data + (reader->position >> 3);
+    uint64_t word = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+                    ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+    word = (word << (reader->position & 7)) >> (64 - n);
+    reader->position += n;
+    return word;
+}
+
+static inline uint64_t doubleBits(const double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Gorilla: '0' repeats the previous value, '10' reuses the previous leading/trailing
+// window, '11' sends a new window as 6 bits of leading zeros and 6 bits of length - 1
+static void encodeStream(BitWriter* writer, const Point points[], const size_t count, const int useY)
+{
+    size_t i;
+    uint64_t previous = doubleBits(useY ? points[0].y : points[0].x);
+    int leading = 64, trailing = 0;
+    putBits(writer, previous, 64);
+    for (i = 1; i < count; i++) {
+        uint64_t current = doubleBits(useY ? points[i].y : points[i].x);
+        uint64_t delta = current ^ previous;
+        previous = current;
+        if (delta == 0) {
+            putBits(writer, 0, 1);
+            continue;
+        }
+        int lz = __builtin_clzll(delta), tz = __builtin_ctzll(delta);
+        if (lz > 63) lz = 63;
+        if (leading < 64 && lz >= leading && tz >= trailing) {
+            putBits(writer, 2, 2);
+            putBits(writer, delta >> trailing, 64 - leading - trailing);
+        } else {
+            leading = lz;
+            trailing = tz;
+            putBits(writer, 3, 2);
+            putBits(writer, (uint64_t)leading, 6);
+            putBits(writer, (uint64_t)(64 - leading - trailing - 1), 6);
+            putBits(writer, delta >> trailing, 64 - leading - trailing);
+        }
+    }
+}
+
+static int decodeStream(BitReader* reader, Point points[], const size_t count, const int useY)
+{
+    size_t i;
+    uint64_t value = getBits(reader, 64);
+    int leading = 0, trailing = 0;
+    double decoded;
+    for (i = 0; !reader->failed; i++) {
+        memcpy(&decoded, &value, sizeof(decoded));
+        if (useY) points[i].y = decoded; else points[i].x = decoded;
+        if (i + 1 == count)
+            return 0;
+        if (getBits(reader, 1) == 0)
+            continue;
+        if (getBits(reader, 1) == 1) {
+            leading = (int)getBits(reader, 6);
+            const int length = (int)getBits(reader, 6) + 1;
+            if (leading + length > 64)
+                return -3;
+            trailing = 64 - leading - length;
+        }
+        value ^= getBits(reader, 64 - leading - trailing) << trailing;
+    }
+    return -3;
+}
+
+// Worst case: every value after the first needs 2 + 12 + 64 bits
+static size_t blockCapacity(const size_t count)
+{
+    return 2 * (8 + count * 10) + 2 * CPZ_PADDING;
+}
+
+static void encodeBlock(BitWriter* writer, const Point points[], const size_t count)
+{
+    encodeStream(writer, points, count, 0);
+    encodeStream(writer, points, count, 1);
+    flushBits(writer);
+}
+
+static int decodeBlock(const uint8_t* data, const size_t size, Point points[], const size_t count)
+{
+    // The streams must end inside the block, before its padding
+    BitReader reader = {data, 0, (size - CPZ_PADDING) * 8, 0};
+    if (count == 0)
+        return 0;
+    if (size < CPZ_PADDING || decodeStream(&reader, points, count, 0) || decodeStream(&reader, points, count, 1))
+        return -3;
+    return 0;
+}
+
+int isCompressedPoints(const char* data, const size_t size)
+{
+    return size >= CPZ_HEADER_SIZE && memcmp(data, CP_CPZ_MAGIC, 4) == 0;
+}
+
+// Quiet probe used to pick the read path: 1 for a 2-dimensional file sorted by X
+int isSortedCompressedFile(const char* filename)
+{
+    uint8_t header[CPZ_HEADER_SIZE];
+    uint32_t dimension, flags;
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+        return 0;
+    size_t got = fread(header, 1, CPZ_HEADER_SIZE, file);
+    fclose(file);
+    if (got != CPZ_HEADER_SIZE || memcmp(header, CP_CPZ_MAGIC, 4) != 0)
+        return 0;
+    memcpy(&dimension, header + 48, 4);
+    memcpy(&flags, header + 52, 4);
+    return dimension == 2 && (flags & CP_CPZ_SORTED_X);
+}
+
+static void packHeader(uint8_t* out, const CompressedIndex* index)
+{
+    const uint32_t version = CP_CPZ_VERSION, dimension = index->dimension, pad = 0;
+    const uint64_t numPoints = index->numPoints, numBlocks = index->numBlocks;
+    const double bounds[4] = {index->minX, index->maxX, index->minY, index->maxY};
+    memcpy(out, CP_CPZ_MAGIC, 4);
+    memcpy(out + 4, &version, 4);
+    memcpy(out + 8, &numPoints, 8);
+    memcpy(out + 16, bounds, 32);
+    memcpy(out + 48, &dimension, 4);
+    memcpy(out + 52, &index->flags, 4);
+    memcpy(out + 56, &index->blockPoints, 4);
+    memcpy(out + 60, &pad, 4);
+    memcpy(out + 64, &numBlocks, 8);
+}
+
+static int unpackHeader(const uint8_t* in, CompressedIndex* index)
+{
+    uint32_t version, dimension;
+    uint64_t numPoints, numBlocks;
+    double bounds[4];
+    memcpy(&version, in + 4, 4);
+    memcpy(&numPoints, in + 8, 8);
+    memcpy(bounds, in + 16, 32);
+    memcpy(&dimension, in + 48, 4);
+    memcpy(&index->flags, in + 52, 4);
+    memcpy(&index->blockPoints, in + 56, 4);
+    memcpy(&numBlocks, in + 64, 8);
+    if (memcmp(in, CP_CPZ_MAGIC, 4) != 0 || version != CP_CPZ_VERSION || index->blockPoints == 0 ||
+        numBlocks != (numPoints + index->blockPoints - 1) / index->blockPoints) {
+        fprintf(stderr, "Not a compressed point file of this version.\n");
+        return -3;
+    }
+    index->numPoints = numPoints;
+    index->numBlocks = numBlocks;
+    index->minX = bounds[0]; index->maxX = bounds[1];
+    index->minY = bounds[2]; index->maxY = bounds[3];
+    index->dimension = (int)dimension;
+    return 0;
+}
+
+static int unpackTable(const uint8_t* in, CompressedIndex* index, const size_t fileSize)
+{
+    size_t b, total = 0;
+    index->blocks = (CompressedBlock*) malloc((index->numBlocks + 1) * sizeof(CompressedBlock));
+    if (index->blocks == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return -2;
+    }
+    for (b = 0; b < index->numBlocks; b++) {
+        CompressedBlock* block = &index->blocks[b];
+        const uint8_t* entry = in + b * CPZ_ENTRY_SIZE;
+        memcpy(&block->offset, entry, 8);
+        memcpy(&block->size, entry + 8, 8);
+        memcpy(&block->count, entry + 16, 4);
+        memcpy(&block->minX, entry + 24, 8);
+        memcpy(&block->maxX, entry + 32, 8);
+        block->reserved = 0;
+        total += block->count;
+        if (block->offset > fileSize || block->size > fileSize - block->offset || block->size < CPZ_PADDING ||
+            block->count == 0 || block->count > index->blockPoints ||
+            (b + 1 < index->numBlocks && block->count != index->blockPoints)) {
+            fprintf(stderr, "Block %zu of the compressed file is corrupt.\n", b);
+            freeCompressedIndex(index);
+            return -3;
+        }
+    }
+    if (total != index->numPoints) {
+        fprintf(stderr, "Compressed blocks hold %zu points, the header %zu.\n", total, index->numPoints);
+        freeCompressedIndex(index);
+        return -3;
+    }
+    return 0;
+}
+
+void freeCompressedIndex(CompressedIndex* index)
+{
+    free(index->blocks);
+    index->blocks = NULL;
+}
+
+int writePointsCompressed(const char* filename, const Point points[], const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const int dimension, const uint32_t flags)
+{
+    CompressedIndex index;
+    size_t b, i;
+    index.numPoints = numPoints;
+    index.minX = minX; index.maxX = maxX;
+    index.minY = minY; index.maxY = maxY;
+    index.dimension = dimension;
+    index.flags = flags;
+    index.blockPoints = CP_CPZ_BLOCK_POINTS;
+    index.numBlocks = (numPoints + CP_CPZ_BLOCK_POINTS - 1) / CP_CPZ_BLOCK_POINTS;
+
+    // Sorted files are encoded from a sorted copy
+    const Point* source = points;
+    Point* sorted = NULL;
+    if (flags & CP_CPZ_SORTED_X) {
+        sorted = allocatePoints(numPoints + 1);
+        if (sorted == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return -2;
+        }
+        memcpy(sorted, points, numPoints * sizeof(Point));
+        qsort(sorted, numPoints, sizeof(Point), compareX);
+        source = sorted;
+    }
+
+    index.blocks = (CompressedBlock*) calloc(index.numBlocks + 1, sizeof(CompressedBlock));
+    uint8_t** encoded = (uint8_t**) calloc(index.numBlocks + 1, sizeof(uint8_t*));
+    int failed = (index.blocks == NULL || encoded == NULL);
+
+    long k;
+    #pragma omp parallel for schedule(dynamic, 4) reduction(|:failed)
+    for (k = 0; k < (long)index.numBlocks; k++) {
+        if (failed) continue;
+        const size_t first = (size_t)k * CP_CPZ_BLOCK_POINTS;
+        const size_t count = (numPoints - first < CP_CPZ_BLOCK_POINTS) ? numPoints - first : CP_CPZ_BLOCK_POINTS;
+        BitWriter writer = {(uint8_t*) malloc(blockCapacity(count)), 0, 0, 0};
+        if (writer.data == NULL) {
+            failed = 1;
+            continue;
+        }
+        encodeBlock(&writer, source + first, count);
+        CompressedBlock* block = &index.blocks[k];
+        block->size = writer.size;
+        block->count = (uint32_t)count;
+        block->minX = block->maxX = source[first].x;
+        for (i = first + 1; i < first + count; i++) {
+            if (source[i].x < block->minX) block->minX = source[i].x;
+            if (source[i].x > block->maxX) block->maxX = source[i].x;
+        }
+        encoded[k] = writer.data;
+    }
+
+    FILE* file = failed ? NULL : fopen(filename, "wb");
+    if (file != NULL) {
+        uint8_t header[CPZ_HEADER_SIZE], entry[CPZ_ENTRY_SIZE];
+        uint64_t offset = CPZ_HEADER_SIZE + index.numBlocks * CPZ_ENTRY_SIZE;
+        packHeader(header, &index);
+        failed |= fwrite(header, 1, CPZ_HEADER_SIZE, file) != CPZ_HEADER_SIZE;
+        for (b = 0; b < index.numBlocks; b++) {
+            CompressedBlock* block = &index.blocks[b];
+            block->offset = offset;
+            offset += block->size;
+            memset(entry, 0, sizeof(entry));
+            memcpy(entry, &block->offset, 8);
+            memcpy(entry + 8, &block->size, 8);
+            memcpy(entry + 16, &block->count, 4);
+            memcpy(entry + 24, &block->minX, 8);
+            memcpy(entry + 32, &block->maxX, 8);
+            failed |= fwrite(entry, 1, CPZ_ENTRY_SIZE, file) != CPZ_ENTRY_SIZE;
+        }
+        for (b = 0; b < index.numBlocks; b++)
+            failed |= fwrite(encoded[b], 1, index.blocks[b].size, file) != index.blocks[b].size;
+        failed |= (fclose(file) != 0);
+    }
+    else if (!failed) {
+        fprintf(stderr, "Error opening file.\n");
+        failed = -1;
+    }
+    else {
+        fprintf(stderr, "Memory allocation failed.\n");
+    }
+
+    for (b = 0; encoded != NULL && b < index.numBlocks; b++)
+        free(encoded[b]);
+    free(encoded);
+    free(index.blocks);
+    free(sorted);
+    return failed ? -1 : 0;
+}
+
+// Decodes a whole mapped file, one block per task
+int parsePointsCompressed(const char* data, const size_t size, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions)
+{
+    CompressedIndex index;
+    int errcode = unpackHeader((const uint8_t*) data, &index);
+    if (errcode)
+        return errcode;
+    if (size - CPZ_HEADER_SIZE < index.numBlocks * CPZ_ENTRY_SIZE) {
+        fprintf(stderr, "Truncated compressed file.\n");
+        return -3;
+    }
+    errcode = unpackTable((const uint8_t*) data + CPZ_HEADER_SIZE, &index, size);
+    if (errcode)
+        return errcode;
+    *numPoints = index.numPoints;
+    *minX = index.minX; *maxX = index.maxX;
+    *minY = index.minY; *maxY = index.maxY;
+    *dimensions = index.dimension;
+    if (index.dimension != 2) {
+        fprintf(stderr, "Expected 2-dimensional points, the file has %d dimensions.\n", index.dimension);
+        freeCompressedIndex(&index);
+        return -4;
+    }
+
+    *points = allocatePoints(index.numPoints + 1);
+    if (*points == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        freeCompressedIndex(&index);
+        return -2;
+    }
+    long k;
+    int failed = 0;
+    #pragma omp parallel for schedule(dynamic, 4) reduction(|:failed)
+    for (k = 0; k < (long)index.numBlocks; k++) {
+        const CompressedBlock* block = &index.blocks[k];
+        failed |= (decodeBlock((const uint8_t*) data + block->offset, block->size, *points + (size_t)k * index.blockPoints, block->count) != 0);
+    }
+    freeCompressedIndex(&index);
+    if (failed) {
+        fprintf(stderr, "Corrupt block in the compressed file.\n");
+        free(*points); *points = NULL;
+        return -3;
+    }
+    return 0;
+}
+
+int readCompressedIndex(const char* filename, CompressedIndex* index)
+{
+    index->blocks = NULL;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    uint8_t header[CPZ_HEADER_SIZE];
+    off_t fileSize = lseek(fd, 0, SEEK_END);
+    if (pread(fd, header, CPZ_HEADER_SIZE, 0) != CPZ_HEADER_SIZE || unpackHeader(header, index) != 0) {
+        close(fd);
+        return -3;
+    }
+    size_t tableSize = index->numBlocks * CPZ_ENTRY_SIZE;
+    uint8_t* table = (uint8_t*) malloc(tableSize + 1);
+    if (table == NULL || pread(fd, table, tableSize, CPZ_HEADER_SIZE) != (ssize_t)tableSize) {
+        fprintf(stderr, "Truncated compressed file.\n");
+        free(table);
+        close(fd);
+        return -3;
+    }
+    int errcode = unpackTable(table, index, (size_t)fileSize);
+    free(table);
+    close(fd);
+    return errcode;
+}
+
+// Streams blocks [firstBlock, lastBlock) from disk into points, which must hold their counts
+int readCompressedBlocks(const char* filename, const CompressedIndex* index, const size_t firstBlock, const size_t lastBlock, Point points[])
+{
+    size_t b, largest = 0, filled = 0;
+    for (b = firstBlock; b < lastBlock; b++)
+        if (index->blocks[b].size > largest)
+            largest = index->blocks[b].size;
+    int fd = open(filename, O_RDONLY);
+    uint8_t* buffer = (uint8_t*) malloc(largest + 1);
+    if (fd < 0 || buffer == NULL) {
+        fprintf(stderr, (fd < 0) ? "Error opening file.\n" : "Memory allocation failed.\n");
+        if (fd >= 0) close(fd);
+        free(buffer);
+        return (fd < 0) ? -1 : -2;
+    }
+
+    int errcode = 0;
+    for (b = firstBlock; b < lastBlock && errcode == 0; b++) {
+        const CompressedBlock* block = &index->blocks[b];
+        if (pread(fd, buffer, block->size, block->offset) != (ssize_t)block->size ||
+            decodeBlock(buffer, block->size, points + filled, block->count) != 0) {
+            fprintf(stderr, "Corrupt block %zu in the compressed file.\n", b);
+            errcode = -3;
+        }
+        filled += block->count;
+    }
+    free(buffer);
+    close(fd);
+    return errcode;
+}
+
+// The slab of rank out of nprocs in a sorted file: the blocks whose first point falls in
+// the rank's even share, read from disk directly. midpointsX (nprocs - 1 entries) receives
+// the boundary between every pair of neighbouring slabs, from the block X ranges.
+int readCompressedSlab(const char* filename, const int rank, const int nprocs, Point** points, int* numPoints, double midpointsX[])
+{
+    CompressedIndex index;
+    int errcode = readCompressedIndex(filename, &index), r;
+    if (errcode)
+        return errcode;
+    if (!(index.flags & CP_CPZ_SORTED_X) || index.dimension != 2) {
+        fprintf(stderr, "Slab reads need a 2-dimensional file sorted by X.\n");
+        freeCompressedIndex(&index);
+        return -4;
+    }
+
+    size_t* firstBlock = (size_t*) malloc((nprocs + 1) * sizeof(size_t));
+    if (firstBlock == NULL) {
+        freeCompressedIndex(&index);
+        return -2;
+    }
+    size_t b = 0, start = 0;
+    for (r = 0; r <= nprocs; r++) {
+        const size_t share = index.numPoints / nprocs * r + ((size_t)r < index.numPoints % nprocs ? (size_t)r : index.numPoints % nprocs);
+        while (b < index.numBlocks && start < share) {
+            start += index.blocks[b].count;
+            b++;
+        }
+        firstBlock[r] = (r == nprocs) ? index.numBlocks : b;
+    }
+    for (r = 0; r < nprocs - 1; r++) {
+        const size_t next = firstBlock[r + 1];
+        if (index.numBlocks == 0)
+            midpointsX[r] = 0.0;
+        else if (next == 0)
+            midpointsX[r] = index.blocks[0].minX;
+        else if (next >= index.numBlocks)
+            midpointsX[r] = index.blocks[index.numBlocks - 1].maxX;
+        else
+            midpointsX[r] = 0.5 * (index.blocks[next - 1].maxX + index.blocks[next].minX);
+    }
+
+    size_t count = 0;
+    for (b = firstBlock[rank]; b < firstBlock[rank + 1]; b++)
+        count += index.blocks[b].count;
+    *numPoints = (int)count;
+    *points = allocatePoints(count + 1);
+    errcode = (*points == NULL) ? -2 : readCompressedBlocks(filename, &index, firstBlock[rank], firstBlock[rank + 1], *points);
+    if (errcode) {
+        free(*points); *points = NULL;
+    }
+    free(firstBlock);
+    freeCompressedIndex(&index);
+    return errcode;
+}
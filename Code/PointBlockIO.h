@@ -0,0 +1,50 @@
+#ifndef PointBlockIO_h
+
+#define PointBlockIO_h
+#include <stdint.h>
+#include "PointSortUtilities.h"
+
+// Compressed block format (.cpz).
+// Points are stored in blocks of CP_CPZ_BLOCK_POINTS; every coordinate stream is
+// XOR-encoded against the previous value (Gorilla style), which packs neighbouring
+// doubles of a sorted-by-X file into a few bits. A table after the header gives the
+// offset, size, count and X range of every block, so blocks decode independently
+// (in parallel, or only the ones a reader needs).
+//   header: "CPZ1" version numPoints minX maxX minY maxY dimension flags blockPoints numBlocks
+//   table:  numBlocks x {offset size count minX maxX}
+//   blocks: x stream then y stream, padded with 8 zero bytes
+#define CP_CPZ_MAGIC "CPZ1"
+#define CP_CPZ_VERSION 1
+#define CP_CPZ_BLOCK_POINTS 4096
+#define CP_CPZ_SORTED_X 0x1   // Points sorted by X across the whole file
+
+// Definition Data Types
+typedef struct {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t count;
+    uint32_t reserved;
+    double minX, maxX;
+} CompressedBlock;
+
+typedef struct {
+    size_t numPoints;
+    double minX, maxX, minY, maxY;
+    int dimension;
+    uint32_t flags;
+    uint32_t blockPoints;
+    size_t numBlocks;
+    CompressedBlock* blocks;
+} CompressedIndex;
+
+// Definition
+int isCompressedPoints(const char* data, const size_t size);
+int isSortedCompressedFile(const char* filename);
+int writePointsCompressed(const char* filename, const Point points[], const size_t numPoints, const double minX, const double maxX, const double minY, const double maxY, const int dimension, const uint32_t flags);
+int parsePointsCompressed(const char* data, const size_t size, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions);
+int readCompressedIndex(const char* filename, CompressedIndex* index);
+void freeCompressedIndex(CompressedIndex* index);
+int readCompressedBlocks(const char* filename, const CompressedIndex* index, const size_t firstBlock, const size_t lastBlock, Point points[]);
+int readCompressedSlab(const char* filename, const int rank, const int nprocs, Point** points, int* numPoints, double midpointsX[]);
+
+#endif
@@ -0,0 +1,179 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include "PointPairIO.h"
+
+static uint64_t mixBits(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t hashPointPair(const PointPair* pair)
+{
+    uint64_t words[4], hash = 0;
+    int i;
+    memcpy(words, pair, sizeof(words));
+    for (i = 0; i < 4; i++)
+        hash = mixBits(hash ^ words[i]);
+    return hash;
+}
+
+static void encodePairHeader(uint8_t header[CP_CPR_HEADER_SIZE], const double radius, const uint64_t numPairs)
+{
+    uint32_t version = CP_CPR_VERSION;
+    memcpy(header, CP_CPR_MAGIC, 4);
+    memcpy(header + 4, &version, 4);
+    memcpy(header + 8, &radius, 8);
+    memcpy(header + 16, &numPairs, 8);
+}
+
+// filename NULL: no file, the pairs are only counted and hashed
+int openPairWriter(PairWriter* writer, const char* filename, const double radius)
+{
+    memset(writer, 0, sizeof(PairWriter));
+    if (filename == NULL)
+        return 0;
+    writer->buffer = (PointPair*) malloc(CP_CPR_BUFFER_PAIRS * sizeof(PointPair));
+    writer->file = fopen(filename, "wb");
+    if (writer->buffer == NULL || writer->file == NULL) {
+        const int errcode = (writer->buffer == NULL) ? -2 : -1;
+        fprintf(stderr, (errcode == -2) ? "Memory allocation failed.\n" : "Error opening file.\n");
+        if (writer->file != NULL)
+            fclose(writer->file);
+        free(writer->buffer);
+        writer->file = NULL;
+        writer->buffer = NULL;
+        return errcode;
+    }
+    // The count is patched in by closePairWriter
+    uint8_t header[CP_CPR_HEADER_SIZE];
+    encodePairHeader(header, radius, 0);
+    writer->failed = fwrite(header, 1, CP_CPR_HEADER_SIZE, writer->file) != CP_CPR_HEADER_SIZE;
+    return 0;
+}
+
+void writePair(PairWriter* writer, const Point* p, const Point* q)
+{
+    PointPair pair;
+    const int swap = (q->x < p->x) || (q->x == p->x && q->y < p->y);
+    pair.a = swap ? *q : *p;
+    pair.b = swap ? *p : *q;
+    writer->numPairs++;
+    writer->checksum += hashPointPair(&pair);
+    if (writer->file == NULL)
+        return;
+    writer->buffer[writer->buffered++] = pair;
+    if (writer->buffered == CP_CPR_BUFFER_PAIRS) {
+        writer->failed |= fwrite(writer->buffer, sizeof(PointPair), writer->buffered, writer->file) != writer->buffered;
+        writer->buffered = 0;
+    }
+}
+
+int closePairWriter(PairWriter* writer)
+{
+    if (writer->file == NULL)
+        return 0;
+    int failed = writer->failed;
+    failed |= fwrite(writer->buffer, sizeof(PointPair), writer->buffered, writer->file) != writer->buffered;
+    failed |= fseek(writer->file, 16, SEEK_SET) != 0;
+    failed |= fwrite(&writer->numPairs, sizeof(uint64_t), 1, writer->file) != 1;
+    failed |= (fclose(writer->file) != 0);
+    free(writer->buffer);
+    writer->file = NULL;
+    writer->buffer = NULL;
+    if (failed)
+        fprintf(stderr, "Error writing file.\n");
+    return failed ? -1 : 0;
+}
+
+// Header of a pair file whose pairs are filled in by writePairPart
+int writePairHeader(const char* filename, const double radius, const uint64_t numPairs)
+{
+    uint8_t header[CP_CPR_HEADER_SIZE];
+    encodePairHeader(header, radius, numPairs);
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    int failed = fwrite(header, 1, CP_CPR_HEADER_SIZE, file) != CP_CPR_HEADER_SIZE;
+    failed |= (fclose(file) != 0);
+    if (failed)
+        fprintf(stderr, "Error writing file.\n");
+    return failed ? -1 : 0;
+}
+
+// Copies the pairs of the pair file partPath into filename from pair firstPair on, so that
+// several writers (ranks) can fill disjoint ranges of one file at once
+int writePairPart(const char* filename, const char* partPath, const uint64_t firstPair)
+{
+    int in = open(partPath, O_RDONLY), out = open(filename, O_WRONLY);
+    if (in < 0 || out < 0) {
+        fprintf(stderr, "Error opening file.\n");
+        if (in >= 0) close(in);
+        if (out >= 0) close(out);
+        return -1;
+    }
+    char* buffer = (char*) malloc(CP_CPR_BUFFER_PAIRS * sizeof(PointPair));
+    off_t from = CP_CPR_HEADER_SIZE, to = CP_CPR_HEADER_SIZE + (off_t)(firstPair * sizeof(PointPair));
+    ssize_t got = 0;
+    int failed = (buffer == NULL);
+    while (!failed && (got = pread(in, buffer, CP_CPR_BUFFER_PAIRS * sizeof(PointPair), from)) > 0) {
+        failed = pwrite(out, buffer, (size_t)got, to) != got;
+        from += got;
+        to += got;
+    }
+    failed |= (got < 0);
+    failed |= (close(out) != 0);
+    close(in);
+    free(buffer);
+    if (failed)
+        fprintf(stderr, "Error writing file.\n");
+    return failed ? -1 : 0;
+}
+
+int readPointPairs(const char* filename, double* radius, PointPair** pairs, size_t* numPairs)
+{
+    uint8_t header[CP_CPR_HEADER_SIZE];
+    uint32_t version;
+    uint64_t count;
+    *pairs = NULL;
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fread(header, 1, CP_CPR_HEADER_SIZE, file) != CP_CPR_HEADER_SIZE || memcmp(header, CP_CPR_MAGIC, 4) != 0) {
+        fprintf(stderr, "Not a pair file.\n");
+        fclose(file);
+        return -3;
+    }
+    memcpy(&version, header + 4, 4);
+    memcpy(radius, header + 8, 8);
+    memcpy(&count, header + 16, 8);
+    if (version != CP_CPR_VERSION || count > (uint64_t)(fileSize - CP_CPR_HEADER_SIZE) / sizeof(PointPair) ||
+        (uint64_t)fileSize != CP_CPR_HEADER_SIZE + count * sizeof(PointPair)) {
+        fprintf(stderr, "Not a pair file of this version.\n");
+        fclose(file);
+        return -3;
+    }
+    *pairs = (PointPair*) malloc((count + 1) * sizeof(PointPair));
+    if (*pairs == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        fclose(file);
+        return -2;
+    }
+    int errcode = (fread(*pairs, sizeof(PointPair), count, file) == count) ? 0 : -3;
+    fclose(file);
+    if (errcode) {
+        free(*pairs);
+        *pairs = NULL;
+        return errcode;
+    }
+    *numPairs = count;
+    return 0;
+}
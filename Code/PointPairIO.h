@@ -0,0 +1,42 @@
+#ifndef PointPairIO_h
+
+#define PointPairIO_h
+#include <stdint.h>
+#include "PointSortUtilities.h"
+
+// Pair format (.cpr): the pairs of a fixed-radius query, streamed to the file as they are
+// found. Every pair is stored with its lexicographically smaller point (X, then Y) first;
+// the count in the header is written when the writer is closed.
+//   header: "CPR1" version radius numPairs
+//   pairs:  numPairs x {x1 y1 x2 y2}
+// The writer also keeps an order-independent checksum of the pairs, so that solvers that
+// find them in different orders (or on different ranks) can be compared without the files.
+#define CP_CPR_MAGIC "CPR1"
+#define CP_CPR_VERSION 1
+#define CP_CPR_HEADER_SIZE 24
+#define CP_CPR_BUFFER_PAIRS 4096
+
+// Definition Data Types
+typedef struct {
+    Point a, b;
+} PointPair;
+
+typedef struct {
+    FILE* file;         // NULL: pairs are only counted
+    PointPair* buffer;
+    size_t buffered;
+    uint64_t numPairs;
+    uint64_t checksum;  // Sum of the pair hashes, modulo 2^64
+    int failed;
+} PairWriter;
+
+// Definition
+int openPairWriter(PairWriter* writer, const char* filename, const double radius);
+void writePair(PairWriter* writer, const Point* p, const Point* q);
+int closePairWriter(PairWriter* writer);
+int writePairHeader(const char* filename, const double radius, const uint64_t numPairs);
+int writePairPart(const char* filename, const char* partPath, const uint64_t firstPair);
+int readPointPairs(const char* filename, double* radius, PointPair** pairs, size_t* numPairs);
+uint64_t hashPointPair(const PointPair* pair);
+
+#endif
@@ -0,0 +1,334 @@
+#include "PointSortUtilities.h"
+#include "NumaPlacement.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void QuickPointSort(Point array[], int count, int sort_by_x) {
+    srand(time(NULL));
+    QuickPointSortRecursive(array, 0, count - 1, sort_by_x);
+}
+
+void QuickPointSortRecursive(Point array[], int left_index, int right_index, int sort_by_x) {
+    if (left_index < right_index) {
+        int pivot_index = QuickPointSortPartitioner(array, left_index, right_index, sort_by_x);
+        QuickPointSortRecursive(array, left_index, pivot_index - 1, sort_by_x);
+        QuickPointSortRecursive(array, pivot_index + 1, right_index, sort_by_x);
+    }
+}
+
+void SwapPoints(Point* a, Point* b) {
+    Point temp;
+    // Fill Temp
+    temp.x = a->x;
+    temp.y = a->y;
+    // Fill a with b
+    a->x = b->x;
+    a->y = b->y;
+    // Fill a with b
+    b->x = temp.x;
+    b->y = temp.y;
+}
+
+int QuickPointSortPartitioner(Point array[], int left_index, int right_index, int sort_by_x) {
+    int pivot_index = left_index + rand() % (right_index - left_index + 1);
+    SwapPoints(&array[pivot_index], &array[right_index]);
+    pivot_index = right_index;
+    Point pivot_element;
+    pivot_element.x = array[pivot_index].x;
+    pivot_element.y = array[pivot_index].y;
+
+    int i, j;
+    for (i = left_index, j = left_index; i < right_index; i++) {
+        if ((sort_by_x && array[i].x < pivot_element.x) || (!sort_by_x && array[i].y < pivot_element.y)) {
+            SwapPoints(&array[j], &array[i]);
+            j++;
+        }
+    }
+    SwapPoints(&array[pivot_index], &array[j]);
+
+    return j;
+}
+
+void MergeTwoSortedPointArrays(Point arrA[], int arrA_count, Point arrB[], int arrB_count, Point merged_arr[], int sort_by_x) {
+    int i = 0, j = 0, index = 0;
+
+    while (i < arrA_count && j < arrB_count) {
+        if ((sort_by_x && arrA[i].x <= arrB[j].x) || (!sort_by_x && arrA[i].y <= arrB[j].y)) {
+            merged_arr[index].x = arrA[i].x;
+            merged_arr[index].y = arrA[i].y;
+            i++;
+        } else {
+            merged_arr[index].x = arrB[j].x;
+            merged_arr[index].y = arrB[j].y;
+            j++;
+        }
+        index++;
+    }
+
+    while (i < arrA_count) {
+        merged_arr[index].x = arrA[i].x;
+        merged_arr[index].y = arrA[i].y;
+        i++;
+        index++;
+    }
+
+    while (j < arrB_count) {
+        merged_arr[index].x = arrB[j].x;
+        merged_arr[index].y = arrB[j].y;
+        j++;
+        index++;
+    }
+}
+
+// Merges arrB into arrA, which must have room for arrA_count + arrB_count points.
+// Filling from the back never overwrites an unread point of arrA, so no third buffer is needed.
+void MergeSortedPointArraysInPlace(Point arrA[], int arrA_count, const Point arrB[], int arrB_count, int sort_by_x) {
+    int i = arrA_count - 1, j = arrB_count - 1, index = arrA_count + arrB_count - 1;
+
+    while (i >= 0 && j >= 0) {
+        if ((sort_by_x && arrA[i].x > arrB[j].x) || (!sort_by_x && arrA[i].y > arrB[j].y)) {
+            arrA[index--] = arrA[i--];
+        } else {
+            arrA[index--] = arrB[j--];
+        }
+    }
+
+    while (j >= 0) {
+        arrA[index--] = arrB[j--];
+    }
+}
+
+// Branchless merge of a[i..endA) and b[j..endB) into out: the comparison selects the source
+// pointer (a conditional move) instead of a branch. Ties take a first, tails are copied.
+static inline __attribute__((always_inline)) void MergePointRange(const Point a[], size_t i, const size_t endA, const Point b[], size_t j, const size_t endB, Point out[], const int sort_by_x) {
+    const Point *pa = a + i, *pb = b + j;
+    const Point *lastA = a + endA, *lastB = b + endB;
+    while (pa < lastA && pb < lastB) {
+        const int takeB = sort_by_x ? (pb->x < pa->x) : (pb->y < pa->y);
+        const Point* source = takeB ? pb : pa;
+        *out++ = *source;
+        pb += takeB;
+        pa += !takeB;
+    }
+    if (pa < lastA)
+        memmove(out, pa, (lastA - pa) * sizeof(Point));
+    else if (pb < lastB)
+        memcpy(out, pb, (lastB - pb) * sizeof(Point));
+}
+
+// Merge path: the number of points taken from a among the first diagonal outputs
+static size_t MergePathSplit(const Point a[], const size_t countA, const Point b[], const size_t countB, const size_t diagonal, const int sort_by_x) {
+    size_t low = (diagonal > countB) ? diagonal - countB : 0;
+    size_t high = (diagonal < countA) ? diagonal : countA;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const Point* pa = &a[mid];
+        const Point* pb = &b[diagonal - mid - 1];
+        if (sort_by_x ? (pa->x <= pb->x) : (pa->y <= pb->y))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+// Stable merge of two sorted arrays, split by merge path into one independent range per
+// OpenMP thread. out must not overlap b. It may overlap a when a lies at out + countB or
+// later (a run merging in place from the top of its buffer); a later range would then
+// overwrite points an earlier one still reads, so that layout is merged on one thread.
+void ParallelMergePointArrays(const Point a[], const size_t countA, const Point b[], const size_t countB, Point out[], int sort_by_x) {
+    const size_t total = countA + countB;
+    int numParts = 1;
+#ifdef _OPENMP
+    if (total >= CP_PARALLEL_MERGE_MIN && !omp_in_parallel() && !(out < a + countA && a < out + total))
+        numParts = omp_get_max_threads();
+#endif
+    if (numParts <= 1) {
+        if (sort_by_x)
+            MergePointRange(a, 0, countA, b, 0, countB, out, 1);
+        else
+            MergePointRange(a, 0, countA, b, 0, countB, out, 0);
+        return;
+    }
+
+    size_t splits[CP_PARALLEL_MERGE_MAX_PARTS + 1];
+    int part;
+    if (numParts > CP_PARALLEL_MERGE_MAX_PARTS)
+        numParts = CP_PARALLEL_MERGE_MAX_PARTS;
+    for (part = 0; part <= numParts; part++)
+        splits[part] = MergePathSplit(a, countA, b, countB, total / numParts * part + (part == numParts ? total % numParts : 0), sort_by_x);
+
+    #pragma omp parallel for num_threads(numParts) schedule(static, 1)
+    for (part = 0; part < numParts; part++) {
+        const size_t first = total / numParts * part, last = (part + 1 == numParts) ? total : total / numParts * (part + 1);
+        const size_t i = splits[part], endA = splits[part + 1];
+        if (sort_by_x)
+            MergePointRange(a, i, endA, b, first - i, last - endA, out + first, 1);
+        else
+            MergePointRange(a, i, endA, b, first - i, last - endA, out + first, 0);
+    }
+}
+
+static inline int PointPrecedes(const Point* a, const Point* b, const int sort_by_x) {
+    return sort_by_x ? (a->x < b->x) : (a->y < b->y);
+}
+
+// Stable natural merge sort: the array is cut into its ascending (or strictly descending,
+// reversed in place) runs, runs shorter than NATURAL_MIN_RUN are extended by insertion sort,
+// and neighbouring runs are merged pairwise. Sorted or reversed input costs one pass.
+#define NATURAL_MIN_RUN 32
+void NaturalPointSort(Point array[], size_t count, int sort_by_x) {
+    size_t numRuns = 0, maxRuns = count / NATURAL_MIN_RUN + 2, start = 0, i;
+    size_t* runs = (size_t*) malloc((maxRuns + 1) * sizeof(size_t));
+    if (runs == NULL) {
+        QuickPointSort(array, (int)count, sort_by_x);
+        return;
+    }
+
+    runs[0] = 0;
+    while (start < count) {
+        size_t end = start + 1;
+        if (end < count && PointPrecedes(&array[end], &array[start], sort_by_x)) {
+            while (end + 1 < count && PointPrecedes(&array[end + 1], &array[end], sort_by_x))
+                end++;
+            end++;
+            for (i = 0; i < (end - start) / 2; i++)
+                SwapPoints(&array[start + i], &array[end - 1 - i]);
+        } else {
+            while (end < count && !PointPrecedes(&array[end], &array[end - 1], sort_by_x))
+                end++;
+        }
+        if (end - start < NATURAL_MIN_RUN && end < count) {
+            size_t limit = (start + NATURAL_MIN_RUN < count) ? start + NATURAL_MIN_RUN : count;
+            for (; end < limit; end++) {
+                Point value = array[end];
+                size_t j = end;
+                while (j > start && PointPrecedes(&value, &array[j - 1], sort_by_x)) {
+                    array[j] = array[j - 1];
+                    j--;
+                }
+                array[j] = value;
+            }
+        }
+        runs[++numRuns] = end;
+        start = end;
+    }
+    if (numRuns <= 1) {
+        free(runs);
+        return;
+    }
+
+    Point* scratch = allocatePoints(count);
+    if (scratch == NULL) {
+        free(runs);
+        QuickPointSort(array, (int)count, sort_by_x);
+        return;
+    }
+    Point *source = array, *target = scratch;
+    while (numRuns > 1) {
+        for (i = 0; i + 1 < numRuns; i += 2)
+            ParallelMergePointArrays(source + runs[i], runs[i + 1] - runs[i], source + runs[i + 1], runs[i + 2] - runs[i + 1], target + runs[i], sort_by_x);
+        if (numRuns % 2)
+            memcpy(target + runs[numRuns - 1], source + runs[numRuns - 1], (runs[numRuns] - runs[numRuns - 1]) * sizeof(Point));
+        for (i = 0; 2 * i < numRuns; i++)
+            runs[i] = runs[2 * i];
+        runs[(numRuns + 1) / 2] = runs[numRuns];
+        numRuns = (numRuns + 1) / 2;
+        Point* swap = source;
+        source = target;
+        target = swap;
+    }
+    if (source != array)
+        memcpy(array, source, count * sizeof(Point));
+    free(scratch);
+    free(runs);
+}
+
+// NaturalPointSort without allocations, for callers that own scratch memory of count points:
+// blocks of NATURAL_MIN_RUN are sorted by insertion and merged bottom-up, neighbouring blocks
+// already in order are copied instead of merged. Stable.
+void MergePointSort(Point array[], size_t count, int sort_by_x, Point scratch[]) {
+    size_t start, width, i;
+    for (start = 0; start < count; start += NATURAL_MIN_RUN) {
+        const size_t end = (start + NATURAL_MIN_RUN < count) ? start + NATURAL_MIN_RUN : count;
+        for (i = start + 1; i < end; i++) {
+            Point value = array[i];
+            size_t j = i;
+            while (j > start && PointPrecedes(&value, &array[j - 1], sort_by_x)) {
+                array[j] = array[j - 1];
+                j--;
+            }
+            array[j] = value;
+        }
+    }
+    Point *source = array, *target = scratch;
+    for (width = NATURAL_MIN_RUN; width < count; width *= 2) {
+        for (start = 0; start < count; start += 2 * width) {
+            const size_t mid = (start + width < count) ? start + width : count;
+            const size_t end = (start + 2 * width < count) ? start + 2 * width : count;
+            if (mid == end || !PointPrecedes(&source[mid], &source[mid - 1], sort_by_x))
+                memcpy(target + start, source + start, (end - start) * sizeof(Point));
+            else
+                ParallelMergePointArrays(source + start, mid - start, source + mid, end - mid, target + start, sort_by_x);
+        }
+        Point* swap = source;
+        source = target;
+        target = swap;
+    }
+    if (source != array)
+        memcpy(array, source, count * sizeof(Point));
+}
+
+// Binary searches of an array sorted by X: the first point with x >= value (Lower)
+// or x > value (Upper), count when there is none
+size_t LowerBoundPointsX(const Point array[], const size_t count, const double x)
+{
+    size_t low = 0, high = count;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (array[middle].x < x)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+size_t UpperBoundPointsX(const Point array[], const size_t count, const double x)
+{
+    size_t low = 0, high = count;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (array[middle].x <= x)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+int IsSortingPointsCorrect(Point array[], int arr_count, int* j, int sort_by_x) {
+    if (j != NULL) 
+        *j = -1;
+        
+    int i;
+    for (i = 0; i < arr_count - 1; i++) {
+        if ((sort_by_x && array[i].x > array[i + 1].x) || (!sort_by_x && array[i].y > array[i + 1].y)) {
+            if (j != NULL) *j = i;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void PrintPointArray(Point array[], int arr_count) {
+    if (array == NULL){
+        printf("Array is NULL!\n");
+        return;
+    }
+    int i;
+    for (i = 0; i < arr_count; i++) {
+        printf("arr[%d]: (%15.10lf, %15.10lf)\n", i, array[i].x, array[i].y);
+    }
+}
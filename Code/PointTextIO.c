@@ -0,0 +1,455 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "PointTextIO.h"
+#include "NumaPlacement.h"
+
+#define TEXT_ERROR_SIZE 160
+
+static const double powersOf10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const uint64_t integerPowersOf10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static inline unsigned __int128 widePowerOf10(const int q)
+{
+    return (q < 20) ? (unsigned __int128)integerPowersOf10[q] : (unsigned __int128)integerPowersOf10[19] * integerPowersOf10[q - 19];
+}
+
+static inline int isBlank(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// mantissa / 10^q, correctly rounded for q <= 21: the quotient keeps at least two bits
+// below the double's precision and the remainder is folded into the lowest one
+static double divideByPowerOf10(const uint64_t mantissa, const int q)
+{
+    const unsigned __int128 divisor = widePowerOf10(q);
+    const uint64_t high = (uint64_t)(divisor >> 64);
+    const int divisorBits = high ? 128 - __builtin_clzll(high) : 64 - __builtin_clzll((uint64_t)divisor);
+    int shift = 56 + divisorBits - (64 - __builtin_clzll(mantissa));
+    if (shift < 0)
+        shift = 0;
+    const unsigned __int128 numerator = (unsigned __int128)mantissa << shift;
+    const unsigned __int128 quotient = numerator / divisor;
+    const int sticky = (numerator % divisor) != 0;
+    return ldexp((double)(quotient | sticky), -shift);
+}
+
+// Anything the exact paths do not cover (more than 19 digits, huge exponents, inf, nan)
+static const char* parseDoubleSlow(const char* start, const char* end, double* value)
+{
+    char buffer[64];
+    size_t length = 0;
+    while (start + length < end && length < sizeof(buffer) - 1 && !isBlank(start[length]) && start[length] != '\n')
+        length++;
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    char* stop;
+    *value = strtod(buffer, &stop);
+    return (stop == buffer) ? NULL : start + (stop - buffer);
+}
+
+const char* parseDouble(const char* p, const char* end, double* value)
+{
+    const char* start = p;
+    int negative = 0, digits = 0, exp10 = 0, anyDigit = 0, truncated = 0;
+    uint64_t mantissa = 0;
+    unsigned d;
+
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    for (; p < end && (d = (unsigned)(*p - '0')) < 10; p++, anyDigit = 1) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + d;
+            digits += (mantissa != 0);
+        } else {
+            exp10++;
+            truncated |= (d != 0);
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && (d = (unsigned)(*p - '0')) < 10; p++, anyDigit = 1) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + d;
+                digits += (mantissa != 0);
+                exp10--;
+            } else {
+                truncated |= (d != 0);
+            }
+        }
+    }
+    if (!anyDigit)
+        return parseDoubleSlow(start, end, value);
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        int sign = 1, exponent = 0;
+        if (q < end && (*q == '-' || *q == '+'))
+            sign = (*q++ == '-') ? -1 : 1;
+        if (q < end && (unsigned)(*q - '0') < 10) {
+            for (; q < end && (d = (unsigned)(*q - '0')) < 10; q++)
+                if (exponent < 100000)
+                    exponent = exponent * 10 + d;
+            exp10 += sign * exponent;
+            p = q;
+        }
+    }
+
+    double result;
+    if (truncated)
+        return parseDoubleSlow(start, end, value);
+    if (mantissa == 0)
+        result = 0.0;
+    else if (mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22)
+        result = (exp10 < 0) ? (double)mantissa / powersOf10[-exp10] : (double)mantissa * powersOf10[exp10];
+    else if (exp10 < 0 && exp10 >= -21)
+        result = divideByPowerOf10(mantissa, -exp10);
+    else if (exp10 >= 0 && exp10 <= 19)
+        result = (double)((unsigned __int128)mantissa * integerPowersOf10[exp10]);
+    else
+        return parseDoubleSlow(start, end, value);
+    *value = negative ? -result : result;
+    return p;
+}
+
+// Writes mantissa (numDigits digits) * 10^(exponent - numDigits + 1)
+static int writeDecimal(char* buffer, const int negative, uint64_t mantissa, int numDigits, const int exponent)
+{
+    char digits[20];
+    int i, length = 0;
+    for (i = numDigits - 1; i >= 0; i--, mantissa /= 10)
+        digits[i] = (char)('0' + mantissa % 10);
+    if (negative)
+        buffer[length++] = '-';
+
+    if (exponent >= 0 && exponent < 16) {
+        for (i = 0; i <= exponent; i++)
+            buffer[length++] = (i < numDigits) ? digits[i] : '0';
+        if (numDigits > exponent + 1) {
+            buffer[length++] = '.';
+            for (; i < numDigits; i++)
+                buffer[length++] = digits[i];
+        }
+    } else if (exponent < 0 && exponent >= -5) {
+        buffer[length++] = '0';
+        buffer[length++] = '.';
+        for (i = -1; i > exponent; i--)
+            buffer[length++] = '0';
+        for (i = 0; i < numDigits; i++)
+            buffer[length++] = digits[i];
+    } else {
+        buffer[length++] = digits[0];
+        if (numDigits > 1) {
+            buffer[length++] = '.';
+            for (i = 1; i < numDigits; i++)
+                buffer[length++] = digits[i];
+        }
+        length += sprintf(buffer + length, "e%+03d", exponent);
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+// Shortest of 15, 16 and 17 significant digits that reads back as the same double
+int formatDouble(const double value, char* buffer)
+{
+    const double magnitude = fabs(value);
+    int precision;
+    if (!isfinite(value) || magnitude < 1e-300 || magnitude > 1e300)
+        return snprintf(buffer, CP_TEXT_NUMBER_SIZE, "%.17g", value);
+
+    int exponent = (int)floor(log10(magnitude));
+    for (precision = 15; precision <= 17; precision++) {
+        const int scale = precision - 1 - exponent;
+        if (scale < -22 || scale > 22)
+            break;
+        double scaled = (scale >= 0) ? magnitude * powersOf10[scale] : magnitude / powersOf10[-scale];
+        uint64_t mantissa = (uint64_t)(scaled + 0.5);
+        int e = exponent, numDigits = precision;
+        if (mantissa >= integerPowersOf10[precision]) {
+            // Rounding carried into one more digit
+            mantissa = (mantissa + 5) / 10;
+            e++;
+        } else if (mantissa < integerPowersOf10[precision - 1]) {
+            // log10 landed one decade too high
+            exponent--;
+            precision--;
+            continue;
+        }
+        while (numDigits > 1 && mantissa % 10 == 0) {
+            mantissa /= 10;
+            numDigits--;
+        }
+
+        int length = writeDecimal(buffer, value < 0, mantissa, numDigits, e);
+        double check;
+        if (parseDouble(buffer, buffer + length, &check) != NULL && check == value)
+            return length;
+    }
+    return snprintf(buffer, CP_TEXT_NUMBER_SIZE, "%.17g", value);
+}
+
+static const char* skipBlanks(const char* p, const char* end, size_t* line)
+{
+    for (; p < end && (isBlank(*p) || *p == '\n'); p++)
+        *line += (*p == '\n');
+    return p;
+}
+
+int parsePointsHeaderText(const char* data, const size_t size, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions, int* sortedX, size_t* bodyOffset)
+{
+    const char* end = data + size;
+    const char* p = data;
+    size_t line = 1;
+    double* bounds[4] = {minX, maxX, minY, maxY};
+    int i;
+
+    p = skipBlanks(p, end, &line);
+    const char* digits = p;
+    for (*numPoints = 0; p < end && (unsigned)(*p - '0') < 10; p++)
+        *numPoints = *numPoints * 10 + (size_t)(*p - '0');
+    if (p == digits || (p < end && !isBlank(*p) && *p != '\n')) {
+        fprintf(stderr, "Line %zu: expected the number of points.\n", line);
+        return -3;
+    }
+    for (i = 0; i < 4; i++) {
+        p = skipBlanks(p, end, &line);
+        p = parseDouble(p, end, bounds[i]);
+        if (p == NULL || (p < end && !isBlank(*p) && *p != '\n')) {
+            fprintf(stderr, "Line %zu: expected minX maxX minY maxY.\n", line);
+            return -3;
+        }
+    }
+    p = skipBlanks(p, end, &line);
+    for (*dimensions = 0; p < end && (unsigned)(*p - '0') < 10 && *dimensions < 1000000; p++)
+        *dimensions = *dimensions * 10 + (*p - '0');
+    while (p < end && isBlank(*p))
+        p++;
+    // Optional flag after the dimension: the points are sorted by X
+    const size_t tagLength = strlen(CP_TEXT_SORTED_X_TAG);
+    int sorted = 0;
+    if ((size_t)(end - p) >= tagLength && memcmp(p, CP_TEXT_SORTED_X_TAG, tagLength) == 0) {
+        sorted = 1;
+        p += tagLength;
+        while (p < end && isBlank(*p))
+            p++;
+    }
+    if (*dimensions <= 0 || (p < end && *p != '\n')) {
+        fprintf(stderr, "Line %zu: expected the number of dimensions.\n", line);
+        return -3;
+    }
+    if (sortedX != NULL)
+        *sortedX = sorted;
+    *bodyOffset = (p < end) ? (size_t)(p + 1 - data) : size;
+    return 0;
+}
+
+// A chunk of point lines, parsed by one thread
+typedef struct {
+    size_t begin, end;     // Byte range, begins at a line start
+    size_t firstPoint;     // Index of the point on its first line
+    size_t numLines;
+    size_t errorLine;      // 0 when the chunk parsed cleanly
+    char error[TEXT_ERROR_SIZE];
+} TextChunk;
+
+static void parseChunk(const char* body, TextChunk* chunk, Point points[], const size_t numPoints, const size_t firstLine)
+{
+    const char* p = body + chunk->begin;
+    const char* end = body + chunk->end;
+    size_t index = chunk->firstPoint;
+    for (; p < end; index++) {
+        const char* lineStart = p;
+        while (p < end && isBlank(*p))
+            p++;
+        if (index >= numPoints) {
+            if (p < end && *p != '\n') {
+                chunk->errorLine = firstLine + index;
+                snprintf(chunk->error, TEXT_ERROR_SIZE, "expected %zu points, found more", numPoints);
+                return;
+            }
+        } else {
+            const char* q = parseDouble(p, end, &points[index].x);
+            if (q != NULL && q < end && isBlank(*q)) {
+                while (q < end && isBlank(*q))
+                    q++;
+                q = parseDouble(q, end, &points[index].y);
+            } else {
+                q = NULL;
+            }
+            while (q != NULL && q < end && isBlank(*q))
+                q++;
+            if (q == NULL || (q < end && *q != '\n')) {
+                const char* lineEnd = memchr(lineStart, '\n', end - lineStart);
+                int shown = (int)((lineEnd ? lineEnd : end) - lineStart);
+                chunk->errorLine = firstLine + index;
+                snprintf(chunk->error, TEXT_ERROR_SIZE, "expected \"x y\" for point %zu, found \"%.*s\"", index, shown > 60 ? 60 : shown, lineStart);
+                return;
+            }
+            p = q;
+        }
+        p = memchr(p, '\n', end - p);
+        if (p == NULL)
+            break;
+        p++;
+    }
+}
+
+int parsePointsText(const char* data, const size_t size, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions)
+{
+    size_t bodyOffset, c, i;
+    int errcode = parsePointsHeaderText(data, size, numPoints, minX, maxX, minY, maxY, dimensions, NULL, &bodyOffset);
+    if (errcode)
+        return errcode;
+    if (*dimensions != 2) {
+        fprintf(stderr, "Expected 2-dimensional points, the file has %d dimensions.\n", *dimensions);
+        return -4;
+    }
+
+    // Line number of the first point: one past the newlines of the header
+    size_t firstLine = 1;
+    for (i = 0; i < bodyOffset; i++)
+        firstLine += (data[i] == '\n');
+
+    const char* body = data + bodyOffset;
+    const size_t bodySize = size - bodyOffset;
+    int numChunks = 1;
+#ifdef _OPENMP
+    if (bodySize >= CP_TEXT_PARALLEL_BYTES)
+        numChunks = omp_get_max_threads();
+#endif
+    *points = allocatePoints(*numPoints + 1);
+    TextChunk* chunks = (TextChunk*) calloc(numChunks, sizeof(TextChunk));
+    if (*points == NULL || chunks == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(*points); *points = NULL;
+        free(chunks);
+        return -2;
+    }
+
+    // Chunk borders move forward to the next line start
+    for (c = 0; c < (size_t)numChunks; c++) {
+        size_t begin = bodySize / numChunks * c;
+        if (c > 0) {
+            const char* newline = memchr(body + begin, '\n', bodySize - begin);
+            begin = newline ? (size_t)(newline + 1 - body) : bodySize;
+            if (begin < chunks[c - 1].begin)
+                begin = chunks[c - 1].begin;
+        }
+        chunks[c].begin = begin;
+    }
+    for (c = 0; c < (size_t)numChunks; c++)
+        chunks[c].end = (c + 1 < (size_t)numChunks) ? chunks[c + 1].begin : bodySize;
+
+    // Pass 1 counts the lines of every chunk, pass 2 parses them into their final slots
+    long k;
+    #pragma omp parallel for schedule(static, 1)
+    for (k = 0; k < numChunks; k++) {
+        const char* p = body + chunks[k].begin;
+        const char* end = body + chunks[k].end;
+        while (p < end && (p = memchr(p, '\n', end - p)) != NULL) {
+            chunks[k].numLines++;
+            p++;
+        }
+        if (chunks[k].end > chunks[k].begin && body[chunks[k].end - 1] != '\n')
+            chunks[k].numLines++;
+    }
+    size_t numLines = 0;
+    for (c = 0; c < (size_t)numChunks; c++) {
+        chunks[c].firstPoint = numLines;
+        numLines += chunks[c].numLines;
+    }
+    #pragma omp parallel for schedule(static, 1)
+    for (k = 0; k < numChunks; k++)
+        parseChunk(body, &chunks[k], *points, *numPoints, firstLine);
+
+    errcode = 0;
+    for (c = 0; c < (size_t)numChunks && errcode == 0; c++) {
+        if (chunks[c].errorLine) {
+            fprintf(stderr, "Line %zu: %s.\n", chunks[c].errorLine, chunks[c].error);
+            errcode = -3;
+        }
+    }
+    if (errcode == 0 && numLines < *numPoints) {
+        fprintf(stderr, "Line %zu: expected %zu points, the file ends after %zu.\n", firstLine + numLines, *numPoints, numLines);
+        errcode = -3;
+    }
+    free(chunks);
+    if (errcode) {
+        free(*points); *points = NULL;
+    }
+    return errcode;
+}
+
+// Parses complete point lines into points[firstPoint...] for loaders that feed the body in
+// pieces; numLines receives the number of lines consumed, firstLine is the line of point 0
+int parsePointLines(const char* data, const size_t size, Point points[], const size_t firstPoint, const size_t numPoints, const size_t firstLine, size_t* numLines)
+{
+    TextChunk chunk;
+    const char* p = data;
+    const char* end = data + size;
+    memset(&chunk, 0, sizeof(chunk));
+    chunk.end = size;
+    chunk.firstPoint = firstPoint;
+    while (p < end && (p = memchr(p, '\n', end - p)) != NULL) {
+        chunk.numLines++;
+        p++;
+    }
+    if (size > 0 && data[size - 1] != '\n')
+        chunk.numLines++;
+    parseChunk(data, &chunk, points, numPoints, firstLine);
+    *numLines = chunk.numLines;
+    if (chunk.errorLine) {
+        fprintf(stderr, "Line %zu: %s.\n", chunk.errorLine, chunk.error);
+        return -3;
+    }
+    return 0;
+}
+
+int mapTextFile(const char* filename, const char** data, size_t* size)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening file.\n");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "Error opening file.\n");
+        close(fd);
+        return -1;
+    }
+
+    *size = st.st_size;
+    *data = NULL;
+    if (*size > 0) {
+        void* mapped = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            fprintf(stderr, "Error mapping file.\n");
+            close(fd);
+            return -1;
+        }
+        madvise(mapped, *size, MADV_SEQUENTIAL);
+        *data = (const char*) mapped;
+    }
+    close(fd);
+    return 0;
+}
+
+void unmapTextFile(const char* data, const size_t size)
+{
+    if (data != NULL)
+        munmap((void*) data, size);
+}
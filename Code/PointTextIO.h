@@ -0,0 +1,28 @@
+#ifndef PointTextIO_h
+
+#define PointTextIO_h
+#include <stdint.h>
+#include "PointSortUtilities.h"
+
+// Locale-independent parsing and formatting of the text .dat format.
+//  - parseDouble converts exactly: one floating-point operation for short inputs,
+//    128-bit integer division for up to 19 significant digits, strtod beyond that.
+//  - formatDouble writes the shortest decimal that parses back to the same double.
+//  - parsePointsText reads a whole file image, split across OpenMP threads on line
+//    boundaries. After the header, line k holds point k; errors name the line.
+//  - The dimension line may end in CP_TEXT_SORTED_X_TAG when the points are sorted by X,
+//    which lets the sorting loaders skip the sort once a linear pass confirms the order.
+#define CP_TEXT_NUMBER_SIZE 32        // Longest formatDouble output, with the terminator
+#define CP_TEXT_SORTED_X_TAG "sorted-x"
+#define CP_TEXT_PARALLEL_BYTES (1 << 20) // Smaller bodies are parsed on one thread
+
+// Definition
+const char* parseDouble(const char* p, const char* end, double* value);
+int formatDouble(const double value, char* buffer);
+int parsePointsHeaderText(const char* data, const size_t size, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions, int* sortedX, size_t* bodyOffset);
+int parsePointsText(const char* data, const size_t size, Point** points, size_t *numPoints, double *minX, double *maxX, double *minY, double *maxY, int *dimensions);
+int parsePointLines(const char* data, const size_t size, Point points[], const size_t firstPoint, const size_t numPoints, const size_t firstLine, size_t* numLines);
+int mapTextFile(const char* filename, const char** data, size_t* size);
+void unmapTextFile(const char* data, const size_t size);
+
+#endif
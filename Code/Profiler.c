@@ -0,0 +1,203 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#endif
+#include "Profiler.h"
+
+typedef struct {
+    char name[CP_PROFILE_NAME_SIZE];
+    double seconds;
+    unsigned long long counts[CP_PROFILE_EVENTS];
+} ProfilePhase;
+
+static struct {
+    int enabled;
+    int fds[CP_PROFILE_EVENTS];
+    ProfilePhase phases[CP_PROFILE_MAX_PHASES];
+    int numPhases;
+    int current;      // Phase being measured, -1 between phases
+    double start;
+    unsigned long long startCounts[CP_PROFILE_EVENTS];
+} profiler = { .current = -1 };
+
+// Wall-clock seconds from a monotonic clock
+double wallSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+static void readCounters(unsigned long long counts[])
+{
+    int e;
+    for (e = 0; e < CP_PROFILE_EVENTS; e++) {
+        uint64_t value = 0;
+        if (profiler.fds[e] < 0 || read(profiler.fds[e], &value, sizeof(value)) != sizeof(value))
+            value = 0;
+        counts[e] = value;
+    }
+}
+
+int profileInit(const int enabled)
+{
+    int e, opened = 0;
+    memset(&profiler, 0, sizeof(profiler));
+    profiler.current = -1;
+    for (e = 0; e < CP_PROFILE_EVENTS; e++)
+        profiler.fds[e] = -1;
+    profiler.enabled = enabled;
+    if (!enabled)
+        return 0;
+
+#if defined(__linux__) && defined(SYS_perf_event_open)
+    static const struct { uint32_t type; uint64_t config; } events[CP_PROFILE_EVENTS] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    };
+    int reason = 0;
+    for (e = 0; e < CP_PROFILE_EVENTS; e++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[e].type;
+        attr.config = events[e].config;
+        attr.exclude_kernel = 1;  // Allowed at perf_event_paranoid 2
+        attr.exclude_hv = 1;
+        attr.inherit = 1;         // Threads created later are counted too
+        profiler.fds[e] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (profiler.fds[e] < 0)
+            reason = errno;
+        else
+            opened++;
+    }
+    if (opened < CP_PROFILE_EVENTS)
+        fprintf(stderr, "Profile: %d of %d counters available (%s), the others are reported as n/a.\n",
+                opened, CP_PROFILE_EVENTS, strerror(reason));
+#else
+    fprintf(stderr, "Profile: performance counters are not supported on this system, only times are reported.\n");
+#endif
+    return opened;
+}
+
+int profileEnabled(void)
+{
+    return profiler.enabled;
+}
+
+void profileBegin(const char* phase)
+{
+    int p;
+    if (!profiler.enabled)
+        return;
+    if (profiler.current >= 0)
+        profileEnd();
+    for (p = 0; p < profiler.numPhases && strncmp(profiler.phases[p].name, phase, CP_PROFILE_NAME_SIZE - 1) != 0; p++)
+        ;
+    if (p == profiler.numPhases) {
+        if (p == CP_PROFILE_MAX_PHASES)
+            return;
+        strncpy(profiler.phases[p].name, phase, CP_PROFILE_NAME_SIZE - 1);
+        profiler.numPhases++;
+    }
+    profiler.current = p;
+    readCounters(profiler.startCounts);
+    profiler.start = wallSeconds();
+}
+
+void profileEnd(void)
+{
+    int e;
+    if (!profiler.enabled || profiler.current < 0)
+        return;
+    const double end = wallSeconds();
+    unsigned long long counts[CP_PROFILE_EVENTS];
+    readCounters(counts);
+    ProfilePhase* phase = &profiler.phases[profiler.current];
+    phase->seconds += end - profiler.start;
+    for (e = 0; e < CP_PROFILE_EVENTS; e++)
+        phase->counts[e] += counts[e] - profiler.startCounts[e];
+    profiler.current = -1;
+}
+
+// Names and CP_PROFILE_VALUES per phase, an unavailable event as -1, for gathering
+// across ranks. Returns the number of phases.
+int profileExport(char names[][CP_PROFILE_NAME_SIZE], double values[])
+{
+    int p, e;
+    profileEnd();
+    memset(names, 0, CP_PROFILE_MAX_PHASES * CP_PROFILE_NAME_SIZE);
+    for (p = 0; p < profiler.numPhases; p++) {
+        memcpy(names[p], profiler.phases[p].name, CP_PROFILE_NAME_SIZE);
+        for (e = 0; e < CP_PROFILE_EVENTS; e++)
+            values[p * CP_PROFILE_VALUES + e] = (profiler.fds[e] < 0) ? -1.0 : (double) profiler.phases[p].counts[e];
+        values[p * CP_PROFILE_VALUES + CP_PROFILE_EVENTS] = profiler.phases[p].seconds;
+    }
+    return profiler.numPhases;
+}
+
+static void printCount(FILE* file, const char* name, const double value)
+{
+    if (value < 0)
+        fprintf(file, " %s=n/a", name);
+    else
+        fprintf(file, " %s=%.0f", name, value);
+}
+
+static void printRatio(FILE* file, const char* name, const double numerator, const double denominator, const double scale)
+{
+    if (numerator < 0 || denominator <= 0)
+        fprintf(file, " %s=n/a", name);
+    else
+        fprintf(file, " %s=%.4f", name, scale * numerator / denominator);
+}
+
+// One line per phase: counts, IPC, misses per thousand instructions and CPU utilization
+void profilePrint(FILE* file, const int rank, const int numPhases, const char names[][CP_PROFILE_NAME_SIZE], const double values[])
+{
+    int p;
+    for (p = 0; p < numPhases; p++) {
+        const double* v = values + p * CP_PROFILE_VALUES;
+        const double seconds = v[CP_PROFILE_EVENTS];
+        fprintf(file, "Profile: rank=%d phase=%s seconds=%.6f", rank, names[p], seconds);
+        printCount(file, "cycles", v[CP_PROFILE_CYCLES]);
+        printCount(file, "instructions", v[CP_PROFILE_INSTRUCTIONS]);
+        printCount(file, "llc_misses", v[CP_PROFILE_LLC_MISSES]);
+        printCount(file, "branch_misses", v[CP_PROFILE_BRANCH_MISSES]);
+        printRatio(file, "ipc", v[CP_PROFILE_INSTRUCTIONS], v[CP_PROFILE_CYCLES], 1.0);
+        printRatio(file, "llc_mpki", v[CP_PROFILE_LLC_MISSES], v[CP_PROFILE_INSTRUCTIONS], 1000.0);
+        printRatio(file, "branch_mpki", v[CP_PROFILE_BRANCH_MISSES], v[CP_PROFILE_INSTRUCTIONS], 1000.0);
+        printRatio(file, "cpus", v[CP_PROFILE_TASK_CLOCK], seconds, 1e-9);
+        fprintf(file, "\n");
+    }
+}
+
+// The phases of this process only
+void profilePrintAll(FILE* file)
+{
+    char names[CP_PROFILE_MAX_PHASES][CP_PROFILE_NAME_SIZE];
+    double values[CP_PROFILE_MAX_PHASES * CP_PROFILE_VALUES];
+    if (!profiler.enabled)
+        return;
+    const int numPhases = profileExport(names, values);
+    profilePrint(file, 0, numPhases, names, values);
+}
+
+void profileClose(void)
+{
+    int e;
+    profileEnd();
+    for (e = 0; e < CP_PROFILE_EVENTS; e++)
+        if (profiler.fds[e] >= 0)
+            close(profiler.fds[e]);
+    profiler.enabled = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef Profiler_h
+
+#define Profiler_h
+#include <stdio.h>
+
+// Per-phase hardware counters for --profile (Linux perf_event_open).
+// One set of counters is opened for the process, counting user space of every thread
+// it starts afterwards (OpenMP workers included); profileBegin/profileEnd read them at
+// the phase boundaries and add the difference to the named phase, so a phase entered
+// several times accumulates. Events the kernel refuses (containers, virtual machines,
+// perf_event_paranoid) are reported as n/a and the wall time is always kept.
+// Phases do not nest: beginning one ends the phase being measured.
+#define CP_PROFILE_MAX_PHASES 12
+#define CP_PROFILE_NAME_SIZE 16
+#define CP_PROFILE_CYCLES 0
+#define CP_PROFILE_INSTRUCTIONS 1
+#define CP_PROFILE_LLC_MISSES 2
+#define CP_PROFILE_BRANCH_MISSES 3
+#define CP_PROFILE_TASK_CLOCK 4    // CPU time of all threads, in nanoseconds
+#define CP_PROFILE_EVENTS 5
+#define CP_PROFILE_VALUES (CP_PROFILE_EVENTS + 1)  // Exported per phase: the events, then the wall time
+
+// Definition
+int profileInit(const int enabled);
+int profileEnabled(void);
+void profileBegin(const char* phase);
+void profileEnd(void);
+int profileExport(char names[][CP_PROFILE_NAME_SIZE], double values[]);
+void profilePrint(FILE* file, const int rank, const int numPhases, const char names[][CP_PROFILE_NAME_SIZE], const double values[]);
+void profilePrintAll(FILE* file);
+void profileClose(void);
+double wallSeconds(void);
+
+#endif
@@ -0,0 +1,77 @@
+#include "DifferentialCases.h"
+#include "ClosestPairApprox.h"
+
+// Maximum disagreement with the exact distance, in units in the last place
+#define MAX_ULP 4
+
+static const double epsilons[] = {0.0, 0.01, 0.5, 2.0};
+
+// lowerBound <= exact <= distance <= (1 + epsilon) lowerBound, up to rounding; epsilon = 0 is exact
+static int checkApprox(const Point points[], const size_t numPoints, const double exact, const char* distribution, const unsigned int seed)
+{
+    size_t e;
+    int failures = 0;
+    for (e = 0; e < sizeof(epsilons) / sizeof(epsilons[0]); e++) {
+        double distance, lowerBound;
+        if (closestPairApprox(points, numPoints, epsilons[e], &distance, &lowerBound) != 0) {
+            printf("FAIL %s n=%zu seed=%u epsilon=%g: solver failed\n", distribution, numPoints, seed, epsilons[e]);
+            failures++;
+            continue;
+        }
+        int below = lowerBound <= exact || ulpDistance(lowerBound, exact) <= MAX_ULP;
+        int above = exact <= distance || ulpDistance(distance, exact) <= MAX_ULP;
+        int within = distance <= (1.0 + epsilons[e]) * lowerBound * (1.0 + MAX_ULP * DBL_EPSILON);
+        int exactMatch = epsilons[e] > 0.0 || ulpDistance(distance, exact) <= MAX_ULP;
+        if (!below || !above || !within || !exactMatch) {
+            printf("FAIL %s n=%zu seed=%u epsilon=%g: [%.17g, %.17g] vs exact %.17g\n",
+                   distribution, numPoints, seed, epsilons[e], lowerBound, distance, exact);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main(void)
+{
+    size_t c, numPoints;
+    int failures = 0;
+    const char* distribution;
+    unsigned int seed;
+
+    for (c = 0; c < DIFFERENTIAL_NUM_CASES; c++) {
+        Point* points = NULL;
+        if (buildDifferentialCase(c, &points, &numPoints, &distribution, &seed)) {
+            printf("FAIL %s n=%zu seed=%u: input generation failed\n", distribution, numPoints, seed);
+            failures++;
+            continue;
+        }
+        double reference;
+        closestPairBruteForce(points, numPoints, &reference);
+        failures += checkApprox(points, numPoints, reference, distribution, seed);
+        free(points);
+    }
+
+    // Inputs large enough for the grid rebuilds around crowded cells, against closestPairDAC
+    const char* largeDistributions[] = {"uniform", "clustered", "duplicates", "collinear"};
+    size_t d;
+    for (d = 0; d < sizeof(largeDistributions) / sizeof(largeDistributions[0]); d++) {
+        Point* points = NULL;
+        numPoints = 200000;
+        srand(2024);
+        if (generatePointsByDistribution(&points, numPoints, 0.0, 1.0, 0.0, 1.0, largeDistributions[d])) {
+            printf("FAIL %s n=%zu: input generation failed\n", largeDistributions[d], numPoints);
+            failures++;
+            continue;
+        }
+        double reference;
+        Point* copy = (Point*) malloc(numPoints * sizeof(Point));
+        memcpy(copy, points, numPoints * sizeof(Point));
+        closestPairDAC(copy, numPoints, &reference);
+        free(copy);
+        failures += checkApprox(points, numPoints, reference, largeDistributions[d], 2024);
+        free(points);
+    }
+
+    printf("%zu cases, %d failures\n", (size_t)DIFFERENTIAL_NUM_CASES + sizeof(largeDistributions) / sizeof(largeDistributions[0]), failures);
+    return failures ? 1 : 0;
+}
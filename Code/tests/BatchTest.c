@@ -0,0 +1,107 @@
+#include <stdint.h>
+#include <unistd.h>
+#include "DifferentialCases.h"
+#include "ClosestPairBatch.h"
+
+// Instances of 0 to maxSize points; every fifth one on a coarse grid, with repeated points
+static Point* randomBatch(uint64_t* state, const size_t numInstances, const size_t maxSize, uint64_t offsets[])
+{
+    size_t i, k;
+    offsets[0] = 0;
+    for (k = 0; k < numInstances; k++)
+        offsets[k + 1] = offsets[k] + nextRandom(state) % (maxSize + 1);
+    Point* points = (Point*) malloc((offsets[numInstances] + 1) * sizeof(Point));
+    for (k = 0; k < numInstances; k++) {
+        for (i = offsets[k]; i < offsets[k + 1]; i++) {
+            if (k % 5 == 0) {
+                points[i].x = (double)(nextRandom(state) % 16);
+                points[i].y = (double)(nextRandom(state) % 16);
+            } else {
+                points[i].x = (double)(nextRandom(state) >> 11) / 9007199254740992.0;
+                points[i].y = (double)(nextRandom(state) >> 11) / 9007199254740992.0;
+            }
+        }
+    }
+    return points;
+}
+
+// Batch solver and batch format against closestPairBruteForce, instance by instance
+int main(void)
+{
+    const char* path = "batch_test.cpb";
+    const size_t numInstances = 600, maxSize = 300;
+    const size_t bruteForceMax[] = {0, CP_BATCH_BRUTE_FORCE_MAX, SIZE_MAX};
+    uint64_t state = 88172645463325252ULL;
+    uint64_t* offsets = (uint64_t*) malloc((numInstances + 1) * sizeof(uint64_t));
+    double* distances = (double*) malloc(numInstances * sizeof(double));
+    size_t k, b;
+    int failures = 0, part, parts;
+
+    Point* points = randomBatch(&state, numInstances, maxSize, offsets);
+    if (writePointBatch(path, points, offsets, numInstances)) {
+        printf("FAIL write failed\n");
+        return 1;
+    }
+
+    for (b = 0; b < sizeof(bruteForceMax) / sizeof(bruteForceMax[0]); b++) {
+        BatchIndex index;
+        Point* read = NULL;
+        if (readPointBatch(path, &index, &read) || index.numInstances != numInstances || index.numPoints != offsets[numInstances] ||
+            memcmp(index.offsets, offsets, (numInstances + 1) * sizeof(uint64_t)) != 0 ||
+            memcmp(read, points, offsets[numInstances] * sizeof(Point)) != 0) {
+            printf("FAIL batch file does not round trip\n");
+            return 1;
+        }
+        if (closestPairBatch(read, index.offsets, numInstances, bruteForceMax[b], distances)) {
+            printf("FAIL batch solver failed\n");
+            return 1;
+        }
+        for (k = 0; k < numInstances; k++) {
+            double expected;
+            closestPairBruteForce(points + offsets[k], offsets[k + 1] - offsets[k], &expected);
+            if (distances[k] != expected && failures < 5) {
+                printf("FAIL bruteForceMax=%zu instance %zu of %lu points: %.17g, expected %.17g\n",
+                       bruteForceMax[b], k, (unsigned long)(offsets[k + 1] - offsets[k]), distances[k], expected);
+                failures++;
+            }
+        }
+        freeBatchIndex(&index);
+        free(read);
+    }
+
+    // The parts of a partition cover every instance once, in order
+    for (parts = 1; parts <= 7; parts++) {
+        size_t next = 0, first, last;
+        for (part = 0; part < parts; part++) {
+            partitionBatch(offsets, numInstances, CP_BATCH_BRUTE_FORCE_MAX, part, parts, &first, &last);
+            if (first != next && first != last) {
+                printf("FAIL part %d of %d starts at %zu, expected %zu\n", part, parts, first, next);
+                failures++;
+            }
+            next = (first == last) ? next : last;
+        }
+        if (next != numInstances) {
+            printf("FAIL %d parts end at %zu of %zu instances\n", parts, next, numInstances);
+            failures++;
+        }
+    }
+
+    // Offsets past the points are rejected
+    {
+        BatchIndex index;
+        offsets[numInstances] += 1;
+        writePointBatch(path, points, offsets, numInstances);
+        if (truncate(path, 24 + (numInstances + 1) * sizeof(uint64_t) + (offsets[numInstances] - 1) * sizeof(Point)) != 0 ||
+            readBatchIndex(path, &index) != -3) {
+            printf("FAIL corrupt batch accepted\n");
+            failures++;
+        }
+    }
+    remove(path);
+
+    free(points);
+    free(offsets);
+    free(distances);
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,29 @@
+# Runs a solver and a reference solver on the same sample and compares the reported distances
+# (and, for --batch, the distance of every instance; for --radius, the pair count and checksum).
+# Usage: cmake -DREFERENCE=<cmd> -DCANDIDATE=<cmd> -DSAMPLE=<file> -DWORK_DIR=<dir> -P CompareSolvers.cmake
+# REFERENCE and CANDIDATE are |-separated so that an mpiexec prefix can be passed along.
+
+function(read_distance command result_file out_var)
+    string(REPLACE "|" ";" command "${command}")
+    list(REMOVE_ITEM command "")
+    execute_process(COMMAND ${command} ${SAMPLE} ${result_file} RESULT_VARIABLE status OUTPUT_QUIET)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "${command} failed with ${status}")
+    endif()
+    file(STRINGS ${result_file} line REGEX "The closest pair distance is")
+    string(REGEX REPLACE ".*is[ ]+([0-9.eE+-]+).*" "\\1" distance "${line}")
+    file(STRINGS ${result_file} instances REGEX "^Instance |^Pairs ")
+    set(${out_var} ${distance} PARENT_SCOPE)
+    set(${out_var}_instances "${instances}" PARENT_SCOPE)
+endfunction()
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+read_distance("${REFERENCE}" ${WORK_DIR}/reference.dat reference)
+read_distance("${CANDIDATE}" ${WORK_DIR}/candidate.dat candidate)
+if(NOT "${reference}" STREQUAL "${candidate}")
+    message(FATAL_ERROR "Distance mismatch on ${SAMPLE}: ${candidate} vs reference ${reference}")
+endif()
+if(NOT reference_instances STREQUAL candidate_instances)
+    message(FATAL_ERROR "Instance distances or pairs differ on ${SAMPLE}")
+endif()
+message(STATUS "${SAMPLE}: ${candidate}")
@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <unistd.h>
+#include "DifferentialCases.h"
+
+static int sameBits(const double a, const double b)
+{
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// Writes points to a .cpz file and checks that readPointsFromFile returns them bit for bit
+static int roundTrip(const char* path, Point points[], const size_t numPoints, const uint32_t flags, const char* label)
+{
+    Point* read = NULL;
+    size_t readPoints, i;
+    double minX, maxX, minY, maxY;
+    int dimensions, failures = 0;
+    if (writePointsCompressed(path, points, numPoints, -1.0, 1.0, -2.0, 2.0, 2, flags) ||
+        readPointsFromFile(path, &read, &readPoints, &minX, &maxX, &minY, &maxY, &dimensions)) {
+        printf("FAIL %s: write or read failed\n", label);
+        return 1;
+    }
+    if (readPoints != numPoints || dimensions != 2 || minX != -1.0 || maxY != 2.0) {
+        printf("FAIL %s: header mismatch\n", label);
+        free(read);
+        return 1;
+    }
+    if (flags & CP_CPZ_SORTED_X)
+        qsort(points, numPoints, sizeof(Point), compareX);
+    for (i = 0; i < numPoints && failures < 5; i++) {
+        if (!sameBits(read[i].x, points[i].x) || !sameBits(read[i].y, points[i].y)) {
+            printf("FAIL %s: point %zu is (%.17g, %.17g), expected (%.17g, %.17g)\n", label, i, read[i].x, read[i].y, points[i].x, points[i].y);
+            failures++;
+        }
+    }
+    free(read);
+    return failures;
+}
+
+// Overwrites size bytes at offset of the file at path
+static void patchFile(const char* path, const long offset, const void* bytes, const size_t size)
+{
+    FILE* file = fopen(path, "r+b");
+    fseek(file, offset, SEEK_SET);
+    fwrite(bytes, 1, size, file);
+    fclose(file);
+}
+
+// Bit-exact round trips of the .cpz format and the slab decomposition of sorted files
+int main(void)
+{
+    const char* path = "compressed_test.cpz";
+    uint64_t state = 88172645463325252ULL;
+    const size_t sizes[] = {1, 2, 3, 4095, 4096, 4097, 50000};
+    size_t s, i;
+    int failures = 0, r, p;
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const size_t n = sizes[s];
+        Point* points = (Point*) malloc(n * sizeof(Point));
+        char label[64];
+
+        // Arbitrary bit patterns, including NaN payloads, infinities, zeros of both signs and subnormals
+        for (i = 0; i < n; i++) {
+            uint64_t bx = nextRandom(&state), by = nextRandom(&state);
+            switch (i % 7) {
+                case 0: bx = 0x8000000000000000ULL; break;
+                case 1: by = 0x7FF0000000000000ULL; break;
+                case 2: bx = 0x0000000000000001ULL; break;
+                case 3: by = bx; break;
+                default: break;
+            }
+            memcpy(&points[i].x, &bx, sizeof(double));
+            memcpy(&points[i].y, &by, sizeof(double));
+        }
+        snprintf(label, sizeof(label), "raw n=%zu", n);
+        failures += roundTrip(path, points, n, 0, label);
+
+        // Coordinates as GeneratePoints writes them, with repeated values, sorted by X
+        for (i = 0; i < n; i++) {
+            points[i].x = (double)(nextRandom(&state) >> 11) / 9007199254740992.0;
+            points[i].y = (i % 5 == 0 && i > 0) ? points[i - 1].y : (double)(nextRandom(&state) >> 11) / 9007199254740992.0;
+        }
+        snprintf(label, sizeof(label), "sorted n=%zu", n);
+        failures += roundTrip(path, points, n, CP_CPZ_SORTED_X, label);
+
+        // Slabs cover the file in order, in balanced blocks, with monotone boundaries inside the data
+        for (p = 1; p <= 9; p += 4) {
+            double midpointsX[9];
+            size_t covered = 0;
+            for (r = 0; r < p; r++) {
+                Point* slab = NULL;
+                int slabPoints;
+                if (readCompressedSlab(path, r, p, &slab, &slabPoints, midpointsX)) {
+                    printf("FAIL slab %d of %d, n=%zu\n", r, p, n);
+                    failures++;
+                    break;
+                }
+                for (i = 0; i < (size_t)slabPoints; i++)
+                    if (!sameBits(slab[i].x, points[covered + i].x) || !sameBits(slab[i].y, points[covered + i].y))
+                        break;
+                if (i != (size_t)slabPoints) {
+                    printf("FAIL slab %d of %d, n=%zu: point %zu differs\n", r, p, n, covered + i);
+                    failures++;
+                }
+                covered += slabPoints;
+                free(slab);
+            }
+            for (r = 0; r + 1 < p; r++) {
+                if (midpointsX[r] < points[0].x || midpointsX[r] > points[n - 1].x || (r > 0 && midpointsX[r] < midpointsX[r - 1])) {
+                    printf("FAIL boundary %d of %d, n=%zu: %.17g\n", r, p, n, midpointsX[r]);
+                    failures++;
+                }
+            }
+            if (covered != n) {
+                printf("FAIL %d slabs of n=%zu cover %zu points\n", p, n, covered);
+                failures++;
+            }
+        }
+        free(points);
+    }
+
+    // Truncated and corrupted files are rejected
+    {
+        Point points[3] = {{0.0, 0.0}, {1.0, 1.0}, {2.0, 2.0}};
+        Point* read = NULL;
+        size_t readPoints;
+        double minX, maxX, minY, maxY;
+        int dimensions;
+        writePointsCompressed(path, points, 3, 0.0, 2.0, 0.0, 2.0, 2, CP_CPZ_SORTED_X);
+        if (truncate(path, 80) != 0 || readPointsFromFile(path, &read, &readPoints, &minX, &maxX, &minY, &maxY, &dimensions) != -3) {
+            printf("FAIL truncated file accepted\n");
+            failures++;
+        }
+        free(read); read = NULL;
+
+        // Blocks before the last must be full: counts {4096, 1, 4096} would decode past the array
+        const size_t n = 2 * CP_CPZ_BLOCK_POINTS + 1;
+        Point* many = (Point*) malloc(n * sizeof(Point));
+        for (i = 0; i < n; i++) {
+            many[i].x = ldexp((double)(nextRandom(&state) >> 11), -53);
+            many[i].y = ldexp((double)(nextRandom(&state) >> 11), -53);
+        }
+        const uint32_t counts[3] = {CP_CPZ_BLOCK_POINTS, 1, CP_CPZ_BLOCK_POINTS};
+        writePointsCompressed(path, many, n, 0.0, 1.0, 0.0, 1.0, 2, 0);
+        for (i = 0; i < 3; i++)
+            patchFile(path, 72 + 40 * (long)i + 16, &counts[i], 4);
+        if (readPointsFromFile(path, &read, &readPoints, &minX, &maxX, &minY, &maxY, &dimensions) != -3) {
+            printf("FAIL uneven block table accepted\n");
+            failures++;
+        }
+        free(read); read = NULL;
+
+        // Corrupt block bodies: an impossible window (leading 63, length 64) is rejected; random
+        // bits may decode to other values but must stay inside the block
+        uint64_t offset;
+        uint8_t garbage[256];
+        writePointsCompressed(path, many, n, 0.0, 1.0, 0.0, 1.0, 2, 0);
+        FILE* file = fopen(path, "rb");
+        fseek(file, 72, SEEK_SET);
+        if (fread(&offset, 8, 1, file) != 1)
+            offset = 0;
+        fclose(file);
+        memset(garbage, 0xFF, sizeof(garbage));
+        patchFile(path, (long)offset + 8, garbage, sizeof(garbage));
+        if (readPointsFromFile(path, &read, &readPoints, &minX, &maxX, &minY, &maxY, &dimensions) != -3) {
+            printf("FAIL corrupt block window accepted\n");
+            failures++;
+        }
+        free(read); read = NULL;
+        for (i = 0; i < sizeof(garbage); i++)
+            garbage[i] = (uint8_t)nextRandom(&state);
+        writePointsCompressed(path, many, n, 0.0, 1.0, 0.0, 1.0, 2, 0);
+        patchFile(path, (long)offset + 8, garbage, sizeof(garbage));
+        readPointsFromFile(path, &read, &readPoints, &minX, &maxX, &minY, &maxY, &dimensions);
+        free(read);
+        free(many);
+    }
+    remove(path);
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+#ifndef DifferentialCases_h
+
+#define DifferentialCases_h
+#include <stdint.h>
+#include "ClosestPairUtilities.h"
+
+// Inputs shared by the sequential and MPI differential tests.
+// Randomized and degenerate cases come from generatePointsByDistribution,
+// adversarial ones (ties, near-ties, cancellation) are built here.
+static const char* differentialDistributions[] = {
+    "uniform", "gaussian", "clustered", "duplicates", "collinear", "boundary", "sorted",
+    "grid", "neartie", "offset", "negative"
+};
+static const size_t differentialSizes[] = {2, 3, 4, 7, 16, 33, 100, 257, 1000, 4099};
+static const unsigned int differentialSeeds[] = {1, 7, 2024};
+
+#define DIFFERENTIAL_NUM_DISTRIBUTIONS (sizeof(differentialDistributions) / sizeof(differentialDistributions[0]))
+#define DIFFERENTIAL_NUM_SIZES (sizeof(differentialSizes) / sizeof(differentialSizes[0]))
+#define DIFFERENTIAL_NUM_SEEDS (sizeof(differentialSeeds) / sizeof(differentialSeeds[0]))
+#define DIFFERENTIAL_NUM_CASES (DIFFERENTIAL_NUM_DISTRIBUTIONS * DIFFERENTIAL_NUM_SIZES * DIFFERENTIAL_NUM_SEEDS)
+
+// xorshift64 generator for tests that need their own reproducible bit patterns
+static inline uint64_t nextRandom(uint64_t* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Distance between two doubles in units in the last place
+static inline uint64_t ulpDistance(double a, double b)
+{
+    if (a == b) return 0;
+    int64_t ia, ib;
+    memcpy(&ia, &a, sizeof(double));
+    memcpy(&ib, &b, sizeof(double));
+    if (ia < 0) ia = INT64_MIN - ia;
+    if (ib < 0) ib = INT64_MIN - ib;
+    return (ia > ib) ? (uint64_t)(ia - ib) : (uint64_t)(ib - ia);
+}
+
+static inline int buildDifferentialCase(const size_t caseIndex, Point** points, size_t* numPoints, const char** distribution, unsigned int* seed)
+{
+    *distribution = differentialDistributions[caseIndex % DIFFERENTIAL_NUM_DISTRIBUTIONS];
+    *numPoints = differentialSizes[(caseIndex / DIFFERENTIAL_NUM_DISTRIBUTIONS) % DIFFERENTIAL_NUM_SIZES];
+    *seed = differentialSeeds[caseIndex / (DIFFERENTIAL_NUM_DISTRIBUTIONS * DIFFERENTIAL_NUM_SIZES)];
+    srand(*seed);
+
+    size_t i;
+    if (strcmp(*distribution, "grid") == 0) {
+        // Lattice with spacing 1/8: every neighbour pair ties
+        *points = (Point*) malloc(*numPoints * sizeof(Point));
+        for (i = 0; i < *numPoints; i++) {
+            (*points)[i].x = (double)(i % 17) / 8.0;
+            (*points)[i].y = (double)(i / 17) / 8.0;
+        }
+        return 0;
+    }
+    if (strcmp(*distribution, "neartie") == 0 || strcmp(*distribution, "offset") == 0 || strcmp(*distribution, "negative") == 0) {
+        const double shift = (strcmp(*distribution, "offset") == 0) ? 1e8 : ((strcmp(*distribution, "negative") == 0) ? -1.0 : 0.0);
+        if (generateRandomPoints(points, *numPoints, shift, shift + 1.0, shift, shift + 1.0))
+            return -1;
+        if (strcmp(*distribution, "neartie") == 0 && *numPoints >= 4) {
+            // Two pairs whose distances differ in the last few bits
+            (*points)[1].x = (*points)[0].x + 1e-9;
+            (*points)[1].y = (*points)[0].y;
+            (*points)[3].x = (*points)[2].x + nextafter(1e-9, 1.0);
+            (*points)[3].y = (*points)[2].y;
+        }
+        return 0;
+    }
+    return generatePointsByDistribution(points, *numPoints, 0.0, 1.0, 0.0, 1.0, *distribution);
+}
+
+#endif
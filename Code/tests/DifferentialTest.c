@@ -0,0 +1,208 @@
+#include "DifferentialCases.h"
+#include "ClosestPairFloat.h"
+#include "ClosestPairBichromatic.h"
+#include "ClosestPairPruned.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Maximum disagreement with brute force, in units in the last place
+#define MAX_ULP 4
+
+int main(void)
+{
+    size_t c, numPoints;
+    int failures = 0;
+    const char* distribution;
+    unsigned int seed;
+
+    for (c = 0; c < DIFFERENTIAL_NUM_CASES; c++) {
+        Point* points = NULL;
+        if (buildDifferentialCase(c, &points, &numPoints, &distribution, &seed)) {
+            printf("FAIL %s n=%zu seed=%u: input generation failed\n", distribution, numPoints, seed);
+            failures++;
+            continue;
+        }
+
+        double reference, dac;
+        closestPairBruteForce(points, numPoints, &reference);
+
+        Point* copy = (Point*) malloc(numPoints * sizeof(Point));
+        memcpy(copy, points, numPoints * sizeof(Point));
+        closestPairDAC(copy, numPoints, &dac);
+        if (ulpDistance(reference, dac) > MAX_ULP) {
+            printf("FAIL %s n=%zu seed=%u: CP-DAC-Seq %.17g vs CP-BF-Seq %.17g\n", distribution, numPoints, seed, dac, reference);
+            failures++;
+        }
+
+        // Smallest and largest leaf of the recursion, against the default above
+        const size_t leafSizes[] = {CP_LEAF_SIZE_MIN, CP_LEAF_SIZE_MAX};
+        size_t l;
+        for (l = 0; l < sizeof(leafSizes) / sizeof(leafSizes[0]); l++) {
+            setLeafSize(leafSizes[l]);
+            memcpy(copy, points, numPoints * sizeof(Point));
+            closestPairDAC(copy, numPoints, &dac);
+            if (ulpDistance(reference, dac) > MAX_ULP) {
+                printf("FAIL %s n=%zu seed=%u: CP-DAC-Seq leaf %zu %.17g vs CP-BF-Seq %.17g\n", distribution, numPoints, seed, leafSizes[l], dac, reference);
+                failures++;
+            }
+        }
+        setLeafSize(CP_LEAF_SIZE_DEFAULT);
+
+        double single;
+        memcpy(copy, points, numPoints * sizeof(Point));
+        closestPairDACFloat(copy, numPoints, &single);
+        if (ulpDistance(reference, single) > MAX_ULP) {
+            printf("FAIL %s n=%zu seed=%u: CP-DAC-Seq --float %.17g vs CP-BF-Seq %.17g\n", distribution, numPoints, seed, single, reference);
+            failures++;
+        }
+        closestPairBruteForceFloat(points, numPoints, &single);
+        if (ulpDistance(reference, single) > MAX_ULP) {
+            printf("FAIL %s n=%zu seed=%u: CP-BF-Seq --float %.17g vs CP-BF-Seq %.17g\n", distribution, numPoints, seed, single, reference);
+            failures++;
+        }
+
+        // Pruned brute force: exact without a threshold, a witness below one that is exceeded
+        double pruned, cross, crossReference;
+        memcpy(copy, points, numPoints * sizeof(Point));
+        qsort(copy, numPoints, sizeof(Point), compareX);
+        closestPairBruteForcePruned(copy, numPoints, 0.0, &pruned);
+        if (ulpDistance(reference, pruned) > MAX_ULP) {
+            printf("FAIL %s n=%zu seed=%u: pruned brute force %.17g vs CP-BF-Seq %.17g\n", distribution, numPoints, seed, pruned, reference);
+            failures++;
+        }
+        if (numPoints > 1 && reference < DBL_MAX) {
+            closestPairBruteForcePruned(copy, numPoints, reference, &pruned);
+            if (ulpDistance(reference, pruned) > MAX_ULP) {
+                printf("FAIL %s n=%zu seed=%u: pruned brute force at threshold %.17g gave %.17g\n", distribution, numPoints, seed, reference, pruned);
+                failures++;
+            }
+            closestPairBruteForcePruned(copy, numPoints, 2.0 * reference + 1e-9, &pruned);
+            if (pruned < reference || !(pruned < 2.0 * reference + 1e-9)) {
+                printf("FAIL %s n=%zu seed=%u: pruned brute force above threshold gave %.17g, closest %.17g\n", distribution, numPoints, seed, pruned, reference);
+                failures++;
+            }
+        }
+        closestPairBichromaticBruteForce(copy, numPoints / 2, copy + numPoints / 2, numPoints - numPoints / 2, &crossReference);
+        cross = closestPairCrossPruned(copy, numPoints / 2, copy + numPoints / 2, numPoints - numPoints / 2, DBL_MAX);
+        if (ulpDistance(crossReference, cross) > MAX_ULP) {
+            printf("FAIL %s n=%zu seed=%u: pruned cross pairs %.17g vs brute force %.17g\n", distribution, numPoints, seed, cross, crossReference);
+            failures++;
+        }
+
+        int err_idx;
+        memcpy(copy, points, numPoints * sizeof(Point));
+        QuickPointSort(copy, numPoints, 1);
+        if (!IsSortingPointsCorrect(copy, numPoints, &err_idx, 1) || !IsSortingPointsXCorrect(copy, numPoints, &err_idx)) {
+            printf("FAIL %s n=%zu seed=%u: QuickPointSort out of order at %d\n", distribution, numPoints, seed, err_idx);
+            failures++;
+        }
+
+        // NaturalPointSort and MergePointSort on the raw, sorted, reversed and y orders, against qsort
+        Point* expected = (Point*) malloc(numPoints * sizeof(Point));
+        Point* scratch = (Point*) malloc((numPoints + 1) * sizeof(Point));
+        memcpy(expected, points, numPoints * sizeof(Point));
+        qsort(expected, numPoints, sizeof(Point), compareX);
+        const char* orders[4] = {"raw", "sorted", "reversed", "by y"};
+        const char* sorts[2] = {"NaturalPointSort", "MergePointSort"};
+        int order, sort;
+        size_t i;
+        for (order = 0; order < 8; order++) {
+            sort = order / 4;
+            memcpy(copy, order % 4 == 0 || order % 4 == 3 ? points : expected, numPoints * sizeof(Point));
+            if (order % 4 == 2)
+                for (i = 0; i < numPoints / 2; i++)
+                    SwapPoints(&copy[i], &copy[numPoints - 1 - i]);
+            if (sort == 0)
+                NaturalPointSort(copy, numPoints, order % 4 != 3);
+            else
+                MergePointSort(copy, numPoints, order % 4 != 3, scratch);
+            for (i = 0; i < numPoints && order % 4 != 3; i++)
+                if (copy[i].x != expected[i].x)
+                    break;
+            if ((order % 4 != 3 && i != numPoints) || !IsSortingPointsCorrect(copy, numPoints, &err_idx, order % 4 != 3)) {
+                printf("FAIL %s n=%zu seed=%u: %s (%s input) out of order\n", distribution, numPoints, seed, sorts[sort], orders[order % 4]);
+                failures++;
+            }
+        }
+        free(expected);
+        free(scratch);
+
+        // Red-blue: every third point red, the rest blue, DAC against the red x blue brute force
+        Point* blue = (Point*) malloc(numPoints * sizeof(Point));
+        size_t numRed = 0, numBlue = 0;
+        for (i = 0; i < numPoints; i++) {
+            if (i % 3 == 0)
+                copy[numRed++] = points[i];
+            else
+                blue[numBlue++] = points[i];
+        }
+        double bichromaticReference, bichromatic;
+        closestPairBichromaticBruteForce(copy, numRed, blue, numBlue, &bichromaticReference);
+        closestPairBichromatic(copy, numRed, blue, numBlue, &bichromatic);
+        if (ulpDistance(bichromaticReference, bichromatic) > MAX_ULP) {
+            printf("FAIL %s n=%zu seed=%u: red-blue DAC %.17g vs brute force %.17g\n", distribution, numPoints, seed, bichromatic, bichromaticReference);
+            failures++;
+        }
+        free(blue);
+
+        free(copy);
+        free(points);
+    }
+
+    // Red-blue with dense red and blue clusters: the same-colour pairs are far closer than any red-blue pair
+    {
+        const size_t numRed = 3000, numBlue = 2000;
+        Point* red = (Point*) malloc(numRed * sizeof(Point));
+        Point* blue = (Point*) malloc(numBlue * sizeof(Point));
+        size_t i;
+        srand(99);
+        for (i = 0; i < numRed; i++) { red[i].x = 0.5 + 1e-6 * rand() / RAND_MAX; red[i].y = (double)rand() / RAND_MAX; }
+        for (i = 0; i < numBlue; i++) { blue[i].x = 0.5 + 1e-3 + 1e-6 * rand() / RAND_MAX; blue[i].y = (double)rand() / RAND_MAX; }
+        double reference, bichromatic;
+        closestPairBichromaticBruteForce(red, numRed, blue, numBlue, &reference);
+        setLeafSize(CP_LEAF_SIZE_MIN);
+        closestPairBichromatic(red, numRed, blue, numBlue, &bichromatic);
+        setLeafSize(CP_LEAF_SIZE_DEFAULT);
+        if (ulpDistance(reference, bichromatic) > MAX_ULP) {
+            printf("FAIL red-blue clusters: DAC %.17g vs brute force %.17g\n", bichromatic, reference);
+            failures++;
+        }
+        free(red); free(blue);
+    }
+
+    // Parallel merge, split across 4 threads out of place, and in place from the top of a buffer
+#ifdef _OPENMP
+    omp_set_num_threads(4);
+#endif
+    {
+        const size_t countA = 3 * CP_PARALLEL_MERGE_MIN + 7, countB = 2 * CP_PARALLEL_MERGE_MIN + 5;
+        Point* merged = (Point*) malloc((countA + countB) * sizeof(Point));
+        Point* reference = (Point*) malloc((countA + countB) * sizeof(Point));
+        Point* b = (Point*) malloc(countB * sizeof(Point));
+        size_t i;
+        int inPlace, err_idx;
+        srand(4242);
+        for (inPlace = 0; inPlace < 2; inPlace++) {
+            // Coarse X values make ties across the two inputs, y records the source for stability
+            Point* a = inPlace ? merged + countB : reference;
+            for (i = 0; i < countA; i++) { a[i].x = (double)(rand() % 5000); a[i].y = 0.0; }
+            for (i = 0; i < countB; i++) { b[i].x = (double)(rand() % 5000); b[i].y = 1.0; }
+            NaturalPointSort(a, countA, 1);
+            NaturalPointSort(b, countB, 1);
+            Point* expected = (Point*) malloc((countA + countB) * sizeof(Point));
+            MergeTwoSortedPointArrays(a, countA, b, countB, expected, 1);
+            ParallelMergePointArrays(a, countA, b, countB, merged, 1);
+            if (memcmp(expected, merged, (countA + countB) * sizeof(Point)) != 0 ||
+                !IsSortingPointsCorrect(merged, countA + countB, &err_idx, 1)) {
+                printf("FAIL ParallelMergePointArrays (%s) differs from MergeTwoSortedPointArrays\n", inPlace ? "in place" : "out of place");
+                failures++;
+            }
+            free(expected);
+        }
+        free(b); free(reference); free(merged);
+    }
+
+    printf("%zu cases, %d failures\n", (size_t)DIFFERENTIAL_NUM_CASES, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+#include "DifferentialCases.h"
+#include "ClosestPairMPI.h"
+
+// Maximum disagreement with brute force, in units in the last place
+#define MAX_ULP 4
+
+int main(int argc, char* argv[])
+{
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    size_t c, numPoints;
+    int s, failures = 0;
+    const char* distribution = NULL;
+    unsigned int seed = 0;
+    const int solvers[] = {CP_SOLVER_BF, CP_SOLVER_DAC, CP_SOLVER_DAC | CP_SOLVER_FLOAT};
+    const char* solverNames[] = {"CP-BF-MPI", "CP-DAC-MPI", "CP-DAC-MPI --float"};
+
+    for (c = 0; c < DIFFERENTIAL_NUM_CASES; c++) {
+        Point* points = NULL;
+        double reference = DBL_MAX;
+        if (rank == 0) {
+            if (buildDifferentialCase(c, &points, &numPoints, &distribution, &seed))
+                MPI_Abort(MPI_COMM_WORLD, -1);
+            closestPairBruteForce(points, numPoints, &reference);
+        }
+        MPI_Bcast(&numPoints, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+        for (s = 0; s < (int)(sizeof(solvers) / sizeof(solvers[0])); s++) {
+            // closestPairMPI consumes the rank 0 array
+            Point* copy = NULL;
+            if (rank == 0) {
+                copy = (Point*) malloc(numPoints * sizeof(Point));
+                memcpy(copy, points, numPoints * sizeof(Point));
+            }
+            double minDistance = DBL_MAX;
+            closestPairMPI(&copy, numPoints, solvers[s], &minDistance);
+            if (rank == 0 && ulpDistance(reference, minDistance) > MAX_ULP) {
+                printf("FAIL np=%d %s n=%zu seed=%u: %s %.17g vs CP-BF-Seq %.17g\n",
+                       size, distribution, numPoints, seed, solverNames[s], minDistance, reference);
+                failures++;
+            }
+        }
+
+        // Approximate slabs: the lattice bound across the slab boundaries, or the exact strips
+        const double epsilons[] = {0.0, 0.5};
+        for (s = 0; s < (int)(sizeof(epsilons) / sizeof(epsilons[0])); s++) {
+            Point *copy = NULL, *slab = NULL;
+            int slabPoints;
+            double distance, lowerBound;
+            double* midpointsX = (double*) malloc(size * sizeof(double));
+            if (rank == 0) {
+                copy = (Point*) malloc(numPoints * sizeof(Point));
+                memcpy(copy, points, numPoints * sizeof(Point));
+            }
+            distributeSlabsMPI(&copy, numPoints, 0, &slab, &slabPoints, midpointsX);
+            closestPairMPISlabsApprox(slab, slabPoints, midpointsX, epsilons[s], &distance, &lowerBound);
+            free(slab);
+            free(midpointsX);
+            if (rank == 0 && ((lowerBound > reference && ulpDistance(lowerBound, reference) > MAX_ULP) ||
+                              (distance < reference && ulpDistance(distance, reference) > MAX_ULP) ||
+                              distance > (1.0 + epsilons[s]) * lowerBound * (1.0 + MAX_ULP * DBL_EPSILON) ||
+                              (epsilons[s] == 0.0 && ulpDistance(reference, distance) > MAX_ULP))) {
+                printf("FAIL np=%d %s n=%zu seed=%u: --approx %g [%.17g, %.17g] vs CP-BF-Seq %.17g\n",
+                       size, distribution, numPoints, seed, epsilons[s], lowerBound, distance, reference);
+                failures++;
+            }
+        }
+        if (rank == 0) free(points);
+    }
+
+    MPI_Bcast(&failures, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0)
+        printf("np=%d: %zu cases, %d failures\n", size, (size_t)DIFFERENTIAL_NUM_CASES, failures);
+
+    MPI_Finalize();
+    return failures ? 1 : 0;
+}
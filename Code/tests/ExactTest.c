@@ -0,0 +1,121 @@
+#include "ClosestPairInteger.h"
+
+// Exact solvers must agree bit for bit: DAC against brute force, I32 against I64
+int main(void)
+{
+    const size_t sizes[] = {2, 3, 5, 64, 1000, 3001};
+    const int64_t ranges[] = {4, 1000, CP_I32_COORD_LIMIT, CP_I64_COORD_LIMIT};
+    size_t s, r, i;
+    int seed, failures = 0;
+    char expected[48], actual[48];
+
+    for (seed = 1; seed <= 3; seed++) {
+        srand(seed);
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            for (r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+                const size_t n = sizes[s];
+                PointI64* points = (PointI64*) malloc(n * sizeof(PointI64));
+                PointI64* copy = (PointI64*) malloc(n * sizeof(PointI64));
+                for (i = 0; i < n; i++) {
+                    // Full 62-bit coordinates, which double cannot represent exactly
+                    int64_t hi = ((int64_t)rand() << 31) ^ rand();
+                    points[i].x = (int64_t)(((uint64_t)hi << 31 ^ (uint64_t)rand()) % (2 * (uint64_t)ranges[r] + 1)) - ranges[r];
+                    hi = ((int64_t)rand() << 31) ^ rand();
+                    points[i].y = (int64_t)(((uint64_t)hi << 31 ^ (uint64_t)rand()) % (2 * (uint64_t)ranges[r] + 1)) - ranges[r];
+                }
+
+                DistanceI64 reference, dac, exact;
+                closestPairBruteForceI64(points, n, &reference);
+                memcpy(copy, points, n * sizeof(PointI64));
+                closestPairDACI64(copy, n, &dac);
+                for (i = 1; i < n; i++) {
+                    if (copy[i - 1].y > copy[i].y) {
+                        // closestPairDAC leaves the points sorted by Y
+                        printf("FAIL seed=%d n=%zu range=%ld: DAC output not sorted by Y\n", seed, n, (long)ranges[r]);
+                        failures++;
+                        break;
+                    }
+                }
+                memcpy(copy, points, n * sizeof(PointI64));
+                closestPairExact(copy, n, 1, &exact);
+
+                formatSquaredDistance(reference, expected, sizeof(expected));
+                if (dac != reference || exact != reference) {
+                    formatSquaredDistance((dac != reference) ? dac : exact, actual, sizeof(actual));
+                    printf("FAIL seed=%d n=%zu range=%ld: %s vs brute force %s\n", seed, n, (long)ranges[r], actual, expected);
+                    failures++;
+                }
+
+                if (fitsPointsI32(points, n)) {
+                    PointI32* narrowed = (PointI32*) malloc(n * sizeof(PointI32));
+                    PointI32* scratch = (PointI32*) malloc(n * sizeof(PointI32));
+                    DistanceI32 dac32;
+                    narrowPointsToI32(points, n, narrowed);
+                    RadixSortPointsI32(narrowed, n, scratch, 1);
+                    for (i = 1; i < n; i++) {
+                        if (narrowed[i - 1].x > narrowed[i].x) {
+                            printf("FAIL seed=%d n=%zu range=%ld: radix sort out of order at %zu\n", seed, n, (long)ranges[r], i);
+                            failures++;
+                            break;
+                        }
+                    }
+                    closestPairDACI32(narrowed, n, &dac32);
+                    if ((DistanceI64)dac32 != reference) {
+                        printf("FAIL seed=%d n=%zu range=%ld: I32 %ld vs I64 %s\n", seed, n, (long)ranges[r], (long)dac32, expected);
+                        failures++;
+                    }
+                    free(narrowed);
+                    free(scratch);
+                }
+                free(points);
+                free(copy);
+            }
+        }
+    }
+
+    // Opposite corners at the coordinate limits, the largest squared distances of each width,
+    // and just past the I32 limit, where the I64 solvers take over
+    {
+        const int64_t limits[] = {CP_I32_COORD_LIMIT, CP_I32_COORD_LIMIT + 1, CP_I64_COORD_LIMIT};
+        int use_dac;
+        for (r = 0; r < sizeof(limits) / sizeof(limits[0]); r++) {
+            for (use_dac = 0; use_dac <= 1; use_dac++) {
+                PointI64 corners[2] = {{-limits[r], -limits[r]}, {limits[r], limits[r]}};
+                const DistanceI64 side = 2 * (DistanceI64)limits[r];
+                DistanceI64 exact;
+                closestPairExact(corners, 2, use_dac, &exact);
+                if (exact != 2 * side * side) {
+                    formatSquaredDistance(exact, actual, sizeof(actual));
+                    formatSquaredDistance(2 * side * side, expected, sizeof(expected));
+                    printf("FAIL corners at %ld (%s): %s, expected %s\n", (long)limits[r], use_dac ? "DAC" : "brute force", actual, expected);
+                    failures++;
+                }
+            }
+        }
+    }
+
+    // Coordinates past the I64 limit are rejected, including ones that overflow 64 bits
+    {
+        const char* path = "exact_test.dat";
+        const char* tokens[] = {"4611686018427387904", "-4611686018427387904", "40000000000000000000", "184467440737095516160"};
+        PointI64* read = NULL;
+        size_t numRead;
+        double minX, maxX, minY, maxY;
+        int dimensions;
+        for (i = 0; i < sizeof(tokens) / sizeof(tokens[0]); i++) {
+            FILE* file = fopen(path, "w");
+            fprintf(file, "1\n0 1 0 1\n2\n%s 0\n", tokens[i]);
+            fclose(file);
+            if (readPointsFromFileInteger(path, &read, &numRead, &minX, &maxX, &minY, &maxY, &dimensions) == 0) {
+                printf("FAIL coordinate %s accepted as %ld\n", tokens[i], (long)read[0].x);
+                failures++;
+            }
+            free(read);
+            read = NULL;
+        }
+        remove(path);
+    }
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+#include "DifferentialCases.h"
+#include "KDTree.h"
+
+// kd-tree queries against linear scans over the differential cases, before and after a save/load
+static int checkTree(const KDTree* tree, const Point points[], const size_t numPoints, const double reference,
+                     const char* distribution, const unsigned int seed, const char* stage)
+{
+    size_t q, i, index1, index2, count;
+    int failures = 0;
+    double distance;
+
+    kdTreeClosestPair(tree, &distance, &index1, &index2);
+    if (ulpDistance(reference, distance) > 0 ||
+        (numPoints >= 2 && calculateDistance(&points[index1], &points[index2]) != distance)) {
+        printf("FAIL %s n=%zu seed=%u %s: closest pair %.17g vs brute force %.17g\n", distribution, numPoints, seed, stage, distance, reference);
+        failures++;
+    }
+
+    for (q = 0; q < 16; q++) {
+        // Queries on, near and away from the points
+        Point query = points[(q * 7919) % numPoints];
+        query.x += (q & 1) ? 0.0 : ldexp((double)q, -6);
+        query.y -= (q & 2) ? 0.0 : ldexp((double)q, -5);
+
+        double nearest = DBL_MAX;
+        for (i = 0; i < numPoints; i++)
+            nearest = fmin(nearest, calculateDistance(&points[i], &query));
+        size_t found;
+        kdTreeNearest(tree, &query, &found, &distance);
+        if (distance != nearest || calculateDistance(&points[found], &query) != nearest) {
+            printf("FAIL %s n=%zu seed=%u %s: nearest %.17g vs scan %.17g\n", distribution, numPoints, seed, stage, distance, nearest);
+            failures++;
+        }
+
+        size_t kIndices[5];
+        double kDistances[5];
+        kdTreeKNearest(tree, &query, 5, kIndices, kDistances, &count);
+        for (i = 0; i < count; i++) {
+            if ((i == 0 && kDistances[0] != nearest) || (i > 0 && kDistances[i] < kDistances[i - 1]) ||
+                calculateDistance(&points[kIndices[i]], &query) != kDistances[i]) {
+                printf("FAIL %s n=%zu seed=%u %s: k-nearest entry %zu at %.17g\n", distribution, numPoints, seed, stage, i, kDistances[i]);
+                failures++;
+                break;
+            }
+        }
+        if (count != (numPoints < 5 ? numPoints : 5)) {
+            printf("FAIL %s n=%zu seed=%u %s: k-nearest returned %zu points\n", distribution, numPoints, seed, stage, count);
+            failures++;
+        }
+
+        const double radius = 4.0 * nearest + reference;
+        size_t expected = 0, *indices = NULL;
+        for (i = 0; i < numPoints; i++) {
+            double dx = points[i].x - query.x, dy = points[i].y - query.y;
+            expected += (dx * dx + dy * dy <= radius * radius);
+        }
+        kdTreeRadius(tree, &query, radius, &indices, &count);
+        if (count != expected) {
+            printf("FAIL %s n=%zu seed=%u %s: radius %.17g found %zu points, scan %zu\n", distribution, numPoints, seed, stage, radius, count, expected);
+            failures++;
+        }
+        free(indices);
+    }
+    return failures;
+}
+
+static void patchFile(const char* path, const long offset, const void* bytes, const size_t size)
+{
+    FILE* file = fopen(path, "r+b");
+    fseek(file, offset, SEEK_SET);
+    fwrite(bytes, 1, size, file);
+    fclose(file);
+}
+
+// Corrupt copies of a saved index must be rejected by kdTreeLoad
+static int checkCorruptIndex(const char* indexPath)
+{
+    const long header = 24;     // magic, version, index bytes, numPoints, levels
+    const size_t n = 1000;
+    const uint64_t hugePoints = (uint64_t)1 << 40;
+    const size_t outOfRange = n, duplicate = 7;
+    const double outside = 1e300;
+    Point* points = NULL;
+    KDTree tree, loaded;
+    int failures = 0, c;
+
+    srand(42);
+    generateRandomPoints(&points, n, 0.0, 1.0, 0.0, 1.0);
+    kdTreeBuild(&tree, points, n);
+    const long indexStart = header + (long)(n * sizeof(Point));
+    const long boxesStart = indexStart + (long)(n * sizeof(size_t));
+    for (c = 0; c < 6; c++) {
+        kdTreeSave(&tree, indexPath);
+        switch (c) {
+        case 0: patchFile(indexPath, 12, &hugePoints, sizeof(hugePoints)); break;             // numPoints beyond the file
+        case 1: { int32_t levels = tree.levels + 1; patchFile(indexPath, 20, &levels, 4); } break;
+        case 2: patchFile(indexPath, indexStart + 8 * 10, &outOfRange, sizeof(size_t)); break;
+        case 3: patchFile(indexPath, indexStart + 8 * 10, &duplicate, sizeof(size_t));
+                patchFile(indexPath, indexStart + 8 * 11, &duplicate, sizeof(size_t)); break;
+        case 4: patchFile(indexPath, header, &outside, sizeof(double)); break;                 // Point outside its leaf box
+        case 5: patchFile(indexPath, boxesStart, &outside, sizeof(double)); break;            // Root box narrower than its children
+        }
+        if (kdTreeLoad(&loaded, indexPath) != -3) {
+            printf("FAIL corrupt index case %d accepted\n", c);
+            failures++;
+            kdTreeFree(&loaded);
+        }
+    }
+    kdTreeFree(&tree);
+    free(points);
+    return failures;
+}
+
+int main(void)
+{
+    size_t c, numPoints;
+    int failures = 0;
+    const char* distribution;
+    unsigned int seed;
+    const char* indexPath = "KDTreeTest.idx";
+
+    for (c = 0; c < DIFFERENTIAL_NUM_CASES; c++) {
+        Point* points = NULL;
+        if (buildDifferentialCase(c, &points, &numPoints, &distribution, &seed)) {
+            printf("FAIL %s n=%zu seed=%u: input generation failed\n", distribution, numPoints, seed);
+            failures++;
+            continue;
+        }
+
+        double reference;
+        closestPairBruteForce(points, numPoints, &reference);
+
+        KDTree tree, loaded;
+        kdTreeBuild(&tree, points, numPoints);
+        failures += checkTree(&tree, points, numPoints, reference, distribution, seed, "built");
+        if (kdTreeSave(&tree, indexPath) || kdTreeLoad(&loaded, indexPath)) {
+            printf("FAIL %s n=%zu seed=%u: index round trip failed\n", distribution, numPoints, seed);
+            failures++;
+        } else {
+            failures += checkTree(&loaded, points, numPoints, reference, distribution, seed, "loaded");
+            kdTreeFree(&loaded);
+        }
+        kdTreeFree(&tree);
+        free(points);
+    }
+    failures += checkCorruptIndex(indexPath);
+    remove(indexPath);
+
+    printf("%zu cases, %d failures\n", (size_t)DIFFERENTIAL_NUM_CASES, failures);
+    return failures ? 1 : 0;
+}
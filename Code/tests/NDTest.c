@@ -0,0 +1,54 @@
+#include "ClosestPairND.h"
+
+// d-dimensional DAC against brute force, for the specialized and the generic dimensions
+int main(void)
+{
+    const size_t sizes[] = {2, 3, 7, 100, 1500};
+    size_t s, i;
+    int seed, dimension, mode, failures = 0;
+
+    for (seed = 1; seed <= 2; seed++) {
+        srand(seed);
+        for (dimension = 1; dimension <= CP_ND_MAX_SPECIALIZED + 2; dimension++) {
+            for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                for (mode = 0; mode <= 2; mode++) {
+                    const size_t n = sizes[s];
+                    double *coords = NULL;
+                    generateRandomPointsND(&coords, n, dimension, -1.0, 1.0, -1.0, 1.0);
+                    // Coarse grids force ties and duplicate points
+                    for (i = 0; mode == 1 && i < n * dimension; i++)
+                        coords[i] = floor(coords[i] * 4.0) / 4.0;
+                    // A thin band in coordinate 0 puts every point in the slab of every split
+                    for (i = 0; mode == 2 && i < n; i++)
+                        coords[i * dimension] *= 1e-9;
+
+                    double reference, dac;
+                    closestPairBruteForceND(coords, n, dimension, &reference);
+                    closestPairDACND(coords, n, dimension, &dac);
+                    if (dac != reference) {
+                        printf("FAIL seed=%d d=%d n=%zu mode=%d: %.17g vs brute force %.17g\n", seed, dimension, n, mode, dac, reference);
+                        failures++;
+                    }
+                    free(coords);
+                }
+            }
+        }
+    }
+
+    // The text format keeps every coordinate bit for bit
+    double *coords = NULL, *loaded = NULL, minX, maxX, minY, maxY;
+    size_t n;
+    generateRandomPointsND(&coords, 100, 3, -1.0, 1.0, -1.0, 1.0);
+    if (writePointsToFileND("NDTest.dat", coords, 100, -1.0, 1.0, -1.0, 1.0, 3) != 0 ||
+        readPointsFromFileND("NDTest.dat", &loaded, &n, &minX, &maxX, &minY, &maxY, &dimension) != 0 ||
+        n != 100 || dimension != 3 || memcmp(coords, loaded, 300 * sizeof(double)) != 0) {
+        printf("FAIL text round trip\n");
+        failures++;
+    }
+    remove("NDTest.dat");
+    free(coords);
+    free(loaded);
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
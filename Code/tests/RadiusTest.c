@@ -0,0 +1,93 @@
+#include "DifferentialCases.h"
+#include "ClosestPairRadius.h"
+
+// Pair counts and checksums of the grid and cross kernels against radiusPairsBruteForce, and
+// the .cpr file against the pairs it was written from
+int main(void)
+{
+    const char* path = "radius_test.cpr";
+    size_t c, numPoints, r;
+    int failures = 0;
+    const char* distribution;
+    unsigned int seed;
+
+    for (c = 0; c < DIFFERENTIAL_NUM_CASES; c++) {
+        Point* points = NULL;
+        if (buildDifferentialCase(c, &points, &numPoints, &distribution, &seed)) {
+            printf("FAIL %s n=%zu seed=%u: input generation failed\n", distribution, numPoints, seed);
+            failures++;
+            continue;
+        }
+        double closest;
+        closestPairBruteForce(points, numPoints, &closest);
+        Point* sorted = (Point*) malloc((numPoints + 1) * sizeof(Point));
+        memcpy(sorted, points, numPoints * sizeof(Point));
+        qsort(sorted, numPoints, sizeof(Point), compareX);
+
+        // The closest distance itself (no pair), just above it, and a radius with many pairs
+        const double radii[] = {closest, nextafter(closest, DBL_MAX), 2.0 * closest, 0.1};
+        for (r = 0; r < sizeof(radii) / sizeof(radii[0]); r++) {
+            if (!(radii[r] > 0.0) || radii[r] >= DBL_MAX)
+                continue;
+            PairWriter reference, grid, cross;
+            openPairWriter(&reference, NULL, radii[r]);
+            radiusPairsBruteForce(points, numPoints, radii[r], &reference);
+            openPairWriter(&grid, path, radii[r]);
+            radiusPairsSorted(sorted, numPoints, radii[r], &grid);
+            closePairWriter(&grid);
+            if (grid.numPairs != reference.numPairs || grid.checksum != reference.checksum) {
+                printf("FAIL %s n=%zu seed=%u radius=%.17g: %lu pairs, expected %lu\n", distribution, numPoints, seed, radii[r],
+                       (unsigned long)grid.numPairs, (unsigned long)reference.numPairs);
+                failures++;
+            }
+
+            // Every pair of the file closer than radius, with the checksum of the writer
+            PointPair* pairs = NULL;
+            size_t numPairs = 0, k;
+            double radius = 0.0;
+            uint64_t checksum = 0;
+            if (readPointPairs(path, &radius, &pairs, &numPairs) != 0 || numPairs != grid.numPairs || radius != radii[r]) {
+                printf("FAIL %s n=%zu seed=%u radius=%.17g: pair file does not round trip\n", distribution, numPoints, seed, radii[r]);
+                failures++;
+            }
+            for (k = 0; pairs != NULL && k < numPairs; k++) {
+                checksum += hashPointPair(&pairs[k]);
+                if (!(calculateDistance(&pairs[k].a, &pairs[k].b) < radii[r]) || pairs[k].b.x < pairs[k].a.x) {
+                    printf("FAIL %s n=%zu seed=%u radius=%.17g: pair %zu is not closer than radius or not ordered\n", distribution, numPoints, seed, radii[r], k);
+                    failures++;
+                    break;
+                }
+            }
+            if (pairs != NULL && checksum != grid.checksum) {
+                printf("FAIL %s n=%zu seed=%u radius=%.17g: pair file checksum differs\n", distribution, numPoints, seed, radii[r]);
+                failures++;
+            }
+            free(pairs);
+
+            // Pairs across a cut of the X order, against the brute force of both halves
+            const size_t half = numPoints / 2;
+            PairWriter left, right;
+            openPairWriter(&left, NULL, radii[r]);
+            openPairWriter(&right, NULL, radii[r]);
+            radiusPairsBruteForce(sorted, half, radii[r], &left);
+            radiusPairsBruteForce(sorted + half, numPoints - half, radii[r], &right);
+            Point* copy = (Point*) malloc((numPoints + 1) * sizeof(Point));
+            memcpy(copy, sorted, numPoints * sizeof(Point));
+            openPairWriter(&cross, NULL, radii[r]);
+            radiusPairsCross(copy, half, copy + half, numPoints - half, radii[r], &cross);
+            free(copy);
+            if (left.numPairs + right.numPairs + cross.numPairs != reference.numPairs ||
+                left.checksum + right.checksum + cross.checksum != reference.checksum) {
+                printf("FAIL %s n=%zu seed=%u radius=%.17g: %lu cross pairs, expected %lu\n", distribution, numPoints, seed, radii[r],
+                       (unsigned long)cross.numPairs, (unsigned long)(reference.numPairs - left.numPairs - right.numPairs));
+                failures++;
+            }
+        }
+        free(sorted);
+        free(points);
+    }
+    remove(path);
+
+    printf("%zu cases, %d failures\n", (size_t)DIFFERENTIAL_NUM_CASES, failures);
+    return failures ? 1 : 0;
+}
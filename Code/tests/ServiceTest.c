@@ -0,0 +1,154 @@
+#include "DifferentialCases.h"
+#include "ClosestPairService.h"
+
+#define SERVICE_K 25
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double d1 = *(const double *)a, d2 = *(const double *)b;
+    return (d1 > d2) - (d1 < d2);
+}
+
+// CP-Service requests against brute force, plus the cache hit, miss and eviction paths
+int main(void)
+{
+    static char response[CP_SERVICE_RESPONSE_SIZE], request[256];
+    const char* distributions[] = {"uniform", "duplicates", "clustered"};
+    ClosestPairService service;
+    size_t d, i, j, numPoints = 600;
+    int failures = 0;
+    serviceInit(&service);
+
+    for (d = 0; d < sizeof(distributions) / sizeof(distributions[0]); d++) {
+        Point* points = NULL;
+        char path[64];
+        snprintf(path, sizeof(path), "ServiceTest-%zu.dat", d);
+        srand(11 + d);
+        generatePointsByDistribution(&points, numPoints, 0.0, 1.0, 0.0, 1.0, distributions[d]);
+        writePointsToFile(path, points, numPoints, 0.0, 1.0, 0.0, 1.0, 2);
+        free(points);
+        // Compare against what the service parsed, the file rounds the coordinates
+        int dimension;
+        double minX, maxX, minY, maxY;
+        readPointsFromFile(path, &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimension);
+
+        double reference, distance;
+        closestPairBruteForce(points, numPoints, &reference);
+        snprintf(request, sizeof(request), "LOAD %s", path);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        if (strstr(response, " miss") == NULL) {
+            printf("FAIL %s: first LOAD should miss: %s\n", distributions[d], response);
+            failures++;
+        }
+        snprintf(request, sizeof(request), "LOAD %s", path);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        if (strstr(response, " hit") == NULL) {
+            printf("FAIL %s: second LOAD should hit: %s\n", distributions[d], response);
+            failures++;
+        }
+
+        snprintf(request, sizeof(request), "CLOSEST %s", path);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        if (sscanf(response, "OK %lf", &distance) != 1 || distance != reference) {
+            printf("FAIL %s: %s vs brute force %.17g\n", distributions[d], response, reference);
+            failures++;
+        }
+        snprintf(request, sizeof(request), "CLOSEST %s DAC", path);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        if (sscanf(response, "OK %lf", &distance) != 1 || ulpDistance(distance, reference) > 4) {
+            printf("FAIL %s: DAC %s vs brute force %.17g\n", distributions[d], response, reference);
+            failures++;
+        }
+
+        // k closest pairs: the distances must be the k smallest of all pairs
+        double* all = (double*) malloc(numPoints * numPoints / 2 * sizeof(double));
+        size_t numPairs = 0, count;
+        for (i = 0; i < numPoints; i++)
+            for (j = i + 1; j < numPoints; j++)
+                all[numPairs++] = calculateDistance(&points[i], &points[j]);
+        qsort(all, numPairs, sizeof(double), compareDoubles);
+        snprintf(request, sizeof(request), "KPAIRS %s %d", path, SERVICE_K);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        char* cursor = response + 3;
+        count = strtoul(cursor, &cursor, 10);
+        if (count != SERVICE_K) {
+            printf("FAIL %s: KPAIRS returned %zu pairs\n", distributions[d], count);
+            failures++;
+        }
+        for (i = 0; i < count; i++) {
+            double pairDistance = strtod(cursor, &cursor);
+            size_t a = strtoul(cursor, &cursor, 10), b = strtoul(cursor, &cursor, 10);
+            if (pairDistance != all[i] || a >= b || calculateDistance(&points[a], &points[b]) != pairDistance) {
+                printf("FAIL %s: pair %zu is %zu-%zu at %.17g, expected distance %.17g\n", distributions[d], i, a, b, pairDistance, all[i]);
+                failures++;
+                break;
+            }
+        }
+        free(all);
+        // A response buffer too small for the pairs is an error, not a cut list
+        char small[64];
+        snprintf(request, sizeof(request), "KPAIRS %s %d", path, SERVICE_K);
+        serviceHandleRequest(&service, request, small, sizeof(small));
+        if (strncmp(small, "ERR", 3) != 0) {
+            printf("FAIL %s: truncated KPAIRS answered %s\n", distributions[d], small);
+            failures++;
+        }
+
+        Point query = {0.25, 0.75};
+        double nearest = DBL_MAX;
+        size_t index;
+        for (i = 0; i < numPoints; i++)
+            nearest = fmin(nearest, calculateDistance(&points[i], &query));
+        snprintf(request, sizeof(request), "NEAREST %s 0.25 0.75", path);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        if (sscanf(response, "OK %zu %lf", &index, &distance) != 2 || distance != nearest || calculateDistance(&points[index], &query) != nearest) {
+            printf("FAIL %s: %s vs scan %.17g\n", distributions[d], response, nearest);
+            failures++;
+        }
+        free(points);
+    }
+
+    // More files than cache slots: the oldest is evicted and misses again
+    for (i = 0; i <= CP_SERVICE_CACHE_SIZE; i++) {
+        Point* points = NULL;
+        char path[64];
+        snprintf(path, sizeof(path), "ServiceTest-evict-%zu.dat", i);
+        srand(100 + i);
+        generateRandomPoints(&points, 10, 0.0, 1.0, 0.0, 1.0);
+        writePointsToFile(path, points, 10, 0.0, 1.0, 0.0, 1.0, 2);
+        free(points);
+        snprintf(request, sizeof(request), "LOAD %s", path);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+    }
+    snprintf(request, sizeof(request), "LOAD ServiceTest-0.dat");
+    serviceHandleRequest(&service, request, response, sizeof(response));
+    if (strstr(response, " miss") == NULL) {
+        printf("FAIL eviction: %s\n", response);
+        failures++;
+    }
+
+    const char* malformed[] = {"", "BOGUS", "CLOSEST", "KPAIRS ServiceTest-0.dat 0", "NEAREST ServiceTest-0.dat 1", "LOAD missing.dat"};
+    for (i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        snprintf(request, sizeof(request), "%s", malformed[i]);
+        serviceHandleRequest(&service, request, response, sizeof(response));
+        if (strncmp(response, "ERR", 3) != 0) {
+            printf("FAIL \"%s\" should be rejected: %s\n", malformed[i], response);
+            failures++;
+        }
+    }
+    snprintf(request, sizeof(request), "STATS");
+    serviceHandleRequest(&service, request, response, sizeof(response));
+    printf("%s\n", response);
+
+    serviceFree(&service);
+    for (i = 0; i <= CP_SERVICE_CACHE_SIZE; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "ServiceTest-evict-%zu.dat", i);
+        remove(path);
+        snprintf(path, sizeof(path), "ServiceTest-%zu.dat", i);
+        remove(path);
+    }
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+#include <stdint.h>
+#include <unistd.h>
+#include "DifferentialCases.h"
+
+static int expectParse(const char* text, const int expected, const size_t expectedPoints)
+{
+    Point* points = NULL;
+    size_t numPoints;
+    double minX, maxX, minY, maxY;
+    int dimensions;
+    int errcode = parsePointsText(text, strlen(text), &points, &numPoints, &minX, &maxX, &minY, &maxY, &dimensions);
+    free(points);
+    if (errcode != expected || (errcode == 0 && numPoints != expectedPoints)) {
+        printf("FAIL parsing \"%s\": error code %d, expected %d\n", text, errcode, expected);
+        return 1;
+    }
+    return 0;
+}
+
+// parseDouble against strtod, formatDouble round trips, and the .dat parser's error paths
+int main(void)
+{
+    uint64_t state = 88172645463325252ULL;
+    char buffer[64];
+    int i, failures = 0;
+
+    for (i = 0; i < 1000000; i++) {
+        double value, parsed, reference;
+        uint64_t bits = nextRandom(&state);
+        if (i % 2 == 0) {
+            // Any finite double
+            memcpy(&value, &bits, sizeof(double));
+            if (!isfinite(value))
+                continue;
+        } else {
+            // Coordinates as GeneratePoints and the samples produce them
+            value = ldexp((double)(bits >> 11), -53) * ((i % 3) ? 1.0 : 1e6) - ((i % 5) ? 0.0 : 0.5);
+        }
+        int length = formatDouble(value, buffer);
+        if (parseDouble(buffer, buffer + length, &parsed) != buffer + length || parsed != value) {
+            printf("FAIL formatDouble(%.17g) = \"%s\" does not round trip\n", value, buffer);
+            failures++;
+        }
+
+        // Decimal strings with 1 to 20 digits and assorted exponents
+        int digits = 1 + (int)(nextRandom(&state) % 20), exponent = (int)(nextRandom(&state) % 60) - 40, d;
+        length = 0;
+        if (nextRandom(&state) & 1)
+            buffer[length++] = '-';
+        for (d = 0; d < digits; d++) {
+            if (d == digits / 2)
+                buffer[length++] = '.';
+            buffer[length++] = (char)('0' + nextRandom(&state) % 10);
+        }
+        length += sprintf(buffer + length, "e%d", exponent);
+        reference = strtod(buffer, NULL);
+        if (parseDouble(buffer, buffer + length, &parsed) != buffer + length || parsed != reference) {
+            printf("FAIL parseDouble(\"%s\") = %.17g, strtod %.17g\n", buffer, parsed, reference);
+            failures++;
+        }
+        if (failures > 20)
+            break;
+    }
+
+    failures += expectParse("3\n0 1 0 1\n2\n0.5 0.25\n-1e-3 7\n1 2\n", 0, 3);
+    failures += expectParse("2\r\n0 1 0 1\r\n2\r\n  0.5\t0.25  \r\n1 2", 0, 2);
+    failures += expectParse("2\n0 1 0 1\n2\n0.5 0.25\n1 2\n\n\n", 0, 2);
+    failures += expectParse("0\n0 1 0 1\n2\n", 0, 0);
+    failures += expectParse("2\n0 1 0 1\n2 sorted-x\n0.25 1\n0.5 0\n", 0, 2);
+    failures += expectParse("2\n0 1 0 1\n2 sorted\n0.25 1\n0.5 0\n", -3, 0);  // Unknown flag
+    failures += expectParse("3\n0 1 0 1\n2\n0.5 0.25\n1 2\n", -3, 0);     // Missing point
+    failures += expectParse("1\n0 1 0 1\n2\n0.5 0.25\n1 2\n", -3, 0);     // Extra point
+    failures += expectParse("2\n0 1 0 1\n2\n0.5 0.25\n1 x\n", -3, 0);     // Garbage
+    failures += expectParse("2\n0 1 0 1\n2\n0.5 0.25\n1,2\n", -3, 0);     // Wrong separator
+    failures += expectParse("2\n0 1 0 1\n2\n0.5 0.25 3\n1 2\n", -3, 0);   // Three coordinates
+    failures += expectParse("2\n0 1 0 1\n2\n0.5\n1 2\n", -3, 0);          // One coordinate
+    failures += expectParse("2\n0 1 0\n2\n0.5 0.25\n1 2\n", -3, 0);       // Short header
+    failures += expectParse("2\n0 1 0 1\n3\n0.5 0.25 1\n1 2 3\n", -4, 0); // Not 2-D
+
+    // The pipelined loader sorts what readPointsFromFile reads, across several pieces
+    {
+        const char* path = "textio_pipeline_test.dat";
+        const size_t n = 300000;
+        Point *points = (Point*) malloc(n * sizeof(Point)), *expected = NULL, *sorted = NULL;
+        size_t numExpected, numSorted;
+        double minX, maxX, minY, maxY;
+        int dimensions;
+        for (i = 0; i < (int)n; i++) {
+            points[i].x = ldexp((double)(nextRandom(&state) >> 11), -53);
+            points[i].y = (i % 3) ? ldexp((double)(nextRandom(&state) >> 11), -53) : points[i / 2].x;
+        }
+        writePointsToFile(path, points, n, 0.0, 1.0, 0.0, 1.0, 2);
+        if (readPointsFromFile(path, &expected, &numExpected, &minX, &maxX, &minY, &maxY, &dimensions) ||
+            readPointsFromFileSortedX(path, &sorted, &numSorted, &minX, &maxX, &minY, &maxY, &dimensions) || numSorted != n) {
+            printf("FAIL pipelined read of %zu points\n", n);
+            failures++;
+        } else {
+            qsort(expected, n, sizeof(Point), compareX);
+            for (i = 0; i < (int)n; i++)
+                if (expected[i].x != sorted[i].x || (i > 0 && sorted[i].x < sorted[i - 1].x))
+                    break;
+            if (i != (int)n) {
+                printf("FAIL pipelined read differs at point %d\n", i);
+                failures++;
+            }
+        }
+        free(expected); free(sorted); sorted = NULL;
+
+        // Sorted points are written with the sorted-x flag and loaded without a sort
+        qsort(points, n, sizeof(Point), compareX);
+        writePointsToFile(path, points, n, 0.0, 1.0, 0.0, 1.0, 2);
+        if (readPointsFromFileSortedX(path, &sorted, &numSorted, &minX, &maxX, &minY, &maxY, &dimensions) || numSorted != n ||
+            memcmp(sorted, points, n * sizeof(Point)) != 0) {
+            printf("FAIL pipelined read of a sorted-x file\n");
+            failures++;
+        }
+        free(sorted); sorted = NULL;
+
+        // A truncated file is rejected, not returned short
+        if (truncate(path, 5 << 20) != 0 || readPointsFromFileSortedX(path, &sorted, &numSorted, &minX, &maxX, &minY, &maxY, &dimensions) != -3) {
+            printf("FAIL pipelined read accepted a truncated file\n");
+            failures++;
+        }
+        free(sorted); sorted = NULL;
+
+        // A line longer than a piece of the pipelined loader is rejected
+        FILE* file = fopen(path, "w");
+        fprintf(file, "3\n0 1 0 1\n2\n0.5 0.25\n0.");
+        for (i = 0; i < (20 << 20); i++)
+            fputc('1', file);
+        fprintf(file, " 0.5\n0.75 0.5\n");
+        fclose(file);
+        if (readPointsFromFileSortedX(path, &sorted, &numSorted, &minX, &maxX, &minY, &maxY, &dimensions) != -3) {
+            printf("FAIL pipelined read accepted a line longer than %d bytes\n", CP_PIPELINE_CHUNK_BYTES);
+            failures++;
+        }
+        free(sorted); sorted = NULL;
+
+        // A sorted-x flag on points out of order is not trusted: in the first piece, then in a later one
+        int wrongAt;
+        for (wrongAt = 0; wrongAt < 2; wrongAt++) {
+            const size_t swapAt = wrongAt ? n - 2 : 0;
+            Point swap = points[swapAt];
+            points[swapAt] = points[swapAt + 1];
+            points[swapAt + 1] = swap;
+            file = fopen(path, "w");
+            fprintf(file, "%zu\n0 1 0 1\n2 %s\n", n, CP_TEXT_SORTED_X_TAG);
+            for (i = 0; i < (int)n; i++)
+                fprintf(file, "%.17g %.17g\n", points[i].x, points[i].y);
+            fclose(file);
+            points[swapAt + 1] = points[swapAt];
+            points[swapAt] = swap;
+            if (readPointsFromFileSortedX(path, &sorted, &numSorted, &minX, &maxX, &minY, &maxY, &dimensions) || numSorted != n ||
+                memcmp(sorted, points, n * sizeof(Point)) != 0) {
+                printf("FAIL pipelined read trusted a wrong sorted-x flag (points %zu and %zu swapped)\n", swapAt, swapAt + 1);
+                failures++;
+            }
+            free(sorted); sorted = NULL;
+        }
+        free(points);
+        remove(path);
+    }
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}